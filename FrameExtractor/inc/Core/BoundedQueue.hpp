@@ -0,0 +1,129 @@
+/******************************************************************************
+/*!
+\file       BoundedQueue.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Bounded Queue class template, a blocking multi
+			producer, multi consumer queue that connects pipeline stages.
+
+ /******************************************************************************/
+
+#ifndef BoundedQueue_HPP
+#define BoundedQueue_HPP
+#include <deque>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+namespace FrameExtractor
+{
+	// Push blocks while the queue is full, which is what keeps a fast stage
+	// from running ahead of a slow one. Close lets consumers drain what is
+	// left, Abort drops it. A byte capacity also bounds large items such as
+	// decoded frames, an item bigger than it still goes through on its own.
+	template <typename T>
+	class BoundedQueue
+	{
+	public:
+		BoundedQueue(size_t capacity, size_t byteCapacity = 0) : mCapacity(capacity ? capacity : 1), mByteCapacity(byteCapacity) {}
+
+		// False once the queue is closed or aborted, the item is dropped
+		bool Push(T item, size_t bytes = 0)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if (IsFull(bytes) && !mClosed)
+				mFullWaits++;
+			mNotFull.wait(lock, [this, bytes] { return !IsFull(bytes) || mClosed; });
+			if (mClosed)
+				return false;
+			mItems.push_back({ std::move(item), bytes });
+			mBytes += bytes;
+			mNotEmpty.notify_one();
+			return true;
+		}
+
+		// False once the queue is closed and empty
+		bool Pop(T& item)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mNotEmpty.wait(lock, [this] { return !mItems.empty() || mClosed; });
+			if (mItems.empty())
+				return false;
+			item = std::move(mItems.front().first);
+			mBytes -= mItems.front().second;
+			mItems.pop_front();
+			// A byte sized gap may fit more than one waiting item
+			mNotFull.notify_all();
+			return true;
+		}
+
+		void Close()
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mClosed = true;
+			mNotFull.notify_all();
+			mNotEmpty.notify_all();
+		}
+
+		void Abort()
+		{
+			std::deque<std::pair<T, size_t>> dropped;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mClosed = true;
+				dropped.swap(mItems);
+				mBytes = 0;
+				mNotFull.notify_all();
+				mNotEmpty.notify_all();
+			}
+		}
+
+		// Only while nothing is pushing or popping
+		void Reopen()
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mItems.clear();
+			mBytes = 0;
+			mClosed = false;
+			mFullWaits = 0;
+		}
+
+		size_t Size() const
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			return mItems.size();
+		}
+		size_t Bytes() const
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			return mBytes;
+		}
+		inline size_t Capacity() const { return mCapacity; }
+		inline size_t ByteCapacity() const { return mByteCapacity; }
+		// Pushes that had to wait, a high count marks the stage after as the bottleneck
+		uint64_t GetFullWaits() const
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			return mFullWaits;
+		}
+	private:
+		bool IsFull(size_t bytes) const
+		{
+			if (mItems.size() >= mCapacity)
+				return true;
+			return mByteCapacity && !mItems.empty() && mBytes + bytes > mByteCapacity;
+		}
+
+		size_t mCapacity;
+		size_t mByteCapacity; // 0 leaves only the item count bounded
+		size_t mBytes = 0;
+		std::deque<std::pair<T, size_t>> mItems;
+		mutable std::mutex mMutex;
+		std::condition_variable mNotFull;
+		std::condition_variable mNotEmpty;
+		bool mClosed = false;
+		uint64_t mFullWaits = 0;
+	};
+}
+
+#endif
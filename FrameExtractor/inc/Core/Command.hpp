@@ -16,6 +16,7 @@
 #include <utility> // for std::declval
 #include <vector>
 #include <map>
+#include <optional>
 #include <Graphics/Video.hpp>
 #include <Core/Project.hpp>
 #include <Core/ExcelSerialiser.hpp>
@@ -286,6 +287,154 @@ namespace FrameExtractor
 
 	};
 
+	// Track edits keep only the keyframes and tracks they touch, undoing one
+	// edit does not copy the video's whole TrackModel
+
+	class AddTrackCommand : public ICommand
+	{
+	private:
+		TrackModel* mModel;
+		Track mTrack;
+
+	public:
+		AddTrackCommand(TrackModel* model, uint32_t classID, int32_t frame, const BoundingBox& box)
+			: mModel(model) {
+			mTrack.mClass = classID;
+			mTrack.mKeyframes.push_back({ frame, box });
+		}
+
+		void execute() override {
+			// Redo brings the track back under the ID it was first given
+			if (mTrack.mID == 0)
+				mTrack.mID = mModel->AddTrack(mTrack.mClass, mTrack.mKeyframes.front().mFrame, mTrack.mKeyframes.front().mBox);
+			else
+				mModel->PutTrack(mTrack);
+		}
+
+		void undo() override {
+			mModel->RemoveTrack(mTrack.mID);
+		}
+
+		inline uint32_t GetID() const { return mTrack.mID; }
+	};
+
+	class RemoveTrackCommand : public ICommand
+	{
+	private:
+		TrackModel* mModel;
+		Track mTrack;
+
+	public:
+		RemoveTrackCommand(TrackModel* model, uint32_t id)
+			: mModel(model) {
+			if (const Track* track = model->GetTrack(id))
+				mTrack = *track;
+		}
+
+		void execute() override {
+			mModel->RemoveTrack(mTrack.mID);
+		}
+
+		void undo() override {
+			mModel->PutTrack(mTrack);
+		}
+	};
+
+	// Adds or moves keyframes of one track, one for a drawn box or a whole
+	// tracker run at once
+	class SetTrackKeyframesCommand : public ICommand
+	{
+	private:
+		TrackModel* mModel;
+		uint32_t mID;
+		std::vector<TrackKeyframe> mKeyframes;
+		std::vector<std::optional<BoundingBox>> mOldBoxes; // Empty where there was no keyframe
+
+	public:
+		SetTrackKeyframesCommand(TrackModel* model, uint32_t id, std::vector<TrackKeyframe> keyframes)
+			: mModel(model), mID(id), mKeyframes(std::move(keyframes)) {
+			const Track* track = model->GetTrack(id);
+			for (const TrackKeyframe& keyframe : mKeyframes)
+			{
+				const TrackKeyframe* old = track ? track->FindKeyframe(keyframe.mFrame) : nullptr;
+				mOldBoxes.push_back(old ? std::optional<BoundingBox>(old->mBox) : std::nullopt);
+			}
+		}
+
+		void execute() override {
+			for (const TrackKeyframe& keyframe : mKeyframes)
+				mModel->SetKeyframe(mID, keyframe.mFrame, keyframe.mBox);
+		}
+
+		void undo() override {
+			for (size_t i = mKeyframes.size(); i-- > 0;)
+			{
+				if (mOldBoxes[i])
+					mModel->SetKeyframe(mID, mKeyframes[i].mFrame, *mOldBoxes[i]);
+				else
+					mModel->RemoveKeyframe(mID, mKeyframes[i].mFrame);
+			}
+		}
+	};
+
+	class RemoveTrackKeyframeCommand : public ICommand
+	{
+	private:
+		TrackModel* mModel;
+		Track mTrack; // The track's ID, class and the one keyframe removed
+
+	public:
+		RemoveTrackKeyframeCommand(TrackModel* model, uint32_t id, int32_t frame)
+			: mModel(model) {
+			const Track* track = model->GetTrack(id);
+			const TrackKeyframe* keyframe = track ? track->FindKeyframe(frame) : nullptr;
+			if (keyframe)
+			{
+				mTrack.mID = id;
+				mTrack.mClass = track->mClass;
+				mTrack.mKeyframes.push_back(*keyframe);
+			}
+		}
+
+		void execute() override {
+			if (!mTrack.mKeyframes.empty())
+				mModel->RemoveKeyframe(mTrack.mID, mTrack.mKeyframes.front().mFrame);
+		}
+
+		void undo() override {
+			if (mTrack.mKeyframes.empty())
+				return;
+			// Removing the last keyframe removed the track with it
+			if (mModel->GetTrack(mTrack.mID))
+				mModel->SetKeyframe(mTrack.mID, mTrack.mKeyframes.front().mFrame, mTrack.mKeyframes.front().mBox);
+			else
+				mModel->PutTrack(mTrack);
+		}
+	};
+
+	class SetTrackClassCommand : public ICommand
+	{
+	private:
+		TrackModel* mModel;
+		uint32_t mID;
+		uint32_t mOldClass = 0, mNewClass;
+
+	public:
+		SetTrackClassCommand(TrackModel* model, uint32_t id, uint32_t classID)
+			: mModel(model), mID(id), mNewClass(classID) {
+			if (const Track* track = model->GetTrack(id))
+				mOldClass = track->mClass;
+		}
+
+		void execute() override {
+			mModel->SetClass(mID, mNewClass);
+		}
+
+		void undo() override {
+			mModel->SetClass(mID, mOldClass);
+		}
+	};
+
 	class AddStoreAggregateEntry : public ICommand
 	{
 	private:
@@ -0,0 +1,41 @@
+/******************************************************************************
+/*!
+\file       MappedFile.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Mapped File class, a read only memory mapping of a
+			whole file
+
+ /******************************************************************************/
+
+#ifndef MappedFile_HPP
+#define MappedFile_HPP
+#include <filesystem>
+namespace FrameExtractor
+{
+	// Pages are read in on first touch, so opening a large file is cheap.
+	// The file can still be replaced (renamed over) while it is mapped.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		inline bool IsOpen() const { return mData != nullptr; }
+		inline const uint8_t* GetData() const { return mData; }
+		inline size_t GetSize() const { return mSize; }
+	private:
+		void* mFile = nullptr;
+		void* mMapping = nullptr;
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+	};
+}
+
+#endif
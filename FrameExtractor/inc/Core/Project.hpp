@@ -16,6 +16,8 @@
 #include <array>
 #include <vector>
 #include <unordered_set>
+#include <Graphics/AnnotationStore.hpp>
+#include <Graphics/TrackModel.hpp>
 
 //#include <rttr/variant.h>
 namespace FrameExtractor
@@ -108,6 +110,7 @@ namespace FrameExtractor
 		void SaveProject();
 		void SaveBackup();
 		inline std::filesystem::path GetAssetsDir() const { return mAssetDir; }
+		inline std::filesystem::path GetProjectDir() const { return mProjectDir; }
 
 
 		using StoreCode = std::string;
@@ -117,6 +120,8 @@ namespace FrameExtractor
 		std::map<StoreCode, std::map<Hour, CountData>> mCountingData;
 		std::map<StoreCode, std::map<Hour, AggregateData>> mAggregateStoreData;
 		std::unordered_set<std::filesystem::path> mVideosInProject;
+		AnnotationStore mAnnotations; // Bounding boxes, saved with the project into their own file
+		std::map<std::filesystem::path, TrackModel> mTracks; // Keyframed boxes per video, baked into mAnnotations for export
 
 	private:
 
@@ -14,6 +14,7 @@
 #include <string>
 #include <imgui.h>
 #include <GUI/IPanel.hpp>
+#include <Graphics/VideoBenchmark.hpp>
 #include <spdlog/spdlog.h>
 #include <chrono>
 
@@ -138,6 +139,7 @@ namespace FrameExtractor
 		ImGuiTextFilter       Filter;
 		bool                  AutoScroll;
 		bool                  ScrollToBottom;
+		VideoBenchmark        mBenchmark;
 	};
 
 }
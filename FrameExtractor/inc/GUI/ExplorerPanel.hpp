@@ -16,13 +16,14 @@
 #include <Core/Core.hpp>
 #include <Graphics/Texture.hpp>
 #include <Core/Project.hpp>
+#include <Graphics/ThumbnailService.hpp>
 namespace FrameExtractor
 {
 
 	struct Cache
 	{
-		Ref<Texture> mTexture;
-		uint32_t mMaxFrames;
+		Ref<Texture> mTexture;  // Placeholder icon until the thumbnail is ready
+		uint32_t mMaxFrames = 0; // 0 until known
 	};
 
 	class ExplorerPanel : public IPanel
@@ -32,12 +33,21 @@ namespace FrameExtractor
 		~ExplorerPanel() override;
 		virtual void OnImGuiRender(float dt) override;
 		virtual const char* GetName() const override { return "File Explorer"; }
+		// Never blocks, queues the thumbnail on first use
 		Cache GetCache(std::filesystem::path);
+		// Never blocks and queues nothing, nullptr until probed or cached
+		const VideoMetadata* GetMetadata(const std::filesystem::path& path) const { return mThumbnails.GetMetadata(path); }
+		// Opens the containers on the thumbnail workers to fill in metadata
+		void ProbeVideos(const std::vector<std::filesystem::path>& paths);
+		inline ProbeProgress GetProbeProgress() const { return mThumbnails.GetProbeProgress(); }
 		inline void SetCurrentPath(std::filesystem::path path) { mCurrentPath = path; }
 	private:
+		void UpdateCacheFile();
+
 		std::filesystem::path mCurrentPath;
 		std::filesystem::path mSelectedPath;
-		std::map<std::filesystem::path, Cache> mCache;
+		std::filesystem::path mListedPath; // Folder the pending thumbnails were requested for
+		ThumbnailService mThumbnails;
 		Project* mProject;
 	};
 
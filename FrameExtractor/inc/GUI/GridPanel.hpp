@@ -0,0 +1,47 @@
+/******************************************************************************
+/*!
+\file       GridPanel.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Grid Panel class, a viewport that plays several
+			videos side by side in step with each other.
+
+ /******************************************************************************/
+
+#ifndef GridPanel_HPP
+#define GridPanel_HPP
+#include <imgui.h>
+#include <GUI/IPanel.hpp>
+#include <Graphics/VideoGrid.hpp>
+namespace FrameExtractor
+{
+	class ViewportPanel;
+
+	// Clicking a tile opens its video in the main viewport at the tile's frame
+	class GridPanel : public IPanel
+	{
+	public:
+		GridPanel(ViewportPanel* viewport) : mViewport(viewport) {}
+		~GridPanel() override = default;
+		virtual void OnImGuiRender(float dt) override;
+		virtual const char* GetName() const override { return "Grid Viewport"; }
+	private:
+		// Returns false when the tile asked to be removed
+		bool DrawTile(size_t tile, ImVec2 size);
+		void DrawControls(float lineHeight, bool isWindowFocused);
+		// Adds the video dropped on the last item as a new tile, or as
+		// mSegmentCount segments replacing the grid
+		void AcceptVideoDrop(bool asSegments);
+		static std::string FormatClock(double seconds);
+
+		ViewportPanel* mViewport;
+		VideoGrid mGrid;
+		bool mIsPlaying = false;
+		bool mWasPlaying = false;   // Before the slider was grabbed
+		int32_t mSpeedIndex = 8;    // Into the speed table, 1x
+		int32_t mSegmentCount = 4;
+	};
+}
+
+#endif
@@ -23,6 +23,7 @@ namespace FrameExtractor
 	class ProjectPanel;
 	class ConsolePanel;
 	class ExplorerPanel;
+	class GridPanel;
 
 	struct EditorPreferences
 	{
@@ -78,6 +79,7 @@ namespace FrameExtractor
 		ConsolePanel* mConsolePanel;
 		ExplorerPanel* mExplorerPanel;
 		ToolsPanel* mToolsPanel;
+		GridPanel* mGridPanel;
 
 		Project mProject;
 		EditorPreferences mPreferences;
@@ -30,6 +30,8 @@ namespace FrameExtractor
 		virtual void OnAttach() override;
 		void OnLoad();
 	private:
+		void ProbeProjectVideos();
+
 		ExplorerPanel* ExPanel;
 		ViewportPanel* VpPanel;
 		Project* mProject;
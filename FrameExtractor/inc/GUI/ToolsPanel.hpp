@@ -11,9 +11,14 @@
 #ifndef ToolsPanel_HPP
 #define ToolsPanel_HPP
 #include <string>
+#include <thread>
+#include <atomic>
 #include <imgui.h>
 #include <GUI/IPanel.hpp>
 #include <Core/Project.hpp>
+#include <Graphics/VideoScanner.hpp>
+#include <Graphics/BatchExtractor.hpp>
+#include <Graphics/DatasetExporter.hpp>
 namespace FrameExtractor
 {
 	class ExplorerPanel;
@@ -54,6 +59,31 @@ namespace FrameExtractor
 
 		void CountingTab(float lineHeight);
 		void AggregateTab(float lineHeight);
+		void FrameExtractionTab(float lineHeight);
+		void LabellingTab(float lineHeight);
+		void DatasetExport(float lineHeight);
+		void ScanResults(float lineHeight, const ScanProgress& progress);
+		// Copy of the entrance with the report's ranges added to its notes
+		static CountingEntrance ApplyScanReport(const CountingEntrance& entrance, const ScanReport& report);
+
+		VideoScanner mScanner;
+		ScanOptions mScanOptions;
+		std::vector<ScanReport> mScanReports; // Refreshed as videos finish
+		int32_t mScanSelection = -1;
+
+		BatchExtractor mExtractor;
+		ExtractOptions mExtractOptions;
+		std::vector<std::pair<std::string, std::string>> mExtractRanges; // HH:MM:SS, edited through commands
+		char mExtractOutputBuffer[260] = {};
+		std::thread mUnpackThread;
+		std::atomic<bool> mUnpacking = false;
+		std::atomic<bool> mUnpackCancel = false;
+		std::atomic<size_t> mUnpackDone = 0;
+		std::atomic<size_t> mUnpackTotal = 0;
+
+		DatasetExporter mDatasetExporter;
+		DatasetOptions mDatasetOptions;
+		char mDatasetOutputBuffer[260] = {};
 
 	};
 
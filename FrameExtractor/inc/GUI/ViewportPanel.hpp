@@ -11,16 +11,28 @@
 #ifndef ViewportPanel_HPP
 #define ViewportPanel_HPP
 #include <string>
+#include <iterator>
+#include <functional>
 #include <imgui.h>
 #include <GUI/IPanel.hpp>
 #include <Graphics/Video.hpp>
-#include <Graphics/BoundingBox.hpp>
+#include <Core/Project.hpp>
+#include <Graphics/Filmstrip.hpp>
+#include <Graphics/ActivityIndex.hpp>
+#include <Graphics/BoxTracker.hpp>
 namespace FrameExtractor
 {
 
 	class ViewportPanel : public IPanel
 	{
 	public:
+		// Playback speeds SpeedUp and SlowDown step through, reverse plays the
+		// same steps backwards. The grid viewport offers the same ones.
+		static constexpr float SPEED_STEPS[] = { 1.f, 1.25f, 1.5f, 2.f, 5.f, 10.f, 20.f, 50.f };
+		static constexpr int8_t SPEED_STEP_COUNT = static_cast<int8_t>(std::size(SPEED_STEPS));
+		// Index 1 to SPEED_STEP_COUNT forward, -1 to -SPEED_STEP_COUNT in reverse
+		static float GetSpeedStep(int32_t index);
+
 		ViewportPanel(const std::string& name, ImVec2& size, ImVec2& pos);
 		~ViewportPanel() override;
 		virtual void OnImGuiRender(float dt) override;
@@ -33,7 +45,11 @@ namespace FrameExtractor
 		inline int32_t GetFrameNumber() const { return mFrameNumber; }
 		inline float GetSpeedMultiplier() const { return mSpeedMultiplier; }
 		void SetVideo(std::filesystem::path path);
-		void ClearVideo() { if (mVideo) delete mVideo; mVideo = nullptr; }
+		// Paused at frameNumber of path, the open video is kept when it is path
+		void OpenAt(const std::filesystem::path& path, uint32_t frameNumber);
+		// Labelled boxes and tracks of the current frame are drawn over the video
+		inline void SetProject(Project* project) { mProject = project; }
+		void ClearVideo() { mActivity.reset(); if (mVideo) delete mVideo; mVideo = nullptr; }
 		std::filesystem::path GetVideoPath() { 
 			if (mVideo) 
 				return mVideo->GetPath(); 
@@ -41,8 +57,30 @@ namespace FrameExtractor
 				return {};
 		}
 	private:
+		// Filmstrips of the last few videos are kept for switching back and forth
+		static constexpr size_t MAX_FILMSTRIPS = 4;
+		Filmstrip* GetFilmstrip();
+		void DrawFilmstrip(float width);
+		void DrawActivityHeatmap(ImVec2 sliderPos, ImVec2 sliderSize);
+		void JumpToActivity(bool forward);
+		void DrawLabels(ImVec2 imagePos, ImVec2 imageSize, bool imageHovered);
+		// Adds a finished tracker run to its track as keyframes
+		void ApplyTrackerResults();
+
 		std::string mName;
-		std::map<std::filesystem::path, std::map<int32_t, std::vector<BoundingBox>>> mBBCache;
+		std::list<Ref<Filmstrip>> mFilmstrips; // Front is the most recent
+		Ref<ActivityIndex> mActivity;
+		std::vector<uint8_t> mActivityBuckets;
+		int32_t mActivityThreshold = ActivityIndex::DEFAULT_THRESHOLD;
+		AdaptiveSpeed mAdaptiveSpeed; // Applied to every video opened
+		Project* mProject = nullptr;
+		uint32_t mSelectedTrack = 0;
+		int32_t mLabelClass = 0;
+		bool mDrawingBox = false;
+		ImVec2 mDragStart = ImVec2(0, 0);
+		BoxTracker mTracker;
+		TrackerOptions mTrackerOptions;
+		uint32_t mTrackerTrack = 0; // Track the running or unapplied run extends, 0 when none
 		Video* mVideo = nullptr;
 		ImVec2 mViewportSize = ImVec2(0, 0);
 		ImVec2 mViewportPos = ImVec2(0, 0);
@@ -51,8 +89,11 @@ namespace FrameExtractor
 		int32_t wasPlaying = false;
 		int32_t mFrameNumber = 0;
 		int8_t mSpeedMultiplierIndex = 1;
+		ColorAdjust mColorAdjust;
+		int32_t mCacheBudgetMB = static_cast<int32_t>(FrameCache::DEFAULT_BUDGET >> 20);
 		bool initialIn = false;
 		bool mIsPlaying = true;
+		bool mNativeResolution = false;
 
 
 	};
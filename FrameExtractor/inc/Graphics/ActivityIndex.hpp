@@ -0,0 +1,75 @@
+/******************************************************************************
+/*!
+\file       ActivityIndex.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Activity Index class, a per frame motion energy track
+			of a video built in the background and kept in a sidecar file.
+
+ /******************************************************************************/
+
+#ifndef ActivityIndex_HPP
+#define ActivityIndex_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <Graphics/VideoIndex.hpp>
+namespace FrameExtractor
+{
+	class Video;
+
+	// Every frame is decoded once, shrunk to a GRID_WIDTH x GRID_HEIGHT luma
+	// grid and compared with the previous one. The mean absolute difference,
+	// scaled by ENERGY_SCALE, is the frame's energy (0 to 255).
+	class ActivityIndex
+	{
+	public:
+		static constexpr uint32_t GRID_WIDTH = 64;
+		static constexpr uint32_t GRID_HEIGHT = 36;
+		static constexpr uint32_t ENERGY_SCALE = 8;
+		static constexpr uint8_t DEFAULT_THRESHOLD = 12;
+		// Shorter bursts are treated as noise, keyframe pulses are one frame long
+		static constexpr uint32_t MIN_ACTIVE_RUN = 3;
+
+		// Loads the sidecar if it matches the video, otherwise analyses it
+		ActivityIndex(const Video& video);
+		~ActivityIndex();
+		ActivityIndex(const ActivityIndex&) = delete;
+
+		static std::filesystem::path GetSidecarPath(const std::filesystem::path& videoPath);
+		static uint32_t SumAbsDiff(const uint8_t* a, const uint8_t* b, size_t size);
+
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+		inline bool IsComplete() const { return mComplete; }
+		inline uint32_t GetAnalysedFrames() const { return mAnalysed; }
+		inline uint32_t GetFrameCount() const { return mIndex.GetFrameCount(); }
+		uint8_t GetEnergy(uint32_t frameIndex) const;
+
+		// Peak energy per bucket, buckets split the video evenly
+		void Summarize(uint32_t bucketCount, std::vector<uint8_t>& buckets) const;
+		// Start of the next / previous run of active frames, not counting the
+		// run frameIndex is in. Only analysed frames are searched.
+		bool FindNext(uint32_t frameIndex, uint8_t threshold, uint32_t& found) const;
+		bool FindPrevious(uint32_t frameIndex, uint8_t threshold, uint32_t& found) const;
+	private:
+		void AnalyseLoop();
+		bool Load();
+		bool Save() const;
+		bool IsActive(uint32_t frameIndex, uint8_t threshold) const;
+
+		std::filesystem::path mPath;
+		VideoIndex mIndex;
+
+		mutable std::mutex mMutex;
+		std::vector<uint8_t> mEnergy; // One per frame, presentation order
+		std::thread mThread;
+		std::atomic<uint32_t> mAnalysed = 0;
+		std::atomic<bool> mComplete = false;
+		std::atomic<bool> mStop = false;
+	};
+}
+
+#endif
@@ -0,0 +1,123 @@
+/******************************************************************************
+/*!
+\file       AnnotationStore.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Annotation Store class, the per project bounding
+			boxes kept column by column and memory mapped on load.
+
+ /******************************************************************************/
+
+#ifndef AnnotationStore_HPP
+#define AnnotationStore_HPP
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Core/MappedFile.hpp>
+#include <Graphics/BoundingBox.hpp>
+namespace FrameExtractor
+{
+	struct Annotation
+	{
+		BoundingBox mBox;       // Pixels of the source video
+		uint32_t mClass = 0;
+		uint32_t mTrack = 0;    // 0 when the box is not part of a track
+	};
+
+	// The boxes of one frame, every column holds mCount values
+	struct AnnotationSpan
+	{
+		const float* mMinX = nullptr;
+		const float* mMinY = nullptr;
+		const float* mMaxX = nullptr;
+		const float* mMaxY = nullptr;
+		const uint32_t* mClass = nullptr;
+		const uint32_t* mTrack = nullptr;
+		size_t mCount = 0;
+
+		inline BoundingBox GetBox(size_t i) const { return { mMinX[i], mMinY[i], mMaxX[i], mMaxY[i] }; }
+		inline Annotation operator[](size_t i) const { return { GetBox(i), mClass[i], mTrack[i] }; }
+	};
+
+	// Boxes of a video are stored frame after frame in one set of columns, with
+	// an offset per frame from its first labelled frame to its last, so a
+	// frame's boxes are a single lookup and a run of frames is one contiguous
+	// slice. Edits are kept aside until Save rewrites the file. Not thread
+	// safe, spans stay valid until the next edit of that frame, Save, Open or
+	// Close.
+	class AnnotationStore
+	{
+	public:
+		struct VideoSummary
+		{
+			std::string mVideo;
+			int32_t mFirstFrame = 0;
+			int32_t mLastFrame = -1;
+			size_t mBoxes = 0;
+		};
+
+		static std::filesystem::path GetStoreFile(const std::filesystem::path& projectDir);
+
+		// A missing file opens an empty store that Save creates
+		bool Open(const std::filesystem::path& storeFile);
+		void Close();
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+
+		AnnotationSpan GetFrame(const std::filesystem::path& video, int32_t frame) const;
+		// Visits the frames from first to last inclusive that have boxes, in order
+		void Query(const std::filesystem::path& video, int32_t first, int32_t last, const std::function<void(int32_t, const AnnotationSpan&)>& visit) const;
+		// Replaces the boxes of the frame, an empty list clears it
+		void SetFrame(const std::filesystem::path& video, int32_t frame, const std::vector<Annotation>& boxes);
+
+		inline bool IsDirty() const { return !mEdited.empty(); }
+		size_t GetBoxCount() const;
+		// Bounds grow with edits but are only tightened by Save
+		std::vector<VideoSummary> GetSummaries() const;
+		// Rewrites the file with the mapped and edited frames and maps it
+		// again. On failure the old file is mapped again and the edits kept.
+		bool Save();
+	private:
+		struct VideoRecord;
+		struct MappedVideo
+		{
+			int32_t mFirstFrame = 0;
+			uint32_t mFrameCount = 0;
+			const uint32_t* mOffsets = nullptr; // mFrameCount + 1 box indices
+		};
+
+		struct Columns
+		{
+			std::vector<float> mMinX, mMinY, mMaxX, mMaxY;
+			std::vector<uint32_t> mClass, mTrack;
+
+			void Append(const AnnotationSpan& span);
+			AnnotationSpan GetSpan(size_t begin = 0, size_t end = SIZE_MAX) const;
+			inline size_t Size() const { return mClass.size(); }
+		};
+
+		static std::string MakeKey(const std::filesystem::path& video);
+		// Maps mPath, edits and summaries already held are kept
+		bool Map();
+		void Unmap();
+		AnnotationSpan GetMappedFrame(const MappedVideo& video, int32_t frame) const;
+
+		std::filesystem::path mPath;
+		MappedFile mFile;
+		const float* mMinX = nullptr;
+		const float* mMinY = nullptr;
+		const float* mMaxX = nullptr;
+		const float* mMaxY = nullptr;
+		const uint32_t* mClass = nullptr;
+		const uint32_t* mTrack = nullptr;
+		std::unordered_map<std::string_view, MappedVideo> mVideos; // Keys view into mFile
+		std::unordered_map<std::string, std::map<int32_t, Columns>> mEdited;
+		std::map<std::string, VideoSummary> mSummaries;
+	};
+}
+
+#endif
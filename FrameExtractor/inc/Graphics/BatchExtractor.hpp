@@ -0,0 +1,177 @@
+/******************************************************************************
+/*!
+\file       BatchExtractor.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Batch Extractor class, a pipeline that pulls selected
+			frames out of many videos and writes them as JPEG or PNG files, loose
+			or packed into one frame archive.
+
+ /******************************************************************************/
+
+#ifndef BatchExtractor_HPP
+#define BatchExtractor_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <Core/BoundedQueue.hpp>
+#include <Graphics/FrameArchive.hpp>
+
+struct AVFrame;
+namespace FrameExtractor
+{
+	enum class ExtractMode
+	{
+		EveryNthFrame,
+		EveryInterval,
+		Keyframes,
+		TimeRanges
+	};
+
+	enum class ExtractOutput
+	{
+		Files,   // One image file per frame
+		Archive  // Every frame of the batch appended to one FrameArchive
+	};
+
+	struct ExtractOptions
+	{
+		ExtractMode mMode = ExtractMode::EveryInterval;
+		uint32_t mFrameStep = 25;      // EveryNthFrame
+		double mInterval = 1.0;        // EveryInterval, seconds
+		std::vector<std::pair<double, double>> mRanges; // TimeRanges, seconds from the start of each video
+		ImageFormat mFormat = ImageFormat::JPEG;
+		ExtractOutput mOutput = ExtractOutput::Files;
+		int mJPEGQuality = 3;          // MJPEG quantiser, 2 (best) to 31
+		uint32_t mMaxWidth = 0;        // Frames wider than this are scaled down, 0 keeps the source size
+		std::filesystem::path mOutputDir;
+	};
+
+	struct ExtractStats
+	{
+		size_t mVideosDone = 0;
+		size_t mVideosTotal = 0;
+		uint64_t mDecoded = 0;  // Frames out of the decoders, selected or not
+		uint64_t mSelected = 0;
+		uint64_t mConverted = 0;
+		uint64_t mEncoded = 0;
+		uint64_t mWritten = 0;
+		uint64_t mBytesWritten = 0;
+		uint64_t mFailed = 0;   // Videos that failed to open and files that failed to write
+		std::filesystem::path mArchive; // Archive output only
+		double mElapsedSeconds = 0.0;
+		struct Queue
+		{
+			size_t mDepth = 0;
+			size_t mCapacity = 0;
+			uint64_t mFullWaits = 0;
+			size_t mBytes = 0;
+		};
+		Queue mDecodedQueue, mConvertedQueue, mEncodedQueue;
+		bool mRunning = false;
+	};
+
+	// Videos are handed to decode workers, one video each, which demux, decode
+	// and select frames. Selected frames flow through bounded queues to the
+	// convert and encode workers and a single writer, so every stage runs in
+	// parallel and a slow stage throttles the ones before it. Keyframe mode
+	// drops every other packet before it reaches the decoder. Frames are
+	// numbered by the packet index so the names match the dataset exporter's.
+	class BatchExtractor
+	{
+	public:
+		static constexpr size_t QUEUE_CAPACITY = 32;
+		// Per queue, 32 decoded 4K frames alone would be 400 MB
+		static constexpr size_t QUEUE_BYTES = size_t(128) << 20;
+		// Interval and range extraction seek instead of decoding through gaps
+		// at least this long
+		static constexpr double SEEK_THRESHOLD_SECONDS = 4.0;
+
+		BatchExtractor();
+		~BatchExtractor();
+		BatchExtractor(const BatchExtractor&) = delete;
+
+		// Ignored while a batch is running
+		bool Start(const std::vector<std::filesystem::path>& videos, const ExtractOptions& options);
+		void Cancel();
+		ExtractStats GetStats() const;
+		inline bool IsRunning() const { return mActiveStages > 0; }
+	private:
+		struct FrameDeleter
+		{
+			void operator()(AVFrame* frame) const;
+		};
+		using FramePtr = std::unique_ptr<AVFrame, FrameDeleter>;
+
+		struct VideoSource
+		{
+			std::filesystem::path mPath;
+			std::string mName; // Stem made unique across the batch, names the loose files
+		};
+
+		// Where a frame came from, names the loose file or the archive entry
+		struct FrameSource
+		{
+			std::shared_ptr<const VideoSource> mVideo;
+			uint64_t mNumber = 0;
+			int64_t mPTS = 0;
+			double mTime = 0.0;
+		};
+
+		struct SelectedFrame
+		{
+			FramePtr mFrame;
+			FrameSource mSource;
+		};
+
+		struct EncodedFrame
+		{
+			std::vector<uint8_t> mData;
+			FrameSource mSource;
+		};
+
+		void DecodeWorker();
+		void ExtractVideo(const VideoSource& video);
+		void ConvertWorker();
+		void EncodeWorker();
+		void WriteWorker();
+		void Join();
+
+		ExtractOptions mOptions;
+		std::vector<std::thread> mThreads;
+
+		std::mutex mVideoMutex;
+		std::deque<VideoSource> mVideos;
+
+		BoundedQueue<SelectedFrame> mDecodedQueue;
+		BoundedQueue<SelectedFrame> mConvertedQueue;
+		BoundedQueue<EncodedFrame> mEncodedQueue;
+
+		std::atomic<int> mDecodeWorkers = 0;
+		std::atomic<int> mConvertWorkers = 0;
+		std::atomic<int> mEncodeWorkers = 0;
+		std::atomic<int> mActiveStages = 0; // Threads still running
+		std::atomic<bool> mCancel = false;
+
+		std::atomic<size_t> mVideosDone = 0;
+		size_t mVideosTotal = 0;
+		std::atomic<uint64_t> mDecoded = 0;
+		std::atomic<uint64_t> mSelected = 0;
+		std::atomic<uint64_t> mConverted = 0;
+		std::atomic<uint64_t> mEncoded = 0;
+		std::atomic<uint64_t> mWritten = 0;
+		std::atomic<uint64_t> mBytesWritten = 0;
+		std::atomic<uint64_t> mFailed = 0;
+		std::chrono::steady_clock::time_point mStarted;
+		std::atomic<int64_t> mElapsedMilliseconds = 0; // Set when the writer finishes
+		std::filesystem::path mArchivePath;
+	};
+}
+
+#endif
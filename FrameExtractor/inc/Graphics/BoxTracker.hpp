@@ -0,0 +1,115 @@
+/******************************************************************************
+/*!
+\file       BoxTracker.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Box Tracker class, which follows a labelled box
+			through the frames after it by template matching.
+
+ /******************************************************************************/
+
+#ifndef BoxTracker_HPP
+#define BoxTracker_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <Graphics/BoundingBox.hpp>
+#include <Graphics/VideoIndex.hpp>
+namespace FrameExtractor
+{
+	class Video;
+
+	struct TrackerOptions
+	{
+		uint32_t mMaxFrames = 150;      // Frames after the starting one
+		float mMinConfidence = 0.6f;    // Tracking stops on the first match below this
+		float mTolerance = 1.5f;        // Pixels, see BoxTracker::Simplify
+	};
+
+	struct TrackedBox
+	{
+		int32_t mFrame = 0;
+		BoundingBox mBox;
+		float mConfidence = 0.f; // Normalised cross correlation of the match, 0 to 1
+	};
+
+	struct TrackerProgress
+	{
+		bool mRunning = false;
+		bool mLostTarget = false;  // Stopped because confidence dropped
+		uint32_t mFramesTracked = 0;
+		uint32_t mFramesTotal = 0;
+		float mConfidence = 0.f;   // Of the latest match
+		double mBoxFramesPerSecond = 0.0; // Matching rate, excluding the seek to the start
+	};
+
+	// The box's patch is shrunk until its long side is TEMPLATE_SIZE pixels and
+	// the luma of each following frame is shrunk by the same amount. The patch
+	// is searched for around its last position by normalised cross correlation
+	// and refreshed after every confident match. Boxes keep their size, only
+	// their position is tracked. One video at a time, on its own thread.
+	class BoxTracker
+	{
+	public:
+		static constexpr uint32_t TEMPLATE_SIZE = 32;
+		// The template is replaced by the matched patch at or above this
+		static constexpr float REFRESH_CONFIDENCE = 0.9f;
+
+		BoxTracker() = default;
+		~BoxTracker();
+		BoxTracker(const BoxTracker&) = delete;
+
+		// Tracks box from frame onwards, cancelling any run in progress
+		bool Start(const Video& video, int32_t frame, const BoundingBox& box, const TrackerOptions& options);
+		void Cancel();
+		TrackerProgress GetProgress() const;
+		inline bool IsRunning() const { return mRunning; }
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+		inline int32_t GetStartFrame() const { return mStartFrame; }
+		// Boxes found so far, in frame order, the starting frame excluded
+		std::vector<TrackedBox> GetResults() const;
+
+		// Drops boxes that linear interpolation between the kept ones already
+		// places within tolerance pixels, the first and last are always kept
+		static std::vector<TrackedBox> Simplify(const std::vector<TrackedBox>& boxes, float tolerance);
+		// Sum of a[i] * b[i]
+		static uint32_t DotProduct(const uint8_t* a, const uint8_t* b, size_t size);
+	private:
+		struct Patch
+		{
+			std::vector<uint8_t> mPixels;
+			uint32_t mWidth = 0;
+			uint32_t mHeight = 0;
+			uint64_t mSum = 0;
+			uint64_t mSumSquares = 0;
+		};
+
+		void TrackLoop();
+		static void CutPatch(const std::vector<uint8_t>& image, uint32_t imageWidth, int32_t x, int32_t y, Patch& patch);
+		// Best match of patch within radius of (x, y), updates x and y
+		static float Match(const std::vector<uint8_t>& image, uint32_t imageWidth, uint32_t imageHeight, const Patch& patch, int32_t& x, int32_t& y, int32_t radius);
+
+		std::filesystem::path mPath;
+		VideoIndex mIndex;
+		uint32_t mVideoWidth = 0;
+		uint32_t mVideoHeight = 0;
+		int32_t mStartFrame = 0;
+		BoundingBox mStartBox;
+		TrackerOptions mOptions;
+
+		std::thread mThread;
+		mutable std::mutex mMutex;
+		std::vector<TrackedBox> mResults;
+		std::atomic<bool> mRunning = false;
+		std::atomic<bool> mStop = false;
+		std::atomic<bool> mLostTarget = false;
+		std::atomic<uint32_t> mFramesTracked = 0;
+		std::atomic<float> mConfidence = 0.f;
+		std::atomic<int64_t> mMatchMicroseconds = 0;
+	};
+}
+
+#endif
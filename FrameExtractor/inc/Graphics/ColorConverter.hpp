@@ -0,0 +1,86 @@
+/******************************************************************************
+/*!
+\file       ColorConverter.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Color Converter class, a same size YUV to RGB
+			converter with brightness, contrast and gamma applied in the same
+			pass.
+
+ /******************************************************************************/
+
+#ifndef ColorConverter_HPP
+#define ColorConverter_HPP
+#include <array>
+#include <memory>
+#include <mutex>
+
+struct AVFrame;
+namespace FrameExtractor
+{
+	struct ColorAdjust
+	{
+		float mBrightness = 0.f; // -1 to 1, added after contrast
+		float mContrast = 1.f;   // Scales around mid grey
+		float mGamma = 1.f;      // Above 1 brightens the shadows
+
+		inline bool operator==(const ColorAdjust& other) const
+		{
+			return mBrightness == other.mBrightness && mContrast == other.mContrast && mGamma == other.mGamma;
+		}
+	};
+
+	// Handles YUV420P, YUVJ420P and NV12 at the source size. Other formats and
+	// resizes are left to swscale, Convert returns false for them.
+	class ColorConverter
+	{
+	public:
+		enum class Path
+		{
+			Scalar,
+			SSE41,
+			AVX2
+		};
+
+		ColorConverter();
+
+		static bool IsSupported(int pixelFormat);
+		static Path GetBestPath();
+		static const char* GetPathName(Path path);
+
+		// Safe to call while another thread converts, frames already being
+		// converted finish with the old settings.
+		void SetAdjust(const ColorAdjust& adjust);
+		ColorAdjust GetAdjust() const;
+		// Only lowers the path, for benchmarking
+		void SetPath(Path path);
+		inline Path GetPath() const { return mPath; }
+
+		// dst holds height rows of dstStride bytes, 3 or 4 bytes per pixel.
+		// Alpha is written as 255.
+		bool Convert(const AVFrame* src, uint8_t* dst, int dstStride, bool rgba = false) const;
+		// For RGB produced elsewhere (e.g. by swscale), applies the whole
+		// adjustment through the lookup table
+		void ApplyAdjust(uint8_t* rgb, int width, int height, int stride, bool rgba = false) const;
+
+		struct Tables
+		{
+			ColorAdjust mAdjust;
+			// Per channel gamma curve, only used when mUseLut is set
+			std::array<std::array<uint8_t, 256>, 3> mLut;
+			// Brightness, contrast and gamma in one curve for ApplyAdjust
+			std::array<std::array<uint8_t, 256>, 3> mFullLut;
+			bool mUseLut = false;
+			bool mUseFullLut = false;
+		};
+	private:
+		std::shared_ptr<const Tables> GetTables() const;
+
+		Path mPath;
+		mutable std::mutex mMutex;
+		std::shared_ptr<const Tables> mTables;
+	};
+}
+
+#endif
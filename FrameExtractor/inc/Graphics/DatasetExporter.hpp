@@ -0,0 +1,175 @@
+/******************************************************************************
+/*!
+\file       DatasetExporter.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Dataset Exporter class, a pipeline that writes the
+			labelled frames of a project as a YOLO and COCO training set.
+
+ /******************************************************************************/
+
+#ifndef DatasetExporter_HPP
+#define DatasetExporter_HPP
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Core/BoundedQueue.hpp>
+#include <Graphics/AnnotationStore.hpp>
+#include <Graphics/BatchExtractor.hpp>
+#include <Graphics/FrameArchive.hpp>
+
+struct AVFrame;
+namespace FrameExtractor
+{
+	enum class DatasetSplit : uint8_t
+	{
+		Train,
+		Val
+	};
+
+	struct DatasetOptions
+	{
+		ImageFormat mFormat = ImageFormat::JPEG;
+		int mJPEGQuality = 3;          // MJPEG quantiser, 2 (best) to 31
+		uint32_t mMaxWidth = 0;        // Frames wider than this are scaled down, 0 keeps the source size
+		float mValFraction = 0.2f;
+		uint32_t mSeed = 0;            // Same seed and labels give the same split
+		// Neighbouring frames are nearly identical, splitting by frame leaks
+		// them across train and val
+		bool mSplitByVideo = true;
+		bool mYOLO = true;             // labels/<split>/*.txt and data.yaml
+		bool mCOCO = true;             // annotations/instances_<split>.json
+		std::filesystem::path mOutputDir;
+	};
+
+	struct DatasetStats
+	{
+		struct Stage
+		{
+			uint64_t mItems = 0;
+			int mWorkers = 0;
+			double mBusySeconds = 0.0; // Summed over the workers, queue waits excluded
+		};
+
+		size_t mVideosDone = 0;
+		size_t mVideosTotal = 0;
+		uint64_t mFramesTotal = 0;  // Labelled frames to export
+		uint64_t mBoxesTotal = 0;
+		uint64_t mDecodedFrames = 0; // Every frame out of the decoders, labelled or not
+		uint64_t mTrain = 0;        // Frames written to each split
+		uint64_t mVal = 0;
+		uint64_t mBytesWritten = 0;
+		uint64_t mFailed = 0;       // Videos that failed to open, frames that were not found or failed to write
+		double mElapsedSeconds = 0.0;
+		Stage mDecode, mEncode, mWrite;
+		ExtractStats::Queue mDecodedQueue, mEncodedQueue;
+		bool mRunning = false;
+	};
+
+	// The boxes are copied out of the store when the export starts, the store
+	// is left free for editing. Decode workers take a video each and visit its
+	// labelled frames in index order, seeking only when the next one lies past
+	// the GOP being decoded, so every needed frame is decoded once. Encode
+	// workers scale, compress and write the YOLO lines in parallel, a single
+	// writer puts the files down and streams the COCO JSON without holding it
+	// in memory.
+	class DatasetExporter
+	{
+	public:
+		static constexpr size_t QUEUE_CAPACITY = 32;
+
+		DatasetExporter();
+		~DatasetExporter();
+		DatasetExporter(const DatasetExporter&) = delete;
+
+		// Ignored while an export is running or when the store has no boxes
+		bool Start(const AnnotationStore& store, const DatasetOptions& options);
+		void Cancel();
+		DatasetStats GetStats() const;
+		inline bool IsRunning() const { return mActiveStages > 0; }
+
+		// Hash of the key and seed, deterministic across runs and machines
+		static DatasetSplit GetSplit(const std::string& key, uint32_t seed, float valFraction);
+	private:
+		struct FrameDeleter
+		{
+			void operator()(AVFrame* frame) const;
+		};
+		using FramePtr = std::unique_ptr<AVFrame, FrameDeleter>;
+
+		// Labelled frames of one video, boxes of frame i are mBoxes[mOffsets[i], mOffsets[i + 1])
+		struct VideoJob
+		{
+			std::filesystem::path mVideo;
+			std::string mName;          // Unique stem the images are named after
+			std::vector<int32_t> mFrames;
+			std::vector<uint32_t> mOffsets;
+			std::vector<Annotation> mBoxes;
+		};
+
+		struct LabelledFrame
+		{
+			FramePtr mFrame;
+			const VideoJob* mJob = nullptr;
+			uint32_t mItem = 0;         // Into mJob->mFrames
+		};
+
+		struct EncodedFrame
+		{
+			std::vector<uint8_t> mData;
+			std::string mLabels;        // YOLO lines
+			const VideoJob* mJob = nullptr;
+			uint32_t mItem = 0;
+			int mSourceWidth = 0;
+			int mSourceHeight = 0;
+			int mWidth = 0;
+			int mHeight = 0;
+		};
+
+		void DecodeWorker();
+		void ExportVideo(const VideoJob& job);
+		void EncodeWorker();
+		void WriteWorker();
+		bool WriteDataYAML() const;
+		void Join();
+
+		DatasetOptions mOptions;
+		std::vector<VideoJob> mJobs;
+		std::vector<uint32_t> mClasses;  // Sorted class IDs found in the boxes
+		std::vector<std::thread> mThreads;
+
+		BoundedQueue<LabelledFrame> mDecodedQueue;
+		BoundedQueue<EncodedFrame> mEncodedQueue;
+
+		std::atomic<size_t> mNextJob = 0;
+		std::atomic<int> mDecodeWorkers = 0;
+		std::atomic<int> mEncodeWorkers = 0;
+		std::atomic<int> mActiveStages = 0; // Threads still running
+		std::atomic<bool> mCancel = false;
+
+		std::atomic<size_t> mVideosDone = 0;
+		uint64_t mFramesTotal = 0;
+		uint64_t mBoxesTotal = 0;
+		int mDecodeWorkerCount = 0;
+		int mEncodeWorkerCount = 0;
+		std::atomic<uint64_t> mDecodedFrames = 0;
+		std::atomic<uint64_t> mDecoded = 0;
+		std::atomic<uint64_t> mEncoded = 0;
+		std::atomic<uint64_t> mTrain = 0;
+		std::atomic<uint64_t> mVal = 0;
+		std::atomic<uint64_t> mBytesWritten = 0;
+		std::atomic<uint64_t> mFailed = 0;
+		std::atomic<int64_t> mDecodeMicroseconds = 0;
+		std::atomic<int64_t> mEncodeMicroseconds = 0;
+		std::atomic<int64_t> mWriteMicroseconds = 0;
+		std::chrono::steady_clock::time_point mStarted;
+		std::atomic<int64_t> mElapsedMilliseconds = 0; // Set when the writer finishes
+	};
+}
+
+#endif
@@ -0,0 +1,48 @@
+/******************************************************************************
+/*!
+\file       DecodePolicy.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the decoder threading policies used for each kind of
+			decoding the application does.
+
+ /******************************************************************************/
+
+#ifndef DecodePolicy_HPP
+#define DecodePolicy_HPP
+
+struct AVCodecContext;
+namespace FrameExtractor
+{
+	enum class DecodeUseCase
+	{
+		Playback,  // Continuous playback on the decode thread, throughput first
+		Scrubbing, // Single frame seeks from the UI, every frame of delay is visible
+		Analysis,  // Background passes over whole files, leaves a core for the UI
+		Thumbnail, // Many small decodes in parallel, one thread each
+		Grid,      // Several videos playing side by side, each shown small
+		Background // Long passes that run while the user works, as light as possible
+	};
+
+	struct DecodePolicy
+	{
+		DecodeUseCase mUseCase = DecodeUseCase::Playback;
+		int mThreadCount = 0;    // 0 lets FFmpeg pick
+		int mThreadType = 0;     // FF_THREAD_FRAME and/or FF_THREAD_SLICE
+		bool mSkipLoopFilter = false;
+		int mLowres = 0;         // Decodes at 1 / 2^mLowres of the size, where the codec supports it
+
+		static DecodePolicy For(DecodeUseCase useCase);
+		static const char* GetName(DecodeUseCase useCase);
+		// Has to be called before avcodec_open2
+		void Apply(AVCodecContext* codecContext) const;
+
+		inline bool operator==(const DecodePolicy& other) const
+		{
+			return mThreadCount == other.mThreadCount && mThreadType == other.mThreadType && mSkipLoopFilter == other.mSkipLoopFilter && mLowres == other.mLowres;
+		}
+	};
+}
+
+#endif
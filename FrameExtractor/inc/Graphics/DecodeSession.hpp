@@ -0,0 +1,92 @@
+/******************************************************************************
+/*!
+\file       DecodeSession.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Decode Session class, a demuxer and decoder over the
+			video stream of one file for the background decoding passes.
+
+ /******************************************************************************/
+
+#ifndef DecodeSession_HPP
+#define DecodeSession_HPP
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <Graphics/DecodePolicy.hpp>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVStream;
+struct AVPacket;
+struct AVFrame;
+namespace FrameExtractor
+{
+	// Opens the best video stream of a file, discards every other stream and
+	// runs the read, send, receive and drain loop, so each background pass
+	// only deals with the frames it gets back. One per thread.
+	class DecodeSession
+	{
+	public:
+		DecodeSession() = default;
+		~DecodeSession();
+		DecodeSession(const DecodeSession&) = delete;
+		DecodeSession& operator=(const DecodeSession&) = delete;
+
+		// Container and stream only, for passes that read packets. probe reads
+		// ahead for stream information the container header may not carry.
+		// On failure GetError says why and the session is closed.
+		bool OpenInput(const std::filesystem::path& path, bool probe = true);
+		// Decoder with the policy applied and its frames drawn from the
+		// FramePool. configure runs just before avcodec_open2, for settings
+		// the policy does not cover.
+		bool OpenDecoder(const DecodePolicy& policy, const std::function<void(AVCodecContext*)>& configure = {});
+		bool Open(const std::filesystem::path& path, const DecodePolicy& policy, bool probe = true, const std::function<void(AVCodecContext*)>& configure = {});
+		void Close();
+
+		// Called with every packet of the stream, packets it returns false for
+		// are not decoded
+		inline void SetPacketFilter(std::function<bool(const AVPacket&)> filter) { mPacketFilter = std::move(filter); }
+		// Decodes the next frame, reading packets and draining the decoder at
+		// the end as needed. 0 with the frame filled, AVERROR_EOF once
+		// drained or AVERROR(EAGAIN) after maxPackets reads without a frame.
+		// Damaged packets and frames are counted and skipped. Unref the frame
+		// before the next call.
+		int ReceiveFrame(AVFrame* frame, int maxPackets = INT_MAX);
+		// Next packet of the stream into GetPacket, or av_read_frame's error
+		int ReadPacket();
+		// To the keyframe at or before pts, in stream time base, and flushes the decoder
+		void Seek(int64_t pts);
+		inline bool IsDraining() const { return mDraining; }
+		inline uint64_t GetDecodeErrors() const { return mDecodeErrors; }
+
+		inline AVFormatContext* GetFormatContext() const { return mFormatContext; }
+		inline AVCodecContext* GetCodecContext() const { return mCodecContext; }
+		inline AVStream* GetStream() const { return mStream; }
+		inline int GetStreamIndex() const { return mStreamIndex; }
+		inline AVPacket* GetPacket() const { return mPacket; }
+		inline const std::string& GetError() const { return mError; }
+
+		// best_effort_timestamp, or pts when there is none
+		static int64_t GetPTS(const AVFrame* frame);
+		// Seconds from the start of the stream, never negative
+		double GetTime(int64_t pts) const;
+		// Guessed from the container, 0 when unknown
+		double GetFrameRate() const;
+	private:
+		AVFormatContext* mFormatContext = nullptr;
+		AVCodecContext* mCodecContext = nullptr;
+		AVStream* mStream = nullptr;
+		AVPacket* mPacket = nullptr;
+		int mStreamIndex = -1;
+		bool mDraining = false;
+		uint64_t mDecodeErrors = 0;
+		std::function<bool(const AVPacket&)> mPacketFilter;
+		std::string mError;
+	};
+}
+
+#endif
@@ -0,0 +1,85 @@
+/******************************************************************************
+/*!
+\file       Filmstrip.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Filmstrip class, evenly spaced keyframe samples of a
+			video decoded in the background into one texture atlas.
+
+ /******************************************************************************/
+
+#ifndef Filmstrip_HPP
+#define Filmstrip_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <Core/Core.hpp>
+#include <Graphics/Texture.hpp>
+#include <Graphics/VideoIndex.hpp>
+namespace FrameExtractor
+{
+	class Video;
+
+	// Samples are decoded coarse to fine (the middle first, then the quarters
+	// and so on), so the whole strip is usable almost at once and sharpens as
+	// more samples arrive. Only keyframes are decoded, on a decoder of its own.
+	class Filmstrip
+	{
+	public:
+		static constexpr uint32_t DEFAULT_SAMPLES = 64;
+		static constexpr uint32_t SAMPLE_WIDTH = 256;
+
+		struct Sample
+		{
+			uint32_t mFrame = 0; // Keyframe the sample shows
+			float mU0 = 0.f, mV0 = 0.f; // Region of the atlas
+			float mU1 = 0.f, mV1 = 0.f;
+		};
+
+		Filmstrip(const Video& video, uint32_t sampleCount = DEFAULT_SAMPLES);
+		~Filmstrip();
+		Filmstrip(const Filmstrip&) = delete;
+
+		// Call once per UI frame, uploads the samples decoded since the last call
+		void Update();
+		// The closest decoded sample to the given slot, nullptr if none yet
+		const Sample* GetSample(uint32_t slot) const;
+		inline uint32_t GetSampleCount() const { return mSampleCount; }
+		inline uint32_t GetReadyCount() const { return mReadyCount; }
+		inline const Ref<Texture>& GetTexture() const { return mAtlas; }
+		inline float GetAspectRatio() const { return static_cast<float>(mSampleWidth) / mSampleHeight; }
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+	private:
+		struct Decoded
+		{
+			uint32_t mSlot;
+			uint32_t mFrame;
+			std::vector<uint8_t> mPixels;
+		};
+
+		void DecodeLoop();
+		std::vector<uint32_t> GetRefinementOrder() const;
+
+		std::filesystem::path mPath;
+		VideoIndex mIndex;
+		uint32_t mSampleCount;
+		uint32_t mSampleWidth;
+		uint32_t mSampleHeight;
+		uint32_t mColumns;
+
+		Ref<Texture> mAtlas;
+		std::vector<Sample> mSamples;
+		std::vector<bool> mReady;
+		uint32_t mReadyCount = 0;
+
+		std::thread mThread;
+		std::atomic<bool> mStop = false;
+		std::mutex mMutex;
+		std::vector<Decoded> mDecoded; // Waiting for upload
+	};
+}
+
+#endif
@@ -0,0 +1,127 @@
+/******************************************************************************
+/*!
+\file       FrameArchive.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Frame Archive classes, a single file of encoded frames
+			written in one sequential pass and read back memory mapped.
+
+ /******************************************************************************/
+
+#ifndef FrameArchive_HPP
+#define FrameArchive_HPP
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <vector>
+#include <Core/MappedFile.hpp>
+namespace FrameExtractor
+{
+	enum class ImageFormat : uint32_t
+	{
+		JPEG,
+		PNG
+	};
+
+	// A header, the encoded images back to back, then the index: one record per
+	// image, the source video paths and names, and a footer. The footer is the last bytes
+	// of the file and points at the index, so images are only ever appended
+	// and the index is written once at the end.
+	class FrameArchive
+	{
+	public:
+		static constexpr const char* EXTENSION = ".frexarc";
+
+		struct Entry
+		{
+			std::string_view mVideo; // Path of the source video
+			std::string_view mName;  // The video's name unique across the batch, names the unpacked files
+			uint32_t mFrameIndex = 0;
+			int64_t mPTS = 0;        // In the source stream's time base
+			double mTime = 0.0;      // Seconds from the start of the video
+			ImageFormat mFormat = ImageFormat::JPEG;
+			const uint8_t* mData = nullptr; // Into the mapping, valid until Close
+			size_t mSize = 0;
+		};
+
+		static const char* GetExtension(ImageFormat format);
+		// The video's stem, with _2, _3 and so on until it is not in taken, and
+		// adds it to taken. Videos in different folders can share a stem.
+		static std::string MakeUniqueName(const std::filesystem::path& video, std::set<std::string>& taken);
+		// <name>_<frame index>.<ext>, used for loose files too
+		static std::string GetFileName(const std::string& name, uint64_t frameIndex, ImageFormat format);
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+		inline bool IsOpen() const { return mFile.IsOpen(); }
+		inline size_t GetEntryCount() const { return mRecordCount; }
+		Entry GetEntry(size_t index) const;
+
+		// Writes every entry as a loose file into directory, returns how many
+		// were written. progress counts up as it goes and may be null, setting
+		// cancel stops after the file being written.
+		size_t Unpack(const std::filesystem::path& directory, std::atomic<size_t>* progress = nullptr, const std::atomic<bool>* cancel = nullptr) const;
+	private:
+		friend class FrameArchiveWriter;
+		// On disk layout, the index is 8 byte aligned and read in place
+		struct Record
+		{
+			uint64_t mOffset;
+			uint64_t mSize;
+			int64_t mPTS;
+			double mTime;
+			uint32_t mFrameIndex;
+			uint32_t mVideo;
+			uint32_t mFormat;
+			uint32_t mPadding;
+		};
+
+		struct VideoRecord
+		{
+			uint64_t mPathOffset;
+			uint64_t mPathLength;
+			uint64_t mNameOffset;
+			uint64_t mNameLength;
+		};
+
+		MappedFile mFile;
+		size_t mRecordCount = 0;
+		size_t mVideoCount = 0;
+		uint64_t mIndexOffset = 0;
+	};
+
+	// Appends go straight to disk, only the index is kept in memory
+	class FrameArchiveWriter
+	{
+	public:
+		FrameArchiveWriter() = default;
+		~FrameArchiveWriter();
+		FrameArchiveWriter(const FrameArchiveWriter&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+		// name is the video's unique name, kept so Unpack names files as the loose output would
+		bool Append(const std::filesystem::path& video, const std::string& name, uint32_t frameIndex, int64_t pts, double time, ImageFormat format, const uint8_t* data, size_t size);
+		// Writes the index, an archive that is never closed cannot be read
+		bool Close();
+
+		inline bool IsOpen() const { return mFile.is_open(); }
+		inline size_t GetEntryCount() const { return mRecords.size(); }
+		inline uint64_t GetSize() const { return mOffset; }
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+	private:
+		std::filesystem::path mPath;
+		std::ofstream mFile;
+		uint64_t mOffset = 0;
+		std::vector<FrameArchive::Record> mRecords;
+		std::vector<std::string> mVideos;
+		std::vector<std::string> mNames;
+		std::unordered_map<std::string, uint32_t> mVideoLookup;
+	};
+}
+
+#endif
@@ -0,0 +1,70 @@
+/******************************************************************************
+/*!
+\file       FrameCache.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Frame Cache class, a memory bounded LRU cache of
+			converted frames keyed by frame index.
+
+ /******************************************************************************/
+
+#ifndef FrameCache_HPP
+#define FrameCache_HPP
+#include <list>
+#include <vector>
+#include <unordered_map>
+namespace FrameExtractor
+{
+	struct CachedFrame
+	{
+		std::vector<uint8_t> mData;
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+	};
+
+	struct FrameCacheStats
+	{
+		uint64_t mHits = 0;
+		uint64_t mMisses = 0;
+		uint64_t mEvictions = 0;
+		size_t mBytesUsed = 0;
+		size_t mBudget = 0;
+		size_t mFrames = 0;
+	};
+
+	// Not thread safe, it belongs to whichever thread calls Video::Decode.
+	class FrameCache
+	{
+	public:
+		static constexpr size_t DEFAULT_BUDGET = 512ull * 1024 * 1024;
+
+		FrameCache(size_t budget = DEFAULT_BUDGET);
+
+		// Looks up a frame and marks it most recently used. Counts a hit or miss.
+		const CachedFrame* Get(uint32_t frameIndex);
+		bool Contains(uint32_t frameIndex) const;
+		// Returns storage of the given size for the caller to fill, evicting the
+		// least recently used frames to stay in budget. nullptr if it can never fit.
+		CachedFrame* Insert(uint32_t frameIndex, size_t bytes);
+
+		void SetBudget(size_t budget);
+		inline size_t GetBudget() const { return mBudget; }
+		void Clear();
+		FrameCacheStats GetStats() const;
+	private:
+		using Entry = std::pair<uint32_t, CachedFrame>;
+		void EvictUntil(size_t budget);
+
+		std::list<Entry> mEntries; // Front is most recently used
+		std::unordered_map<uint32_t, std::list<Entry>::iterator> mLookup;
+		std::vector<std::vector<uint8_t>> mSpareBuffers;
+		size_t mBudget;
+		size_t mBytesUsed = 0;
+		uint64_t mHits = 0;
+		uint64_t mMisses = 0;
+		uint64_t mEvictions = 0;
+	};
+}
+
+#endif
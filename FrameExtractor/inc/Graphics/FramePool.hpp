@@ -0,0 +1,90 @@
+/******************************************************************************
+/*!
+\file       FramePool.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Frame Pool, a process wide pool of frame buffers and
+			scaler contexts shared by every Video.
+
+ /******************************************************************************/
+
+#ifndef FramePool_HPP
+#define FramePool_HPP
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <vector>
+#include <atomic>
+
+struct AVBufferRef;
+struct AVBufferPool;
+struct AVCodecContext;
+struct AVFrame;
+struct SwsContext;
+namespace FrameExtractor
+{
+	struct FramePoolStats
+	{
+		uint64_t mBufferRequests = 0;
+		uint64_t mBufferAllocations = 0; // Requests the pools could not serve
+		size_t mBytesHeld = 0;           // Pooled buffers alive, in use or idle
+		size_t mPools = 0;
+		uint64_t mScalerRequests = 0;
+		uint64_t mScalerCreations = 0;
+		size_t mIdleScalers = 0;
+	};
+
+	class FramePool
+	{
+	public:
+		FramePool(const FramePool&) = delete;
+		~FramePool();
+
+		static FramePool& GetInstance() {
+			static FramePool instance;
+			return instance;
+		}
+
+		// Buffers of one format, size and plane share a pool. Release with
+		// av_buffer_unref, the memory goes back to the pool.
+		AVBufferRef* AcquireBuffer(int format, int width, int height, int plane, size_t size);
+		// Decoders opened with this as get_buffer2 draw their output frames
+		// from the pool
+		static void Install(AVCodecContext* codecContext);
+
+		// Scaler contexts are created once per geometry and handed out again
+		// once released
+		SwsContext* AcquireScaler(int srcWidth, int srcHeight, int srcFormat, int dstWidth, int dstHeight, int dstFormat, int flags);
+		void ReleaseScaler(SwsContext* scaler);
+
+		FramePoolStats GetStats() const;
+	private:
+		FramePool() = default;
+		static int GetBuffer2(AVCodecContext* codecContext, AVFrame* frame, int flags);
+		static AVBufferRef* Allocate(void* opaque, size_t size);
+		static void Free(void* opaque, uint8_t* data);
+
+		using BufferKey = std::tuple<int, int, int, int, size_t>;
+		using ScalerKey = std::tuple<int, int, int, int, int, int, int>;
+		struct BufferPoolEntry
+		{
+			AVBufferPool* mPool = nullptr;
+			uint64_t mLastUse = 0;
+		};
+
+		mutable std::mutex mMutex;
+		std::map<BufferKey, BufferPoolEntry> mBufferPools;
+		uint64_t mUseCounter = 0;
+		std::multimap<ScalerKey, SwsContext*> mIdleScalers;
+		std::map<SwsContext*, ScalerKey> mScalerKeys;
+
+		std::atomic<uint64_t> mBufferRequests = 0;
+		std::atomic<uint64_t> mBufferAllocations = 0;
+		std::atomic<size_t> mBytesHeld = 0;
+		uint64_t mScalerRequests = 0;
+		uint64_t mScalerCreations = 0;
+	};
+}
+
+#endif
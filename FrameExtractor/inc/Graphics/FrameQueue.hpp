@@ -0,0 +1,64 @@
+/******************************************************************************
+/*!
+\file       FrameQueue.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Frame Queue class, a fixed capacity ring of converted
+			frames shared between a decode thread and the UI thread.
+
+ /******************************************************************************/
+
+#ifndef FrameQueue_HPP
+#define FrameQueue_HPP
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+namespace FrameExtractor
+{
+	struct DecodedFrame
+	{
+		std::vector<uint8_t> mData; // Converted pixels, tightly packed
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+		uint32_t mFrameIndex = 0;
+		double mTime = 0.0;         // Presentation time in seconds from stream start
+		uint8_t mEnergy = 0;        // Scene change from the previous frame, adaptive speed only
+	};
+
+	// Single producer, single consumer ring. Slots are allocated once and
+	// reused, the producer converts directly into the slot it is handed.
+	class FrameQueue
+	{
+	public:
+		FrameQueue(size_t capacity);
+
+		// Producer side. BeginWrite blocks while the ring is full and returns
+		// nullptr once the queue is aborted.
+		DecodedFrame* BeginWrite();
+		void EndWrite();
+
+		// Consumer side. Never blocks, returns nullptr when fewer than
+		// offset + 1 frames are queued.
+		DecodedFrame* Peek(size_t offset = 0);
+		void Pop();
+
+		void Clear();
+		void Abort();
+		void Reset();
+		// Only while no producer is running. Drops queued frames.
+		void Resize(size_t capacity);
+
+		size_t Size() const;
+		inline size_t Capacity() const { return mSlots.size(); }
+	private:
+		std::vector<DecodedFrame> mSlots;
+		mutable std::mutex mMutex;
+		std::condition_variable mNotFull;
+		size_t mHead = 0;
+		size_t mCount = 0;
+		bool mAborted = false;
+	};
+}
+
+#endif
@@ -0,0 +1,49 @@
+/******************************************************************************
+/*!
+\file       ImageEncoder.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Image Encoder class, which turns decoded frames into
+			JPEG or PNG images.
+
+ /******************************************************************************/
+
+#ifndef ImageEncoder_HPP
+#define ImageEncoder_HPP
+#include <vector>
+#include <Graphics/FrameArchive.hpp>
+
+struct AVFrame;
+struct AVCodec;
+struct AVCodecContext;
+struct AVPacket;
+namespace FrameExtractor
+{
+	// Convert can run on any thread. Encode keeps its encoder open while the
+	// frame size stays the same, so each thread needs its own ImageEncoder.
+	class ImageEncoder
+	{
+	public:
+		ImageEncoder(ImageFormat format, int jpegQuality);
+		~ImageEncoder();
+		ImageEncoder(const ImageEncoder&) = delete;
+
+		// Size Convert produces for a source frame, maxWidth 0 keeps the source size
+		static void GetOutputSize(int width, int height, ImageFormat format, uint32_t maxWidth, int& outWidth, int& outHeight);
+		// Scaled to the output size in the pixel format the encoder takes, null on failure
+		static AVFrame* Convert(const AVFrame* source, ImageFormat format, uint32_t maxWidth);
+
+		inline bool IsAvailable() const { return mEncoder != nullptr; }
+		// frame comes from Convert
+		bool Encode(AVFrame* frame, std::vector<uint8_t>& data);
+	private:
+		ImageFormat mFormat;
+		int mJPEGQuality;
+		const AVCodec* mEncoder = nullptr;
+		AVCodecContext* mContext = nullptr;
+		AVPacket* mPacket = nullptr;
+	};
+}
+
+#endif
@@ -22,7 +22,11 @@ namespace FrameExtractor
 		Texture(uint32_t width, uint32_t height);
 		~Texture();
 		inline uint32_t GetTextureID() const { return mRendererID; }
-		void Update(void* buffer);
+		inline uint32_t GetWidth() const { return mWidth; }
+		inline uint32_t GetHeight() const { return mHeight; }
+		void Update(const void* buffer);
+		// Tightly packed RGB rows of width pixels
+		void UpdateRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const void* buffer);
 		static Ref<Texture> GetInvisibleTexture();
 	private:
 		uint32_t mRendererID = 0;
@@ -0,0 +1,78 @@
+/******************************************************************************
+/*!
+\file       ThumbnailCache.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Thumbnail Cache class, a per project file of JPEG
+			thumbnails and video metadata that is memory mapped on load.
+
+ /******************************************************************************/
+
+#ifndef ThumbnailCache_HPP
+#define ThumbnailCache_HPP
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Core/MappedFile.hpp>
+namespace FrameExtractor
+{
+	struct VideoMetadata
+	{
+		uint32_t mFrameCount = 0; // 0 when the container does not say
+		uint32_t mWidth = 0;
+		uint32_t mHeight = 0;
+		double mFPS = 0.0;
+		double mDuration = 0.0;   // Seconds
+		int64_t mCreationTime = 0; // Unix seconds from the container, 0 when absent
+		char mCodec[16] = {};
+	};
+
+	// Entries are keyed by absolute path and only match while the video's size
+	// and modification time are unchanged. Not thread safe, images returned by
+	// Find stay valid until the next Save, Open or Close.
+	class ThumbnailCache
+	{
+	public:
+		struct Hit
+		{
+			VideoMetadata mMetadata;
+			const uint8_t* mImage = nullptr; // JPEG, null for metadata only entries
+			size_t mImageSize = 0;
+		};
+
+		static std::filesystem::path GetCacheFile(const std::filesystem::path& projectDir);
+
+		bool Open(const std::filesystem::path& cacheFile);
+		void Close();
+		inline const std::filesystem::path& GetPath() const { return mPath; }
+
+		bool Find(const std::filesystem::path& videoPath, Hit& hit) const;
+		// An empty image stores the metadata alone
+		void Put(const std::filesystem::path& videoPath, const VideoMetadata& metadata, std::vector<uint8_t> image);
+
+		inline bool IsDirty() const { return !mAdded.empty(); }
+		inline size_t GetEntryCount() const { return mEntries.size() + mAdded.size(); }
+		// Rewrites the file with the mapped and added entries and maps it again
+		bool Save();
+	private:
+		struct Record;
+		struct Added
+		{
+			uint64_t mFileSize = 0;
+			int64_t mWriteTime = 0;
+			VideoMetadata mMetadata;
+			std::vector<uint8_t> mImage;
+		};
+		static std::string MakeKey(const std::filesystem::path& videoPath);
+
+		std::filesystem::path mPath;
+		MappedFile mFile;
+		std::unordered_map<std::string_view, const Record*> mEntries; // Views into mFile
+		std::unordered_map<std::string, Added> mAdded;
+	};
+}
+
+#endif
@@ -0,0 +1,154 @@
+/******************************************************************************
+/*!
+\file       ThumbnailService.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Thumbnail Service class, which decodes the first
+			keyframe of videos and probes their metadata on worker threads and
+			keeps a bounded number of small thumbnail textures.
+
+ /******************************************************************************/
+
+#ifndef ThumbnailService_HPP
+#define ThumbnailService_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+#include <Core/Core.hpp>
+#include <Graphics/Texture.hpp>
+#include <Graphics/ThumbnailCache.hpp>
+
+struct AVFormatContext;
+namespace FrameExtractor
+{
+	struct Thumbnail
+	{
+		Ref<Texture> mTexture;
+		VideoMetadata mMetadata;
+	};
+
+	struct ThumbnailStats
+	{
+		size_t mReady = 0;
+		size_t mCapacity = 0;
+		size_t mPending = 0;
+		size_t mFailed = 0;
+		uint64_t mEvictions = 0;
+		uint64_t mDiskHits = 0;  // Served from the project's thumbnail cache
+		uint64_t mDecoded = 0;   // Opened through FFmpeg
+	};
+
+	struct ProbeProgress
+	{
+		size_t mDone = 0;
+		size_t mTotal = 0;
+		inline bool IsRunning() const { return mDone < mTotal; }
+	};
+
+	// Requests are made from the UI thread while rendering and answered by
+	// worker threads. Pixels come back to the UI thread, which uploads them in
+	// Update, so no GL calls happen off the main thread. With a cache file set,
+	// known videos are served from it without touching FFmpeg.
+	class ThumbnailService
+	{
+	public:
+		static constexpr uint32_t DEFAULT_SIZE = 256;
+		static constexpr size_t DEFAULT_CAPACITY = 256;
+		// Uploads per Update, spreads a folder full of results over a few frames
+		static constexpr size_t MAX_UPLOADS_PER_UPDATE = 8;
+
+		ThumbnailService(uint32_t size = DEFAULT_SIZE, size_t capacity = DEFAULT_CAPACITY, unsigned workerCount = 0);
+		~ThumbnailService();
+		ThumbnailService(const ThumbnailService&) = delete;
+
+		// Returns the thumbnail if it is ready, otherwise queues it and returns
+		// nullptr. The pointer is valid until the next Update.
+		const Thumbnail* Request(const std::filesystem::path& path);
+		bool HasFailed(const std::filesystem::path& path) const;
+		// Call once per UI frame, uploads finished thumbnails
+		void Update();
+		// Metadata is known as soon as the disk cache has the video, usually
+		// before its thumbnail is uploaded. nullptr until then.
+		const VideoMetadata* GetMetadata(const std::filesystem::path& path) const;
+		// Reads the metadata of every video without decoding, only the container
+		// is opened. Videos already known or in the disk cache are skipped.
+		void Probe(const std::vector<std::filesystem::path>& paths);
+		inline ProbeProgress GetProbeProgress() const { return { mProbesDone, mProbesTotal }; }
+		// Drops pending thumbnail requests, e.g. when leaving a folder. Probes
+		// carry on.
+		void CancelPending();
+		// Saves the current cache file and switches to another, empty for none
+		void SetCacheFile(const std::filesystem::path& cacheFile);
+		ThumbnailStats GetStats() const;
+	private:
+		enum class JobType
+		{
+			Thumbnail,
+			Probe
+		};
+
+		struct Job
+		{
+			JobType mType = JobType::Thumbnail;
+			std::filesystem::path mPath;
+			ThumbnailCache::Hit mCached; // mImage is null when the video has to be decoded
+		};
+
+		struct Result
+		{
+			std::filesystem::path mPath;
+			std::vector<uint8_t> mPixels; // RGB24, tightly packed
+			uint32_t mWidth = 0;
+			uint32_t mHeight = 0;
+			VideoMetadata mMetadata;
+			std::vector<uint8_t> mEncoded; // JPEG for the disk cache, empty if it came from there
+			bool mProbe = false;
+			bool mFailed = false;
+		};
+
+		void WorkerLoop();
+		Result Generate(const std::filesystem::path& path) const;
+		static Result ProbeVideo(const std::filesystem::path& path);
+		static void ReadMetadata(AVFormatContext* formatContext, int streamIndex, const std::filesystem::path& path, VideoMetadata& metadata);
+		Result Unpack(const Job& job) const;
+		static std::vector<uint8_t> EncodeJPEG(const std::vector<uint8_t>& pixels, int width, int height);
+		void Store(Result& result);
+		void DropQueued(bool probes);
+		void WaitIdle();
+
+		uint32_t mSize;
+		size_t mCapacity;
+		std::vector<std::thread> mWorkers;
+
+		// Shared with the workers
+		mutable std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::condition_variable mIdleCondition;
+		std::deque<Job> mQueue; // Back is the most recent request
+		std::set<std::filesystem::path> mInFlight; // Queued or being decoded
+		std::deque<Result> mResults;
+		bool mStop = false;
+
+		// UI thread only
+		using Entry = std::pair<std::filesystem::path, Thumbnail>;
+		std::list<Entry> mReady; // Front is most recently used
+		std::map<std::filesystem::path, std::list<Entry>::iterator> mLookup;
+		std::set<std::filesystem::path> mFailed;
+		std::map<std::filesystem::path, VideoMetadata> mMetadata;
+		ThumbnailCache mCache;
+		uint64_t mEvictions = 0;
+		uint64_t mDiskHits = 0;
+		uint64_t mDecoded = 0;
+		size_t mProbesDone = 0;
+		size_t mProbesTotal = 0;
+	};
+}
+
+#endif
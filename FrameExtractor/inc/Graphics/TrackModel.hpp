@@ -0,0 +1,89 @@
+/******************************************************************************
+/*!
+\file       TrackModel.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Track Model class, the labelled objects of one video
+			as keyframed boxes that are interpolated between keyframes.
+
+ /******************************************************************************/
+
+#ifndef TrackModel_HPP
+#define TrackModel_HPP
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include <Graphics/AnnotationStore.hpp>
+namespace FrameExtractor
+{
+	struct TrackKeyframe
+	{
+		int32_t mFrame = 0;
+		BoundingBox mBox;
+	};
+
+	struct Track
+	{
+		uint32_t mID = 0;
+		uint32_t mClass = 0;
+		std::vector<TrackKeyframe> mKeyframes; // Sorted by frame, never empty
+
+		inline int32_t GetFirstFrame() const { return mKeyframes.front().mFrame; }
+		inline int32_t GetLastFrame() const { return mKeyframes.back().mFrame; }
+		// Linear between the keyframes either side, false outside the track
+		bool GetBox(int32_t frame, BoundingBox& box) const;
+		const TrackKeyframe* FindKeyframe(int32_t frame) const;
+	};
+
+	// A track only stores its keyframes, so moving one keyframe changes every
+	// frame up to its neighbours without touching per frame data. Tracks are
+	// found through an interval tree over their spans, rebuilt only when a
+	// span changes. Per frame boxes exist only once Materialize writes them
+	// into an AnnotationStore for export. Not thread safe.
+	class TrackModel
+	{
+	public:
+		// Returns the new track's ID
+		uint32_t AddTrack(uint32_t classID, int32_t frame, const BoundingBox& box);
+		// Keeps the track's ID, used when loading a project
+		void PutTrack(const Track& track);
+		bool RemoveTrack(uint32_t id);
+		// Adds or moves the keyframe at frame, the track grows to include it
+		bool SetKeyframe(uint32_t id, int32_t frame, const BoundingBox& box);
+		// Removing the only keyframe removes the track
+		bool RemoveKeyframe(uint32_t id, int32_t frame);
+		bool SetClass(uint32_t id, uint32_t classID);
+
+		const Track* GetTrack(uint32_t id) const;
+		inline const std::unordered_map<uint32_t, Track>& GetTracks() const { return mTracks; }
+		inline bool IsEmpty() const { return mTracks.empty(); }
+
+		// Appends the interpolated box of every track at frame, O(log n + k)
+		void GetActive(int32_t frame, std::vector<Annotation>& boxes) const;
+		// Replaces the tracked boxes of video in store with the tracks' boxes on
+		// every frame they cover, untracked boxes are kept. Returns the frames written.
+		size_t Materialize(AnnotationStore& store, const std::filesystem::path& video) const;
+	private:
+		// Sorted by first frame and read as a balanced tree, the middle of a range
+		// is its root and mMaxLast covers the whole range
+		struct Node
+		{
+			int32_t mFirst = 0;
+			int32_t mLast = 0;
+			int32_t mMaxLast = 0;
+			uint32_t mID = 0;
+		};
+
+		void Rebuild() const;
+		int32_t BuildRange(size_t begin, size_t end) const;
+		void QueryRange(size_t begin, size_t end, int32_t frame, std::vector<Annotation>& boxes) const;
+
+		std::unordered_map<uint32_t, Track> mTracks;
+		uint32_t mNextID = 1;
+		mutable std::vector<Node> mTree;
+		mutable bool mTreeDirty = false;
+	};
+}
+
+#endif
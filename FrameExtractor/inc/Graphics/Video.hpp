@@ -12,6 +12,9 @@
 #define Video_HPP
 
 #include <filesystem>
+#include <thread>
+#include <atomic>
+#include <array>
 
 extern "C"
 {
@@ -21,28 +24,132 @@ extern "C"
 }
 #include <Core/Core.hpp>
 #include <Graphics/Texture.hpp>
+#include <Graphics/FrameQueue.hpp>
+#include <Graphics/VideoIndex.hpp>
+#include <Graphics/FrameCache.hpp>
+#include <Graphics/DecodePolicy.hpp>
+#include <Graphics/ColorConverter.hpp>
+#include <Graphics/ActivityIndex.hpp>
 namespace FrameExtractor
 {
+	struct PlaybackStats
+	{
+		size_t mQueueDepth = 0;
+		size_t mQueueCapacity = 0;
+		uint64_t mDecodedFrames = 0;
+		uint64_t mPresentedFrames = 0;
+		uint64_t mDroppedFrames = 0;  // Decoded but overtaken by the playback clock
+		uint64_t mUnderruns = 0;      // UI frames where the next frame was not ready yet
+		bool mKeyframesOnly = false;  // Trick play at high speeds
+		float mEffectiveSpeed = 0.f;  // Speed the clock last advanced at
+	};
+
+	// Forward playback that runs through static stretches at mHighSpeed and
+	// eases back to the requested speed mLookAhead seconds before motion
+	struct AdaptiveSpeed
+	{
+		bool mEnabled = false;
+		float mHighSpeed = 20.f;
+		float mLookAhead = 1.f;  // Seconds of video
+		uint8_t mThreshold = ActivityIndex::DEFAULT_THRESHOLD;
+	};
+
 	class Video
 	{
 	public:
-		Video(const std::filesystem::path& path);
+		static constexpr size_t DEFAULT_QUEUE_CAPACITY = 6;
+		// Upper bound on the memory queued for reverse playback, one GOP is
+		// queued while the one before it is decoded
+		static constexpr size_t MAX_REVERSE_QUEUE_BYTES = size_t(512) << 20;
+		// Upper bound on the memory queued as the adaptive speed look-ahead
+		static constexpr size_t MAX_ADAPTIVE_QUEUE_BYTES = size_t(512) << 20;
+		// Seconds of video per second it takes adaptive playback to reach full speed
+		static constexpr float ADAPTIVE_ACCELERATION = 20.f;
+		// At or above this speed in either direction only keyframes are decoded
+		static constexpr float TRICK_PLAY_SPEED = 10.f;
+		// Output size changes smaller than this band are ignored
+		static constexpr float OUTPUT_GROW_THRESHOLD = 1.1f;
+		static constexpr float OUTPUT_SHRINK_THRESHOLD = 0.8f;
+		static constexpr uint32_t MIN_OUTPUT_SIZE = 16;
+
+		// Playback videos switch between the Playback and Scrubbing policies on
+		// their own, when a seek flushes the decoder anyway. Any other use case
+		// keeps its policy for the video's lifetime.
+		Video(const std::filesystem::path& path, DecodeUseCase useCase = DecodeUseCase::Playback, size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
 		~Video();
 		Ref<Texture> GetFrame();
+		// Advances the playback clock and presents the queued frame matching it.
+		// Decoding happens on a background thread that is started on demand.
+		// Negative speeds play in reverse, GOP by GOP. From TRICK_PLAY_SPEED
+		// upwards a sample of keyframes is shown instead of every frame.
 		void DecodeTime(float dt, float speedFactor);
+		// Same as DecodeTime, but the clock is kept by the caller and set to
+		// seconds each call. Adaptive speed does not apply.
+		void DecodeAt(double seconds, float speedFactor);
+		// Synchronous seek, stops the background thread. Served from the frame
+		// cache when possible, otherwise the whole GOP is decoded into the cache.
 		bool Decode(uint32_t frameIndex);
+		// Decode in two halves, for seeking several videos at once. DecodeFrame
+		// leaves the texture alone, so after StopPlayback it can run on a
+		// worker thread, one per video. ShowDecodedFrame then uploads its
+		// result on the UI thread.
+		bool DecodeFrame(uint32_t frameIndex);
+		void ShowDecodedFrame();
+		void StopPlayback();
+
+		// Positive speeds passed to DecodeTime are scaled per frame by the scene
+		// change measured on the decode thread. The queue doubles as the
+		// look-ahead window, so it is enlarged to hold mLookAhead seconds.
+		void SetAdaptiveSpeed(const AdaptiveSpeed& adaptive);
+		inline const AdaptiveSpeed& GetAdaptiveSpeed() const { return mAdaptive; }
+		inline float GetEffectiveSpeed() const { return mEffectiveSpeed; }
 
-		inline uint8_t GetFPS() const { return mFPS; }
+		inline uint32_t GetCurrentFrame() const { return mCurrentFrame; }
+		inline double GetPlaybackTime() const { return mPlaybackTime; }
+		PlaybackStats GetPlaybackStats() const;
+		inline FrameCacheStats GetCacheStats() const { return mFrameCache.GetStats(); }
+		inline void SetCacheBudget(size_t bytes) { mFrameCache.SetBudget(bytes); }
+
+		// Timestamps and frame numbers come from the packet index, not from the
+		// nominal frame rate, so variable frame rate footage stays frame accurate.
+		double GetFrameTime(uint32_t frameIndex) const;
+		uint32_t GetFrameAtTime(double seconds) const;
+		std::string GetTimecode(uint32_t frameIndex) const;
+		inline const VideoIndex& GetIndex() const { return mIndex; }
+		// First opens index the file in the background and number frames from
+		// the container's estimates until then. Call every UI frame, returns
+		// true when the built index was swapped in and GetCurrentFrame moved
+		// to its numbering. Playback stops and resumes on the next DecodeTime.
+		bool UpdateIndex();
+		inline bool IsIndexEstimated() const { return mIndex.IsEstimated(); }
+		inline const DecodePolicy& GetDecodePolicy() const { return mPolicy; }
+
+		// Applies to frames converted from now on, call Decode to refresh a paused frame
+		void SetColorAdjust(const ColorAdjust& adjust);
+		inline ColorAdjust GetColorAdjust() const { return mConverter.GetAdjust(); }
+		inline const ColorConverter& GetColorConverter() const { return mConverter; }
+
+		inline double GetFPS() const { return mFPS; }
 		inline uint32_t GetMaxFrames() const { return mMaxFrames; }
 		inline uint32_t GetWidth() const { return mWidth; }
 		inline uint32_t GetHeight() const { return mHeight; }
+
+		// Frames are converted and uploaded at this size, 0 means the source
+		// size. Returns true when the texture was recreated, call Decode to
+		// refill it while paused. Grid videos also decode at the largest
+		// fraction of the source size that still covers it.
+		bool SetOutputSize(uint32_t width, uint32_t height);
+		inline uint32_t GetOutputWidth() const { return mOutputWidth; }
+		inline uint32_t GetOutputHeight() const { return mOutputHeight; }
 		inline std::filesystem::path GetPath() const { return mPath; }
 	private:
 		std::filesystem::path mPath;
-		uint8_t mFPS;
+		double mFPS;
 		uint32_t mMaxFrames;
 		uint32_t mWidth;
 		uint32_t mHeight;
+		uint32_t mOutputWidth;
+		uint32_t mOutputHeight;
 
 		AVFormatContext* formatContext = nullptr;  // Container context
 		AVCodecContext* codecContext = nullptr;    // Decoder context
@@ -51,14 +158,74 @@ namespace FrameExtractor
 		AVFrame* frame = nullptr;                  // Frame to hold decoded data
 		AVFrame* RGBframe = nullptr;                  // Frame to hold decoded data
 		AVFrame* convertedFrame = nullptr;         // Converted frame (e.g., RGB)
-		SwsContext* swsContext = nullptr;			// For pixel format conversion
+		SwsContext* swsContext = nullptr;			// For pixel format conversion, borrowed from the FramePool
+		std::array<int, 6> mScalerGeometry = {};     // Source size and format, output size and flags of swsContext
+		AVBufferRef* mRGBBuffer = nullptr;          // Backs RGBframe
 		AVPacket* packet = nullptr;                           // Packet for compressed data
 
 		Ref<Texture> mTexture;       // Vector of textures for each frame
-		double time_per_frame = 0.0;
-		double last_frame_time = 0.0;
 
-			
+		enum class PlaybackMode
+		{
+			Forward,
+			Reverse,
+			Keyframes
+		};
+
+		bool OpenDecoder(const DecodePolicy& policy);
+		// Frame count, rate and reverse queue size from mIndex
+		void ApplyIndex();
+		void IndexLoop();
+		void UsePolicyFor(DecodeUseCase useCase);
+		// Starts or restarts the decode thread for the mode the speed needs
+		PlaybackMode PreparePlayback(float speedFactor);
+		// Sets the clock and shows the latest queued frame due by it
+		void Present(double seconds);
+		void StartPlayback(PlaybackMode mode);
+		void DecodeLoop();
+		void ReverseDecodeLoop();
+		void KeyframeDecodeLoop();
+		void SeekToKeyframe(uint32_t keyframe);
+		void ConvertFrame(const AVFrame* decoded, uint8_t* dst);
+		float ComputeAdaptiveSpeed(float speedFactor, float dt);
+		size_t GetAdaptiveQueueCapacity() const;
+		int64_t GetPTS(const AVFrame* decoded) const;
+		uint32_t GetFrameIndex(const AVFrame* decoded) const;
+
+		DecodeUseCase mUseCase;
+		ColorConverter mConverter;
+		DecodePolicy mPolicy;
+		VideoIndex mIndex;
+		VideoIndex mBuiltIndex;              // Written by the index thread until mIndexReady
+		std::thread mIndexThread;
+		std::atomic<bool> mIndexReady = false;
+		std::atomic<bool> mStopIndexing = false;
+		FrameCache mFrameCache;
+		uint32_t mNextDecodeFrame = 0; // Frame the decoder would output next if read on
+
+		FrameQueue mQueue;
+		size_t mQueueCapacity;
+		size_t mReverseQueueCapacity;
+		PlaybackMode mMode = PlaybackMode::Forward;
+		bool mKeyframesReverse = false;
+		std::thread mDecodeThread;
+		std::atomic<float> mSpeedFactor = 1.f;
+		std::atomic<double> mClock = 0.0;   // Copy of mPlaybackTime for the decode thread
+		std::atomic<bool> mStopDecoding = false;
+		std::atomic<bool> mEndOfStream = false;
+		std::atomic<uint64_t> mDecodedFrames = 0;
+		uint64_t mPresentedFrames = 0;
+		uint64_t mDroppedFrames = 0;
+		uint64_t mUnderruns = 0;
+		double mPlaybackTime = 0.0;
+		uint32_t mCurrentFrame = 0;
+		const uint8_t* mDecodedData = nullptr; // Left by DecodeFrame for ShowDecodedFrame
+		uint32_t mDecodedFrame = 0;
+
+		AdaptiveSpeed mAdaptive;
+		std::atomic<bool> mMeasureEnergy = false; // Read by the decode thread
+		float mEffectiveSpeed = 0.f;
+		double mLastMotionTime = -1.0; // Presentation time of the last active frame shown
 	};
 }
 
@@ -0,0 +1,54 @@
+/******************************************************************************
+/*!
+\file       VideoBenchmark.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Video Benchmark class, which times decoding under each
+			decode policy and frame conversion on synthetic data in the background.
+
+ /******************************************************************************/
+
+#ifndef VideoBenchmark_HPP
+#define VideoBenchmark_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <Graphics/DecodePolicy.hpp>
+
+namespace FrameExtractor
+{
+	class VideoBenchmark
+	{
+	public:
+		~VideoBenchmark();
+
+		// Generates the clips on first use, they are kept in the temp directory
+		void StartDecodeBenchmark();
+		// Compares swscale with each ColorConverter path on synthetic frames
+		void StartConvertBenchmark();
+		inline bool IsRunning() const { return mRunning; }
+		// Report lines produced since the last call, safe to call every frame
+		std::vector<std::string> TakeMessages();
+	private:
+		void Start(void (VideoBenchmark::* run)());
+		void RunDecodeBenchmark();
+		void RunConvertBenchmark();
+		bool GenerateClip(const std::filesystem::path& path, int width, int height, int frameCount);
+		// False for a clip left half written or generated with other settings
+		bool IsClipUsable(const std::filesystem::path& path, int width, int height, int frameCount);
+		// Returns decoded frames per second, 0 on failure
+		double MeasureDecode(const std::filesystem::path& path, const DecodePolicy& policy, uint32_t& frameCount);
+		void Report(std::string message);
+
+		std::thread mThread;
+		std::atomic<bool> mRunning = false;
+		std::mutex mMutex;
+		std::vector<std::string> mMessages;
+	};
+}
+
+#endif
@@ -0,0 +1,93 @@
+/******************************************************************************
+/*!
+\file       VideoGrid.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Video Grid class, several videos played side by side
+			under one playback clock.
+
+ /******************************************************************************/
+
+#ifndef VideoGrid_HPP
+#define VideoGrid_HPP
+#include <filesystem>
+#include <vector>
+#include <Core/Core.hpp>
+#include <Graphics/Video.hpp>
+namespace FrameExtractor
+{
+	struct GridTile
+	{
+		Scope<Video> mVideo;
+		double mOffset = 0.0; // Video time shown at grid time 0
+		double mStart = 0.0;  // Part of the video the tile plays, in video time
+		double mEnd = 0.0;
+		double mRequestedStart = 0.0; // As asked for, clamped again when the built index swaps in
+		double mRequestedEnd = 0.0;
+		bool mHeld = false;   // Showing mStart or mEnd while the clock is outside them
+	};
+
+	// Every tile has its own decode thread and frame queue. Instead of
+	// advancing on their own the tiles are handed the time of the shared
+	// clock every UI frame, so a tile that falls behind drops frames to catch
+	// up rather than drifting, and seeking, pausing or changing speed lands
+	// every tile on the frame for the same instant.
+	class VideoGrid
+	{
+	public:
+		static constexpr size_t MAX_TILES = 9;
+
+		// The tile plays the video from start to end seconds, end 0 runs to
+		// the end of the video. False past MAX_TILES.
+		bool AddVideo(const std::filesystem::path& path, double offset = 0.0, double start = 0.0, double end = 0.0);
+		// Replaces the tiles with count equal parts of one video, each
+		// offset so they all start at clock 0 and a review takes 1/count the time
+		bool AddSegments(const std::filesystem::path& path, size_t count);
+		void RemoveTile(size_t tile);
+		void Clear();
+		inline bool IsEmpty() const { return mTiles.empty(); }
+		inline size_t GetTileCount() const { return mTiles.size(); }
+		inline const GridTile& GetTile(size_t tile) const { return mTiles[tile]; }
+		inline Video& GetVideo(size_t tile) const { return *mTiles[tile].mVideo; }
+		// Moves the tile against the others, for cameras that started recording apart
+		void SetOffset(size_t tile, double offset);
+
+		// As square as possible, wider than tall
+		static void GetLayout(size_t count, uint32_t& columns, uint32_t& rows);
+		// Each video is converted and decoded no larger than it fits in width x height
+		void SetTileSize(uint32_t width, uint32_t height);
+		// Frame cache bytes for the whole grid, split evenly between the tiles
+		// and split again whenever one is added or removed
+		void SetCacheBudget(size_t bytes);
+		inline size_t GetCacheBudget() const { return mCacheBudget; }
+
+		// Advances the clock by dt at speedFactor, false once it reaches either end
+		bool Play(float dt, float speedFactor);
+		// Stops every decode thread and shows the frames of the clock's instant
+		void Pause();
+		// Stops every tile and decodes each one's frame on a thread of its own
+		void Seek(double seconds);
+		inline bool IsPlaying() const { return mPlaying; }
+		inline double GetClock() const { return mClock; }
+		// Until the last tile finishes
+		double GetDuration() const;
+		// Video time the tile shows at the clock, kept within its start and end
+		double GetTileTime(size_t tile) const;
+	private:
+		// Opens the video as the last tile without seeking, false past MAX_TILES
+		bool PushTile(const std::filesystem::path& path, double offset, double start, double end);
+		// Clamps the requested start and end to the video's current duration
+		static void UpdateBounds(GridTile& tile);
+		void UpdateIndexes();
+		void ShowHeld(GridTile& tile, double time);
+		void ShareCacheBudget();
+
+		std::vector<GridTile> mTiles;
+		double mClock = 0.0;
+		bool mPlaying = false;
+		size_t mCacheBudget = FrameCache::DEFAULT_BUDGET;
+	};
+}
+
+#endif
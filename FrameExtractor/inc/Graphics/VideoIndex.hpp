@@ -0,0 +1,79 @@
+/******************************************************************************
+/*!
+\file       VideoIndex.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Video Index class, a per video table of packet
+			timestamps, keyframe flags and byte offsets in presentation order.
+
+ /******************************************************************************/
+
+#ifndef VideoIndex_HPP
+#define VideoIndex_HPP
+#include <atomic>
+#include <filesystem>
+#include <vector>
+
+struct AVFormatContext;
+namespace FrameExtractor
+{
+	struct IndexEntry
+	{
+		int64_t mPTS = 0;  // In stream time base
+		int64_t mPos = -1; // Byte offset of the packet, -1 if unknown
+		bool mKeyframe = false;
+	};
+
+	class VideoIndex
+	{
+	public:
+		struct Summary
+		{
+			uint32_t mFrameCount = 0;
+			double mDuration = 0.0;
+			double mFPS = 0.0;
+		};
+
+		// One pass over the packets of the stream, no decoding. Leaves the
+		// demuxer at the start of the file. Setting cancel leaves it empty.
+		void Build(AVFormatContext* formatContext, int streamIndex, const std::atomic<bool>* cancel = nullptr);
+		// Evenly spaced frames from the container's frame count, duration and
+		// rate, every one marked as a keyframe so seeks land on the demuxer's.
+		// Stands in until the built index is ready.
+		void Estimate(AVFormatContext* formatContext, int streamIndex);
+		bool Load(const std::filesystem::path& videoPath);
+		bool Save(const std::filesystem::path& videoPath) const;
+		// What GetFrameCount, GetDuration and GetAverageFPS would return after
+		// Load, read from the sidecar's header and its first and last entries
+		static bool LoadSummary(const std::filesystem::path& videoPath, Summary& summary);
+		static std::filesystem::path GetSidecarPath(const std::filesystem::path& videoPath);
+
+		inline bool IsEmpty() const { return mEntries.empty(); }
+		inline bool IsEstimated() const { return mEstimated; }
+		inline uint32_t GetFrameCount() const { return static_cast<uint32_t>(mEntries.size()); }
+		inline const IndexEntry& GetEntry(uint32_t frameIndex) const { return mEntries[frameIndex]; }
+		// Frame index of the keyframe that has to be decoded to reach frameIndex
+		inline uint32_t GetKeyframe(uint32_t frameIndex) const { return mKeyframeOf[frameIndex]; }
+		inline const std::vector<uint32_t>& GetKeyframes() const { return mKeyframes; }
+
+		double GetTime(uint32_t frameIndex) const;
+		double GetDuration() const;
+		double GetAverageFPS() const;
+		// Last frame presented at or before the given time / timestamp
+		uint32_t FindFrameAtTime(double seconds) const;
+		uint32_t FindFrame(int64_t pts) const;
+	private:
+		void BuildKeyframeTable();
+
+		std::vector<IndexEntry> mEntries;
+		std::vector<uint32_t> mKeyframeOf;
+		std::vector<uint32_t> mKeyframes;
+		int64_t mStartPTS = 0;
+		int32_t mTimeBaseNum = 1;
+		int32_t mTimeBaseDen = 1;
+		bool mEstimated = false;
+	};
+}
+
+#endif
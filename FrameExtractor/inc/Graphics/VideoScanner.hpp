@@ -0,0 +1,131 @@
+/******************************************************************************
+/*!
+\file       VideoScanner.hpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Declares the Video Scanner class, which demuxes or decodes whole
+			videos on worker threads and reports timestamp faults and black,
+			frozen and undecodable time ranges.
+
+ /******************************************************************************/
+
+#ifndef VideoScanner_HPP
+#define VideoScanner_HPP
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace FrameExtractor
+{
+	enum class ScanIssue
+	{
+		Black,
+		Frozen,
+		DecodeError,
+		TimestampGap,  // Packets missing between two timestamps
+		NonMonotonic,  // Timestamps running backwards or repeating
+		Truncated      // Packets stop before the duration the container claims
+	};
+
+	enum class ScanDepth
+	{
+		Packets, // Demuxes only, container level issues at disk speed
+		Full     // Also decodes for black, frozen and undecodable frames
+	};
+
+	struct ScanOptions
+	{
+		ScanDepth mDepth = ScanDepth::Full;
+		double mGapSeconds = 1.0; // Shorter timestamp gaps are not reported
+	};
+
+	struct ScanRange
+	{
+		ScanIssue mIssue = ScanIssue::Black;
+		double mStart = 0.0; // Seconds from the start of the video
+		double mEnd = 0.0;
+	};
+
+	struct ScanReport
+	{
+		std::filesystem::path mPath;
+		double mDuration = 0.0;
+		std::vector<ScanRange> mRanges; // In order of mStart
+		bool mOpenFailed = false;
+		std::string mError; // Why it failed to open
+	};
+
+	struct ScanProgress
+	{
+		size_t mDone = 0;
+		size_t mTotal = 0;
+		double mScannedSeconds = 0.0; // Video time read so far
+		uint64_t mScannedBytes = 0;   // Packet payload read so far
+		ScanDepth mDepth = ScanDepth::Full;
+		double mElapsedSeconds = 0.0; // Wall time since Scan
+		unsigned mWorkers = 0;
+		inline bool IsRunning() const { return mDone < mTotal; }
+	};
+
+	// Every packet's decode timestamp is checked against the previous one for
+	// gaps and disorder. Full scans also shrink frames to the ActivityIndex
+	// luma grid. A grid that is dark everywhere is black, a grid hashing the
+	// same as the previous one is frozen (live camera noise never repeats
+	// exactly). Runs shorter than the minimum durations are not reported.
+	class VideoScanner
+	{
+	public:
+		static constexpr uint8_t BLACK_MEAN = 20;    // Mean luma, video range starts at 16
+		static constexpr uint8_t BLACK_PEAK = 40;    // Brightest grid cell
+		static constexpr double MIN_BLACK_SECONDS = 1.0;
+		static constexpr double MIN_FROZEN_SECONDS = 2.0;
+		// Decode errors and timestamp faults closer together than this are
+		// reported as one range
+		static constexpr double ERROR_MERGE_SECONDS = 1.0;
+		// Missing this much of the claimed duration at the end counts as truncated
+		static constexpr double MIN_TRUNCATED_SECONDS = 1.0;
+
+		VideoScanner(unsigned workerCount = 0);
+		~VideoScanner();
+		VideoScanner(const VideoScanner&) = delete;
+
+		// Replaces any scan in progress and clears previous reports. Timestamp
+		// and truncation checks run at either depth.
+		void Scan(const std::vector<std::filesystem::path>& paths, const ScanOptions& options = {});
+		// Stops the workers at their next frame, finished reports are kept
+		void Cancel();
+		ScanProgress GetProgress() const;
+		// Copies the reports finished so far, in completion order
+		std::vector<ScanReport> GetReports() const;
+
+		static const char* GetIssueName(ScanIssue issue);
+	private:
+		void WorkerLoop();
+		ScanReport ScanVideo(const std::filesystem::path& path, uint64_t generation, const ScanOptions& options);
+		inline bool IsCancelled(uint64_t generation) const { return mStop || mGeneration != generation; }
+
+		std::vector<std::thread> mWorkers;
+		mutable std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::deque<std::filesystem::path> mQueue;
+		ScanOptions mOptions;
+		std::vector<ScanReport> mReports;
+		std::atomic<uint64_t> mGeneration = 0; // Bumped by Scan and Cancel
+		std::atomic<bool> mStop = false;
+		size_t mDone = 0;
+		size_t mTotal = 0;
+		std::atomic<uint64_t> mScannedMilliseconds = 0;
+		std::atomic<uint64_t> mScannedBytes = 0;
+		std::chrono::steady_clock::time_point mStarted;
+		std::chrono::steady_clock::time_point mFinished;
+	};
+}
+
+#endif
@@ -0,0 +1,69 @@
+/******************************************************************************
+/*!
+\file       MappedFile.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Mapped File class, a read only memory mapping of a
+			whole file
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/MappedFile.hpp>
+
+namespace FrameExtractor
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	// Windows Implementation
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		// Delete sharing lets a newer file be renamed over this one while mapped
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		mFile = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mMapping)
+		{
+			Close();
+			return false;
+		}
+
+		mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+		if (!mData)
+		{
+			Close();
+			return false;
+		}
+		mSize = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData)
+			UnmapViewOfFile(mData);
+		if (mMapping)
+			CloseHandle(mMapping);
+		if (mFile)
+			CloseHandle(mFile);
+		mData = nullptr;
+		mMapping = nullptr;
+		mFile = nullptr;
+		mSize = 0;
+	}
+}
@@ -298,12 +298,70 @@ namespace YAML
         }
     };
 
+    template<>
+    struct convert<FrameExtractor::Track>
+    {
+        static bool decode(const Node& node, FrameExtractor::Track& track)
+        {
+            if (!node.IsMap()) return false;
+            track.mID = node["ID"].as<uint32_t>(0);
+            track.mClass = node["Class"].as<uint32_t>(0);
+            track.mKeyframes.clear();
+            for (const auto& keyframeNode : node["Keyframes"])
+            {
+                // Frame, MinX, MinY, MaxX, MaxY
+                if (!keyframeNode.IsSequence() || keyframeNode.size() != 5) return false;
+                FrameExtractor::TrackKeyframe keyframe;
+                keyframe.mFrame = keyframeNode[0].as<int32_t>();
+                keyframe.mBox = { keyframeNode[1].as<float>(), keyframeNode[2].as<float>(), keyframeNode[3].as<float>(), keyframeNode[4].as<float>() };
+                track.mKeyframes.push_back(keyframe);
+            }
+            return !track.mKeyframes.empty();
+        }
+
+        static Node encode(const FrameExtractor::Track& track)
+        {
+            Node node;
+            node["ID"] = track.mID;
+            node["Class"] = track.mClass;
+            Node keyframesNode(NodeType::Sequence);
+            for (const auto& keyframe : track.mKeyframes)
+            {
+                Node keyframeNode;
+                keyframeNode.SetStyle(EmitterStyle::Flow);
+                keyframeNode.push_back(keyframe.mFrame);
+                keyframeNode.push_back(keyframe.mBox.minX);
+                keyframeNode.push_back(keyframe.mBox.minY);
+                keyframeNode.push_back(keyframe.mBox.maxX);
+                keyframeNode.push_back(keyframe.mBox.maxY);
+                keyframesNode.push_back(keyframeNode);
+            }
+            node["Keyframes"] = keyframesNode;
+            return node;
+        }
+    };
+
 }
 
 
 
 namespace FrameExtractor
 {
+    static void EmitTracks(YAML::Emitter& emitter, const std::map<std::filesystem::path, TrackModel>& tracks)
+    {
+        emitter << YAML::Key << "Tracks" << YAML::Value << YAML::BeginMap;
+        for (const auto& [video, model] : tracks)
+        {
+            if (model.IsEmpty())
+                continue;
+            emitter << YAML::Key << video.string() << YAML::Value << YAML::BeginSeq;
+            for (const auto& [id, track] : model.GetTracks())
+                emitter << YAML::convert<Track>::encode(track);
+            emitter << YAML::EndSeq;
+        }
+        emitter << YAML::EndMap;
+    }
+
     std::string EntryTypeToString(EntryType type)
     {
         switch (type)
@@ -343,6 +401,7 @@ namespace FrameExtractor
     {
         mCountingData.clear();
         mAggregateStoreData.clear();
+        mTracks.clear();
 		mName = name;
         mProjectDir = dir;
         mProjectDir /= name;
@@ -350,6 +409,7 @@ namespace FrameExtractor
 		std::filesystem::create_directory(mProjectDir);
         std::filesystem::create_directory(mAssetDir);
         mProjectFilePath = mProjectDir / (name + ".FrEX");
+        mAnnotations.Open(AnnotationStore::GetStoreFile(mProjectDir));
 
         YAML::Node node;
 
@@ -422,9 +482,25 @@ namespace FrameExtractor
             }
         }
 
+        mTracks.clear();
+        if (node["Tracks"])
+        {
+            for (const auto& videoNode : node["Tracks"])
+            {
+                TrackModel& model = mTracks[videoNode.first.as<std::string>()];
+                for (const auto& trackNode : videoNode.second)
+                {
+                    Track track;
+                    if (YAML::convert<Track>::decode(trackNode, track))
+                        model.PutTrack(track);
+                }
+            }
+        }
+
         mCountingData = tmpCountingData;
         mAggregateStoreData = tmpAggregateStoreData;
 		ifs.close();
+        mAnnotations.Open(AnnotationStore::GetStoreFile(mProjectDir));
     }
 
     void Project::SaveProject()
@@ -467,6 +543,8 @@ namespace FrameExtractor
         }
         emitter << YAML::EndMap;
 
+        EmitTracks(emitter, mTracks);
+
         emitter << YAML::EndMap;
         emitter << YAML::EndMap;
 
@@ -474,6 +552,9 @@ namespace FrameExtractor
         file << emitter.c_str();
 		file.close();
 
+        if (mAnnotations.IsDirty() && !mAnnotations.Save())
+            FRAMEEX_CORE_ERROR("Failed to save annotations: {}", mAnnotations.GetPath().string());
+
 
 
     }
@@ -520,7 +601,8 @@ namespace FrameExtractor
             emitter << YAML::EndMap;
         }
         emitter << YAML::EndMap;
-        
+
+        EmitTracks(emitter, mTracks);
 
         emitter << YAML::EndMap;
         emitter << YAML::EndMap;
@@ -23,6 +23,8 @@ namespace FrameExtractor
         Commands.push_back("HISTORY");
         Commands.push_back("CLEAR");
         Commands.push_back("CLASSIFY");
+        Commands.push_back("BENCHMARK DECODE");
+        Commands.push_back("BENCHMARK CONVERT");
         AutoScroll = true;
         ScrollToBottom = false;
 
@@ -73,6 +75,26 @@ namespace FrameExtractor
             for (int i = first > 0 ? first : 0; i < History.Size; i++)
                 AddLog("%3d: {}\n", i, History[i]);
         }
+        else if (Stricmp(command_line, "BENCHMARK DECODE") == 0)
+        {
+            if (mBenchmark.IsRunning())
+                AddLog("A benchmark is already running");
+            else
+            {
+                AddLog("Decode benchmark started, results are printed as they finish");
+                mBenchmark.StartDecodeBenchmark();
+            }
+        }
+        else if (Stricmp(command_line, "BENCHMARK CONVERT") == 0)
+        {
+            if (mBenchmark.IsRunning())
+                AddLog("A benchmark is already running");
+            else
+            {
+                AddLog("Conversion benchmark started, results are printed as they finish");
+                mBenchmark.StartConvertBenchmark();
+            }
+        }
         else
         {
             AddLog("Unknown command: '{}'\n", command_line);
@@ -191,6 +213,9 @@ namespace FrameExtractor
 
     void ConsolePanel::OnImGuiRender(float dt)
     {
+        for (const std::string& message : mBenchmark.TakeMessages())
+            AddLogInfo(message);
+
         ImGui::Begin("Console");
 
         // TODO: display items starting from the bottom
@@ -15,7 +15,6 @@
 #include <GUI/GuiResourcesManager.hpp>
 #include <Core/LoggerManager.hpp>
 #include <imgui.h>
-#include <Graphics/Video.hpp>
 namespace FrameExtractor
 {
 	ExplorerPanel::ExplorerPanel(Project* project) : mProject(project)
@@ -28,6 +27,15 @@ namespace FrameExtractor
 	}
 	void ExplorerPanel::OnImGuiRender(float dt)
 	{
+		UpdateCacheFile();
+		mThumbnails.Update();
+		if (mListedPath != mCurrentPath)
+		{
+			// Thumbnails of the folder we left are no longer worth decoding
+			mThumbnails.CancelPending();
+			mListedPath = mCurrentPath;
+		}
+
 		ImGui::Begin("Content Browser");
 		ImVec2 windowSize = ImGui::GetContentRegionAvail();
 		ImGui::BeginChild("ScrollableRegion", ImVec2(windowSize.x, windowSize.y), true);
@@ -98,14 +106,7 @@ namespace FrameExtractor
 			}
 			else if (extension == ".mp4")
 			{
-				if (!mCache.contains(entry))
-				{
-					Video video(entry);
-					video.Decode(0);
-					mCache[entry].mTexture = video.GetFrame();
-					mCache[entry].mMaxFrames = video.GetMaxFrames();
-				}
-				screenID = static_cast<uint64_t>(mCache[entry].mTexture->GetTextureID());
+				screenID = static_cast<uint64_t>(GetCache(entry).mTexture->GetTextureID());
 			}
 			else
 			{
@@ -150,15 +151,26 @@ namespace FrameExtractor
 		ImGui::End();
 	}
 
+	void ExplorerPanel::UpdateCacheFile()
+	{
+		// Thumbnails and metadata persist in the project folder between sessions
+		mThumbnails.SetCacheFile(mProject->IsProjectLoaded() ? ThumbnailCache::GetCacheFile(mProject->GetProjectDir()) : std::filesystem::path());
+	}
+
+	void ExplorerPanel::ProbeVideos(const std::vector<std::filesystem::path>& paths)
+	{
+		// May run before the first render of a freshly loaded project
+		UpdateCacheFile();
+		mThumbnails.Probe(paths);
+	}
+
 	Cache ExplorerPanel::GetCache(std::filesystem::path path)
 	{
-		if (!mCache.contains(path))
-		{
-			Video video(path);
-			video.Decode(0);
-			mCache[path].mMaxFrames = video.GetMaxFrames();
-			mCache[path].mTexture = video.GetFrame();
-		}
-		return mCache[path];
+		Cache cache;
+		const Thumbnail* thumbnail = mThumbnails.Request(path);
+		cache.mTexture = thumbnail ? thumbnail->mTexture : Resource(Icon::FILE_ICON);
+		if (const VideoMetadata* metadata = mThumbnails.GetMetadata(path))
+			cache.mMaxFrames = metadata->mFrameCount;
+		return cache;
 	}
 }
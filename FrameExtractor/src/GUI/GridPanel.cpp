@@ -0,0 +1,282 @@
+/******************************************************************************
+/*!
+\file       GridPanel.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Grid Panel class, a viewport that plays several
+			videos side by side in step with each other.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <GUI/GridPanel.hpp>
+#include <GUI/ViewportPanel.hpp>
+#include <GUI/ImGuiManager.hpp>
+#include <GUI/GuiResourcesManager.hpp>
+#include <Core/LoggerManager.hpp>
+
+namespace FrameExtractor
+{
+	// The main viewport's steps, fastest reverse first, so the middle index is 1x forward
+	static constexpr int32_t GRID_SPEED_COUNT = 2 * ViewportPanel::SPEED_STEP_COUNT;
+
+	static float GetGridSpeed(int32_t index)
+	{
+		int32_t steps = ViewportPanel::SPEED_STEP_COUNT;
+		return ViewportPanel::GetSpeedStep(index < steps ? index - steps : index - steps + 1);
+	}
+
+	static std::string FormatSpeed(float speed)
+	{
+		char buffer[32];
+		if (speed < 0.f)
+			std::snprintf(buffer, sizeof(buffer), "<< %g x", -speed);
+		else
+			std::snprintf(buffer, sizeof(buffer), "%g x >>", speed);
+		return buffer;
+	}
+
+	void GridPanel::OnImGuiRender(float dt)
+	{
+		ImGui::Begin("Grid Viewport");
+		bool isWindowFocused = ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows);
+		float lineHeight = (ImGui::GetFontSize() + ImGui::GetStyle().FramePadding.y * 2.0f);
+
+		if (mIsPlaying && !mGrid.Play(dt, GetGridSpeed(mSpeedIndex)))
+			mIsPlaying = false;
+
+		ImVec2 region = ImGui::GetContentRegionAvail();
+		ImVec2 gridSize(region.x, std::max(lineHeight, region.y - lineHeight * 3.5f));
+		ImVec2 gridPos = ImGui::GetCursorScreenPos();
+		if (mGrid.IsEmpty())
+		{
+			float spacing = ImGui::GetStyle().ItemSpacing.x;
+			ImVec2 buttonSize((gridSize.x - spacing) * 0.5f, gridSize.y);
+			ImGui::Button("Drop up to 9 videos here to play them side by side##Grid", buttonSize);
+			AcceptVideoDrop(false);
+			ImGui::SameLine();
+			std::string segmentsLabel = "Drop a video here to review it as " + std::to_string(mSegmentCount) + " segments at once##GridSegments";
+			ImGui::Button(segmentsLabel.c_str(), buttonSize);
+			AcceptVideoDrop(true);
+		}
+		else
+		{
+			uint32_t columns = 1;
+			uint32_t rows = 1;
+			VideoGrid::GetLayout(mGrid.GetTileCount(), columns, rows);
+			float spacing = ImGui::GetStyle().ItemSpacing.x;
+			ImVec2 cellSize((gridSize.x - spacing * (columns - 1)) / columns, (gridSize.y - spacing * (rows - 1)) / rows);
+			// Decoding and converting no more than a tile shows is what keeps several streams real time
+			mGrid.SetTileSize((uint32_t)std::max(cellSize.x, 1.f), (uint32_t)std::max(cellSize.y, 1.f));
+
+			size_t removed = SIZE_MAX;
+			for (size_t i = 0; i < mGrid.GetTileCount(); i++)
+			{
+				if (i % columns)
+					ImGui::SameLine();
+				ImGui::PushID((int)i);
+				if (!DrawTile(i, cellSize))
+					removed = i;
+				ImGui::PopID();
+			}
+			if (removed != SIZE_MAX)
+				mGrid.RemoveTile(removed);
+		}
+
+		if (mGrid.IsEmpty())
+			mIsPlaying = false;
+
+		ImGui::SetCursorScreenPos({ gridPos.x, gridPos.y + gridSize.y + ImGui::GetStyle().ItemSpacing.y });
+		DrawControls(lineHeight, isWindowFocused);
+		ImGui::End();
+	}
+
+	bool GridPanel::DrawTile(size_t tile, ImVec2 size)
+	{
+		Video& video = mGrid.GetVideo(tile);
+		ImVec2 pos = ImGui::GetCursorScreenPos();
+		bool promote = ImGui::InvisibleButton("##GridTile", size);
+		bool hovered = ImGui::IsItemHovered();
+		// Dropping onto a tile adds the video as a new tile
+		AcceptVideoDrop(false);
+
+		// Letterboxed inside the cell
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+		float scale = std::min(size.x / video.GetWidth(), size.y / video.GetHeight());
+		ImVec2 imageSize(video.GetWidth() * scale, video.GetHeight() * scale);
+		ImVec2 imagePos(pos.x + (size.x - imageSize.x) * 0.5f, pos.y + (size.y - imageSize.y) * 0.5f);
+		drawList->AddRectFilled(pos, { pos.x + size.x, pos.y + size.y }, IM_COL32(0, 0, 0, 255));
+		drawList->AddImage((ImTextureID)video.GetFrame()->GetTextureID(), imagePos, { imagePos.x + imageSize.x, imagePos.y + imageSize.y });
+
+		std::string label = video.GetPath().filename().string() + "  " + video.GetTimecode(video.GetCurrentFrame());
+		const GridTile& gridTile = mGrid.GetTile(tile);
+		if (gridTile.mHeld)
+			label += "  (held)";
+		ImVec2 textSize = ImGui::CalcTextSize(label.c_str());
+		drawList->AddRectFilled({ pos.x, pos.y }, { pos.x + textSize.x + 8.f, pos.y + textSize.y + 4.f }, IM_COL32(0, 0, 0, 160));
+		drawList->AddText({ pos.x + 4.f, pos.y + 2.f }, IM_COL32(255, 255, 255, 255), label.c_str());
+		if (hovered)
+		{
+			drawList->AddRect(pos, { pos.x + size.x, pos.y + size.y }, IM_COL32(82, 168, 255, 255), 0.f, 0, 2.f);
+			if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+			{
+				PlaybackStats stats = video.GetPlaybackStats();
+				ImGui::BeginTooltip();
+				ImGui::TextUnformatted(video.GetPath().string().c_str());
+				ImGui::Text("Offset: %.2f s", gridTile.mOffset);
+				ImGui::Text("Output: %u x %u (Source %u x %u)", video.GetOutputWidth(), video.GetOutputHeight(), video.GetWidth(), video.GetHeight());
+				ImGui::Text("Queue Depth: %zu / %zu", stats.mQueueDepth, stats.mQueueCapacity);
+				ImGui::Text("Presented: %llu  Dropped: %llu  Underruns: %llu", stats.mPresentedFrames, stats.mDroppedFrames, stats.mUnderruns);
+				ImGui::TextDisabled("Click to open in the viewport, right click for options");
+				ImGui::EndTooltip();
+			}
+		}
+
+		bool keep = true;
+		if (ImGui::BeginPopupContextItem("##GridTileMenu"))
+		{
+			// Lines cameras up that started recording at different times
+			double offset = gridTile.mOffset;
+			ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8.f);
+			if (ImGui::InputDouble("Offset (s)##GridTile", &offset, 0.04, 1.0, "%.2f", ImGuiInputTextFlags_EnterReturnsTrue))
+			{
+				mGrid.SetOffset(tile, offset);
+			}
+			std::string segmentsLabel = "Review as " + std::to_string(mSegmentCount) + " segments##GridTile";
+			if (ImGui::MenuItem(segmentsLabel.c_str()))
+			{
+				mIsPlaying = false;
+				std::filesystem::path path = video.GetPath();
+				ImGui::EndPopup();
+				mGrid.AddSegments(path, mSegmentCount);
+				// The tiles were replaced, nothing of this one is left to draw
+				return true;
+			}
+			if (ImGui::MenuItem("Remove##GridTile"))
+				keep = false;
+			ImGui::EndPopup();
+		}
+
+		// The viewport takes over from the exact frame the tile shows
+		if (promote && mViewport)
+		{
+			mIsPlaying = false;
+			mViewport->OpenAt(video.GetPath(), video.GetCurrentFrame());
+		}
+		return keep;
+	}
+
+	void GridPanel::DrawControls(float lineHeight, bool isWindowFocused)
+	{
+		ImGui::BeginDisabled(mGrid.IsEmpty());
+		float duration = static_cast<float>(mGrid.GetDuration());
+		float clock = static_cast<float>(mGrid.GetClock());
+		ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+		if (ImGui::SliderFloat("##GridClock", &clock, 0.f, std::max(duration, 0.001f), ""))
+		{
+			if (ImGui::IsItemActivated())
+				mWasPlaying = mIsPlaying;
+			mIsPlaying = false;
+			mGrid.Seek(clock);
+		}
+		if (ImGui::IsItemDeactivatedAfterEdit())
+			mIsPlaying = mWasPlaying;
+
+		// One frame of the first video, the others land on their frame for the same instant
+		double frameTime = mGrid.IsEmpty() ? 0.04 : 1.0 / mGrid.GetVideo(0).GetFPS();
+		float buttonSize = lineHeight * 1.5f;
+		ImGui::BeginGroup();
+		if (ImGui::ImageButton("#GridBackward", (ImTextureID)Resource(BACKWARD_ICON)->GetTextureID(), { buttonSize, buttonSize })
+			|| (isWindowFocused && ImGui::IsKeyPressed(ImGuiKey_LeftArrow)))
+		{
+			mIsPlaying = false;
+			mGrid.Seek(mGrid.GetClock() - frameTime);
+		}
+		ImGui::SameLine();
+		if (ImGui::ImageButton("#GridPlay", (ImTextureID)Resource(mIsPlaying ? STOP_ICON : PLAY_ICON)->GetTextureID(), { buttonSize, buttonSize })
+			|| (isWindowFocused && ImGui::IsKeyPressed(ImGuiKey_Space)))
+		{
+			if (mIsPlaying)
+			{
+				mIsPlaying = false;
+				mGrid.Pause();
+			}
+			else
+			{
+				// Playing from the end starts over
+				float speed = GetGridSpeed(mSpeedIndex);
+				if (speed > 0.f && mGrid.GetClock() >= mGrid.GetDuration())
+					mGrid.Seek(0.0);
+				else if (speed < 0.f && mGrid.GetClock() <= 0.0)
+					mGrid.Seek(mGrid.GetDuration());
+				mIsPlaying = true;
+			}
+		}
+		ImGui::SameLine();
+		if (ImGui::ImageButton("#GridForward", (ImTextureID)Resource(FORWARD_ICON)->GetTextureID(), { buttonSize, buttonSize })
+			|| (isWindowFocused && ImGui::IsKeyPressed(ImGuiKey_RightArrow)))
+		{
+			mIsPlaying = false;
+			mGrid.Seek(mGrid.GetClock() + frameTime);
+		}
+		ImGui::EndGroup();
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(lineHeight * 5);
+		// Every tile takes the new speed on the next frame, at the same clock
+		if (ImGui::BeginCombo("##GridSpeed", FormatSpeed(GetGridSpeed(mSpeedIndex)).c_str()))
+		{
+			for (int32_t i = 0; i < GRID_SPEED_COUNT; i++)
+				if (ImGui::Selectable(FormatSpeed(GetGridSpeed(i)).c_str(), i == mSpeedIndex))
+					mSpeedIndex = i;
+			ImGui::EndCombo();
+		}
+		ImGui::SameLine();
+		ImGui::Text("%s / %s", FormatClock(mGrid.GetClock()).c_str(), FormatClock(duration).c_str());
+		ImGui::SameLine();
+		if (ImGui::Button("Clear##Grid"))
+		{
+			mIsPlaying = false;
+			mGrid.Clear();
+		}
+		ImGui::EndDisabled();
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(lineHeight * 5);
+		ImGui::SliderInt("Segments##Grid", &mSegmentCount, 2, static_cast<int>(VideoGrid::MAX_TILES));
+		if (!mIsPlaying && mGrid.IsPlaying())
+			mGrid.Pause();
+	}
+
+	void GridPanel::AcceptVideoDrop(bool asSegments)
+	{
+		if (ImGui::BeginDragDropTarget())
+		{
+			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ITEM_NAME"))
+			{
+				std::filesystem::path path(static_cast<const char*>(payload->Data));
+				if (asSegments)
+				{
+					mIsPlaying = false;
+					mGrid.AddSegments(path, mSegmentCount);
+				}
+				else if (mGrid.GetTileCount() >= VideoGrid::MAX_TILES)
+				{
+					APP_CORE_INFO("The grid holds at most {} videos", VideoGrid::MAX_TILES);
+				}
+				else
+				{
+					mGrid.AddVideo(path);
+				}
+			}
+			ImGui::EndDragDropTarget();
+		}
+	}
+
+	std::string GridPanel::FormatClock(double seconds)
+	{
+		int milliseconds = static_cast<int>(std::llround(std::max(seconds, 0.0) * 1000.0));
+		char text[32] = {};
+		std::snprintf(text, sizeof(text), "%02d:%02d:%02d.%03d", milliseconds / 3600000, milliseconds / 60000 % 60, milliseconds / 1000 % 60, milliseconds % 1000);
+		return text;
+	}
+}
@@ -30,6 +30,7 @@
 #include <GUI/ProjectPanel.hpp>
 #include <GUI/ConsolePanel.hpp>
 #include <GUI/ExplorerPanel.hpp>
+#include <GUI/GridPanel.hpp>
 #include <GLFW/glfw3.h>
 #define YAML_CPP_STATIC_DEFINE
 #include <yaml-cpp/yaml.h>
@@ -214,6 +215,7 @@ namespace FrameExtractor
 			ImVec2 pos = ImVec2{ 0,0 };
 			mViewportPanel = new ViewportPanel(name, size, pos);
 			mViewportPanel->OnAttach();
+			mViewportPanel->SetProject(&mProject);
 		}
 
 		{
@@ -232,6 +234,11 @@ namespace FrameExtractor
 			mToolsPanel->OnAttach();
 		}
 
+		{
+			mGridPanel = new GridPanel(mViewportPanel);
+			mGridPanel->OnAttach();
+		}
+
 		{
 			mProjectPanel = new ProjectPanel(mExplorerPanel, mViewportPanel, &mProject);
 			mProjectPanel->OnAttach();
@@ -240,12 +247,14 @@ namespace FrameExtractor
 
 	ImGuiManager::~ImGuiManager()
 	{
+		mGridPanel->OnDetach();
 		mToolsPanel->OnDetach();
 		mProjectPanel->OnDetach();
 		mExplorerPanel->OnDetach();
 		mConsolePanel->OnDetach();
 		mViewportPanel->OnDetach();
 
+		delete mGridPanel;
 		delete mToolsPanel;
 		delete mProjectPanel;
 		delete mExplorerPanel;
@@ -752,6 +761,7 @@ namespace FrameExtractor
 			mExplorerPanel->OnImGuiRender(dt);
 			mProjectPanel->OnImGuiRender(dt);
 			mViewportPanel->OnImGuiRender(dt);
+			mGridPanel->OnImGuiRender(dt);
 			mConsolePanel->OnImGuiRender(dt);
 
 			ImGui::PopStyleVar();
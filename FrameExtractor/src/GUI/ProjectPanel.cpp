@@ -61,6 +61,7 @@ namespace FrameExtractor
                 const char* droppedItem = static_cast<const char*>(payload->Data);
 
                 videosInProject.insert(droppedItem);
+                ExPanel->ProbeVideos({ droppedItem });
                 
             }
             ImGui::EndDragDropTarget();
@@ -85,6 +86,12 @@ namespace FrameExtractor
         }
 
         ImGui::SetCursorScreenPos(ImVec2(buttonPos.x, buttonPos.y));
+        ProbeProgress probe = ExPanel->GetProbeProgress();
+        if (probe.IsRunning())
+        {
+            std::string overlay = "Reading video info " + std::to_string(probe.mDone) + " / " + std::to_string(probe.mTotal);
+            ImGui::ProgressBar(static_cast<float>(probe.mDone) / probe.mTotal, { -1.f, 0.f }, overlay.c_str());
+        }
         auto regionAvail = ImGui::GetContentRegionAvail();
         float lineHeight = ImGui::GetFontSize() + ImGui::GetStyle().FramePadding.y * 2.0f;
         int deletionTrack = 0;
@@ -110,7 +117,9 @@ namespace FrameExtractor
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImGui::GetStyleColorVec4(ImGuiCol_FrameBgHovered));
             ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImGui::GetStyleColorVec4(ImGuiCol_FrameBgActive));
             ImGui::PushStyleVar(ImGuiStyleVar_ButtonTextAlign, { 0,0, });
-            ImGui::Button((fileName + " [" + std::to_string(ExPanel->GetCache(entry).mMaxFrames) + "]").c_str(), {regionAvail.x - lineHeight - ImGui::GetStyle().FramePadding.y * 2.0f, lineHeight});
+            const VideoMetadata* metadata = ExPanel->GetMetadata(entry);
+            uint32_t frameCount = metadata ? metadata->mFrameCount : 0;
+            ImGui::Button((fileName + (frameCount ? " [" + std::to_string(frameCount) + "]" : "")).c_str(), {regionAvail.x - lineHeight - ImGui::GetStyle().FramePadding.y * 2.0f, lineHeight});
             ImGui::PopStyleVar();
             ImGui::PopStyleColor(3);
 
@@ -124,6 +133,18 @@ namespace FrameExtractor
 
                 ImGui::BeginTooltip();
                 ImGui::Image((ImTextureID)ExPanel->GetCache(entry).mTexture->GetTextureID(), { printedThumbnailSize ,printedThumbnailSize });
+                if (metadata)
+                {
+                    ImGui::Text("%u x %u  %s", metadata->mWidth, metadata->mHeight, metadata->mCodec);
+                    ImGui::Text("%.2f fps  %.1f s", metadata->mFPS, metadata->mDuration);
+                    if (metadata->mCreationTime)
+                    {
+                        char created[32] = {};
+                        time_t creationTime = static_cast<time_t>(metadata->mCreationTime);
+                        std::strftime(created, sizeof(created), "%Y-%m-%d %H:%M:%S", std::localtime(&creationTime));
+                        ImGui::Text("Created %s", created);
+                    }
+                }
                 ImGui::EndTooltip();
             }
             if (ImGui::BeginDragDropSource())
@@ -191,6 +212,7 @@ namespace FrameExtractor
         {
             AddDirectoryRecursive(entry, mProject->mVideosInProject);
         }
+        ProbeProjectVideos();
     }
     void ProjectPanel::OnLoad()
     {
@@ -198,5 +220,13 @@ namespace FrameExtractor
         {
             AddDirectoryRecursive(entry, mProject->mVideosInProject);
         }
+        ProbeProjectVideos();
+    }
+
+    void ProjectPanel::ProbeProjectVideos()
+    {
+        // Containers only, the list shows real numbers without decoding anything
+        std::vector<std::filesystem::path> paths(mProject->mVideosInProject.begin(), mProject->mVideosInProject.end());
+        ExPanel->ProbeVideos(paths);
     }
 }
@@ -31,6 +31,9 @@ namespace FrameExtractor
 
     ToolsPanel::~ToolsPanel()
     {
+        mUnpackCancel = true;
+        if (mUnpackThread.joinable())
+            mUnpackThread.join();
     }
 
     void ToolsPanel::OnImGuiRender(float dt)
@@ -52,33 +55,11 @@ namespace FrameExtractor
             }
 
             {
-                auto open = ImGui::BeginTabItem("Frame Extraction##Toolsbar");
-                if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
-                {
-                    ImGui::BeginTooltip();
-                    ImGui::Text("Frame Extraction Tasks");
-                    ImGui::EndTooltip();
-                }
-                if (open)
-                {
-                    // FRAME EXTRACTION TOOLSET HERE
-                    ImGui::EndTabItem();
-                }
+                FrameExtractionTab(lineHeight);
             }
 
             {
-                auto open = ImGui::BeginTabItem("Labelling##Toolsbar");
-                if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
-                {
-                    ImGui::BeginTooltip();
-                    ImGui::Text("Labelling Tasks");
-                    ImGui::EndTooltip();
-                }
-                if (open)
-                {
-                    // LABELLING TOOLSET HERE
-                    ImGui::EndTabItem();
-                }
+                LabellingTab(lineHeight);
             }
 
             ImGui::EndTabBar();
@@ -235,6 +216,588 @@ namespace FrameExtractor
         return ss.str();
     }
 
+    // Times in the notes are written as HH:MM:SS from the start of the video
+    static std::string FormatScanTime(double seconds)
+    {
+        int totalSeconds = static_cast<int>(std::max(0.0, seconds));
+        char buffer[16] = {};
+        std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", totalSeconds / 3600, (totalSeconds / 60) % 60, totalSeconds % 60);
+        return buffer;
+    }
+
+    static double ParseTime(const std::string& text)
+    {
+        int hours = 0, minutes = 0, seconds = 0;
+        std::sscanf(text.c_str(), "%d:%d:%d", &hours, &minutes, &seconds);
+        return hours * 3600.0 + minutes * 60.0 + seconds;
+    }
+
+    CountingEntrance ToolsPanel::ApplyScanReport(const CountingEntrance& entrance, const ScanReport& report)
+    {
+        // Ranges this close to either end of the video count as touching it
+        static constexpr double EDGE_SECONDS = 0.5;
+        // The notes only have room for names this long
+        static constexpr size_t MAX_VIDEO_NAME = 15;
+
+        CountingEntrance result = entrance;
+        std::string videoName = report.mPath.stem().string().substr(0, MAX_VIDEO_NAME);
+        auto addCorrupted = [&]() {
+            if (std::find(result.mCorruptedVideos.begin(), result.mCorruptedVideos.end(), videoName) == result.mCorruptedVideos.end())
+                result.mCorruptedVideos.push_back(videoName);
+        };
+        auto addSkip = [&](const ScanRange& range) {
+            std::pair<std::string, std::string> skip(FormatScanTime(range.mStart), FormatScanTime(range.mEnd));
+            if (std::find(result.mFrameSkips.begin(), result.mFrameSkips.end(), skip) == result.mFrameSkips.end())
+                result.mFrameSkips.push_back(skip);
+        };
+
+        if (report.mOpenFailed)
+        {
+            addCorrupted();
+            return result;
+        }
+        for (const ScanRange& range : report.mRanges)
+        {
+            switch (range.mIssue)
+            {
+            case ScanIssue::Black:
+                // The notes hold one blank period, tied to the start or the end
+                if (result.mBlankedVideos.empty() && range.mStart <= EDGE_SECONDS)
+                    result.mBlankedVideos.emplace_back(true, FormatScanTime(range.mEnd));
+                else if (result.mBlankedVideos.empty() && range.mEnd >= report.mDuration - EDGE_SECONDS)
+                    result.mBlankedVideos.emplace_back(false, FormatScanTime(range.mStart));
+                else
+                    addSkip(range);
+                break;
+            case ScanIssue::Frozen:
+                addSkip(range);
+                break;
+            case ScanIssue::TimestampGap:
+                addSkip(range);
+                break;
+            case ScanIssue::Truncated:
+                addSkip(range);
+                addCorrupted();
+                break;
+            case ScanIssue::DecodeError:
+            case ScanIssue::NonMonotonic:
+                addCorrupted();
+                break;
+            }
+        }
+        return result;
+    }
+
+    void ToolsPanel::ScanResults(float lineHeight, const ScanProgress& progress)
+    {
+        if (progress.IsRunning())
+        {
+            std::string overlay = std::to_string(progress.mDone) + " / " + std::to_string(progress.mTotal) + " Videos";
+            ImGui::ProgressBar(progress.mTotal ? (float)progress.mDone / progress.mTotal : 0.f, { -1.f, 0.f }, overlay.c_str());
+        }
+        if (mScanReports.empty() || !ImGui::CollapsingHeader("Scan Results##Counting"))
+            return;
+
+        // Per core, so it reads the same on any machine
+        if (progress.mElapsedSeconds > 0.0 && progress.mWorkers > 0)
+        {
+            if (progress.mDepth == ScanDepth::Packets)
+                ImGui::TextDisabled("%.2f GB/s on %u workers", progress.mScannedBytes / progress.mElapsedSeconds / 1e9, progress.mWorkers);
+            else
+                ImGui::TextDisabled("%.1fx real time per core on %u workers", progress.mScannedSeconds / progress.mElapsedSeconds / progress.mWorkers, progress.mWorkers);
+        }
+        ImGui::TextDisabled("Select a video, then accept it under an entrance in Notes");
+
+        ImGui::BeginChild("ScanResults##CountingChild", { ImGui::GetContentRegionAvail().x, lineHeight * 8 }, ImGuiChildFlags_Border);
+        for (int i = 0; i < (int)mScanReports.size(); i++)
+        {
+            const ScanReport& report = mScanReports[i];
+            std::string label = report.mPath.filename().string();
+            if (report.mOpenFailed)
+                label += "  (unreadable: " + report.mError + ")";
+            else if (report.mRanges.empty())
+                label += "  (clean)";
+            else
+                label += "  (" + std::to_string(report.mRanges.size()) + " issues)";
+            if (ImGui::Selectable((label + "##ScanReport" + std::to_string(i)).c_str(), mScanSelection == i))
+            {
+                mScanSelection = mScanSelection == i ? -1 : i;
+            }
+            if (mScanSelection != i)
+                continue;
+            ImGui::Indent(lineHeight);
+            for (const ScanRange& range : report.mRanges)
+            {
+                ImGui::Text("%s  %s - %s", VideoScanner::GetIssueName(range.mIssue), FormatScanTime(range.mStart).c_str(), FormatScanTime(range.mEnd).c_str());
+            }
+            ImGui::Unindent(lineHeight);
+        }
+        ImGui::EndChild();
+    }
+
+    void ToolsPanel::FrameExtractionTab(float lineHeight)
+    {
+        auto open = ImGui::BeginTabItem("Frame Extraction##Toolsbar");
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("Frame Extraction Tasks");
+            ImGui::EndTooltip();
+        }
+        if (!open)
+            return;
+
+        ExtractStats stats = mExtractor.GetStats();
+        ImGui::BeginDisabled(stats.mRunning);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, lineHeight * 6);
+
+        ImGui::Text("Extract: ");
+        ImGui::NextColumn();
+        const char* modes[] = { "Every Nth Frame", "Every T Seconds", "Keyframes Only", "Time Ranges" };
+        int mode = static_cast<int>(mExtractOptions.mMode);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::Combo("##Mode##Extraction", &mode, modes, IM_ARRAYSIZE(modes)))
+        {
+            mExtractOptions.mMode = static_cast<ExtractMode>(mode);
+        }
+        ImGui::NextColumn();
+
+        switch (mExtractOptions.mMode)
+        {
+        case ExtractMode::EveryNthFrame:
+        {
+            ImGui::Text("Every: ");
+            ImGui::NextColumn();
+            int step = static_cast<int>(mExtractOptions.mFrameStep);
+            ImGui::SetNextItemWidth(lineHeight * 8);
+            if (ImGui::InputInt("Frames##Extraction", &step, 1, 25))
+            {
+                mExtractOptions.mFrameStep = static_cast<uint32_t>(std::max(1, step));
+            }
+            ImGui::NextColumn();
+            break;
+        }
+        case ExtractMode::EveryInterval:
+            ImGui::Text("Every: ");
+            ImGui::NextColumn();
+            ImGui::SetNextItemWidth(lineHeight * 8);
+            if (ImGui::InputDouble("Seconds##Extraction", &mExtractOptions.mInterval, 0.5, 5.0, "%.2f"))
+            {
+                mExtractOptions.mInterval = std::max(0.04, mExtractOptions.mInterval);
+            }
+            ImGui::NextColumn();
+            break;
+        case ExtractMode::Keyframes:
+            break;
+        case ExtractMode::TimeRanges:
+        {
+            if (ImGui::Button("+##AddRange##Extraction", { lineHeight, 0 }))
+            {
+                CommandHistory::execute(std::make_unique<PushBackCommand<std::pair<std::string, std::string>>>(&mExtractRanges, std::pair<std::string, std::string>("00:00:00", "00:00:00")));
+            }
+            ImGui::SameLine();
+            ImGui::Text("Ranges: ");
+            ImGui::NextColumn();
+            int idx = 0;
+            for (auto& range : mExtractRanges)
+            {
+                Widget::Time(("##RangeStart##Extraction" + std::to_string(idx)).c_str(), range.first, lineHeight * 4);
+                ImGui::SameLine();
+                Widget::Time(("##RangeEnd##Extraction" + std::to_string(idx)).c_str(), range.second, lineHeight * 4);
+                ImGui::SameLine();
+                if (ImGui::Button(("-##RemoveRange##Extraction" + std::to_string(idx)).c_str(), { lineHeight, 0 }))
+                {
+                    CommandHistory::execute(std::make_unique<VectorEraseCommand<std::pair<std::string, std::string>>>(&mExtractRanges, idx));
+                    break;
+                }
+                idx++;
+            }
+            ImGui::NextColumn();
+            break;
+        }
+        }
+
+        ImGui::Text("Format: ");
+        ImGui::NextColumn();
+        const char* formats[] = { "JPEG", "PNG" };
+        int format = static_cast<int>(mExtractOptions.mFormat);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::Combo("##Format##Extraction", &format, formats, IM_ARRAYSIZE(formats)))
+        {
+            mExtractOptions.mFormat = static_cast<ImageFormat>(format);
+        }
+        if (mExtractOptions.mFormat == ImageFormat::JPEG)
+        {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(lineHeight * 5);
+            // Lower quantisers are better, the slider reads the usual way round
+            int quality = 33 - mExtractOptions.mJPEGQuality;
+            if (ImGui::SliderInt("Quality##Extraction", &quality, 2, 31))
+            {
+                mExtractOptions.mJPEGQuality = 33 - quality;
+            }
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("Output: ");
+        ImGui::NextColumn();
+        const char* outputs[] = { "Loose Files", "Packed Archive" };
+        int output = static_cast<int>(mExtractOptions.mOutput);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::Combo("##Output##Extraction", &output, outputs, IM_ARRAYSIZE(outputs)))
+        {
+            mExtractOptions.mOutput = static_cast<ExtractOutput>(output);
+        }
+        ImGui::SameLine();
+        if (mExtractOptions.mOutput == ExtractOutput::Archive)
+            ImGui::TextDisabled("One %s file, unpack to loose files when needed", FrameArchive::EXTENSION);
+        else
+            ImGui::TextDisabled("One file per frame");
+        ImGui::NextColumn();
+
+        ImGui::Text("Max Width: ");
+        ImGui::NextColumn();
+        int maxWidth = static_cast<int>(mExtractOptions.mMaxWidth);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::InputInt("##MaxWidth##Extraction", &maxWidth, 64, 256))
+        {
+            mExtractOptions.mMaxWidth = static_cast<uint32_t>(std::max(0, maxWidth));
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("0 keeps the source size");
+        ImGui::NextColumn();
+
+        ImGui::Text("Output Folder: ");
+        ImGui::NextColumn();
+        if (mExtractOutputBuffer[0] == '\0' && mProject->IsProjectLoaded())
+        {
+            std::string defaultDir = (mProject->GetProjectDir() / "Extracted Frames").string();
+            std::strncpy(mExtractOutputBuffer, defaultDir.c_str(), sizeof(mExtractOutputBuffer) - 1);
+        }
+        ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+        ImGui::InputText("##OutputFolder##Extraction", mExtractOutputBuffer, sizeof(mExtractOutputBuffer));
+        ImGui::Columns(1);
+        ImGui::EndDisabled();
+
+        ImGui::Separator();
+        size_t videoCount = mProject->mVideosInProject.size();
+        if (stats.mRunning)
+        {
+            if (ImGui::Button("Cancel##Extraction"))
+            {
+                mExtractor.Cancel();
+            }
+        }
+        else
+        {
+            ImGui::BeginDisabled(videoCount == 0 || mExtractOutputBuffer[0] == '\0');
+            if (ImGui::Button(("Extract from " + std::to_string(videoCount) + " Videos##Extraction").c_str()))
+            {
+                ExtractOptions options = mExtractOptions;
+                options.mOutputDir = mExtractOutputBuffer;
+                options.mRanges.clear();
+                for (const auto& [start, end] : mExtractRanges)
+                    options.mRanges.emplace_back(ParseTime(start), ParseTime(end));
+                std::vector<std::filesystem::path> videos(mProject->mVideosInProject.begin(), mProject->mVideosInProject.end());
+                std::sort(videos.begin(), videos.end());
+                mExtractor.Start(videos, options);
+            }
+            ImGui::EndDisabled();
+        }
+
+        ImGui::SameLine();
+        if (mUnpacking)
+        {
+            if (ImGui::Button("Cancel Unpack##Extraction"))
+            {
+                mUnpackCancel = true;
+            }
+        }
+        else if (ImGui::Button("Unpack Archive...##Extraction"))
+        {
+            auto archivePath = OpenFileDialog("Frame Archive (*.frexarc)\0*.frexarc\0");
+            if (std::filesystem::exists(archivePath))
+            {
+                if (mUnpackThread.joinable())
+                    mUnpackThread.join();
+                mUnpacking = true;
+                mUnpackCancel = false;
+                mUnpackDone = 0;
+                mUnpackTotal = 0;
+                // Next to the archive, in a folder named after it
+                mUnpackThread = std::thread([this, path = std::filesystem::path(archivePath)]() {
+                    FrameArchive archive;
+                    if (archive.Open(path))
+                    {
+                        mUnpackTotal = archive.GetEntryCount();
+                        size_t written = archive.Unpack(path.parent_path() / path.stem(), &mUnpackDone, &mUnpackCancel);
+                        APP_CORE_INFO("Unpacked {} of {} frames from {}", written, archive.GetEntryCount(), path.string());
+                    }
+                    mUnpacking = false;
+                });
+            }
+        }
+        if (mUnpacking || mUnpackTotal > 0)
+        {
+            size_t done = mUnpackDone;
+            size_t total = mUnpackTotal;
+            std::string overlay = "Unpacked " + std::to_string(done) + " / " + std::to_string(total) + " Frames";
+            ImGui::ProgressBar(total ? (float)done / total : 0.f, { -1.f, 0.f }, overlay.c_str());
+        }
+
+        if (stats.mVideosTotal > 0)
+        {
+            std::string overlay = std::to_string(stats.mVideosDone) + " / " + std::to_string(stats.mVideosTotal) + " Videos";
+            ImGui::ProgressBar((float)stats.mVideosDone / stats.mVideosTotal, { -1.f, 0.f }, overlay.c_str());
+
+            double seconds = std::max(stats.mElapsedSeconds, 0.001);
+            ImGui::Text("Written: %llu frames (%.1f MB) in %.1f s", stats.mWritten, stats.mBytesWritten / 1048576.0, stats.mElapsedSeconds);
+            ImGui::Text("Throughput: %.1f frames/s, %.1f MB/s", stats.mWritten / seconds, stats.mBytesWritten / 1048576.0 / seconds);
+            ImGui::Text("Decoded: %llu  Selected: %llu  Converted: %llu  Encoded: %llu", stats.mDecoded, stats.mSelected, stats.mConverted, stats.mEncoded);
+            if (stats.mFailed > 0)
+                ImGui::TextColored({ 1.f, 0.4f, 0.4f, 1.f }, "Failed: %llu", stats.mFailed);
+            if (!stats.mArchive.empty())
+                ImGui::TextWrapped("Archive: %s", stats.mArchive.string().c_str());
+
+            // A queue that stays full points at the stage after it
+            auto queueBar = [](const char* label, const ExtractStats::Queue& queue) {
+                std::string overlay = std::string(label) + " " + std::to_string(queue.mDepth) + " / " + std::to_string(queue.mCapacity) + ", " + std::to_string(queue.mBytes >> 20) + " MB  (full " + std::to_string(queue.mFullWaits) + "x)";
+                ImGui::ProgressBar(queue.mCapacity ? (float)queue.mDepth / queue.mCapacity : 0.f, { -1.f, 0.f }, overlay.c_str());
+            };
+            queueBar("Decode > Convert", stats.mDecodedQueue);
+            queueBar("Convert > Encode", stats.mConvertedQueue);
+            queueBar("Encode > Write", stats.mEncodedQueue);
+        }
+        ImGui::EndTabItem();
+    }
+
+    void ToolsPanel::LabellingTab(float lineHeight)
+    {
+        auto open = ImGui::BeginTabItem("Labelling##Toolsbar");
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("Labelling Tasks");
+            ImGui::EndTooltip();
+        }
+        if (!open)
+            return;
+
+        AnnotationStore& annotations = mProject->mAnnotations;
+        ImGui::BeginDisabled(!mProject->IsProjectLoaded());
+        ImGui::BeginDisabled(!annotations.IsDirty());
+        if (ImGui::Button("Save Annotations##Labelling"))
+        {
+            if (!annotations.Save())
+                FRAMEEX_CORE_ERROR("Failed to save annotations: {}", annotations.GetPath().string());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Revert##Labelling"))
+        {
+            annotations.Open(AnnotationStore::GetStoreFile(mProject->GetProjectDir()));
+        }
+        ImGui::EndDisabled();
+
+        size_t trackCount = 0;
+        for (const auto& [video, tracks] : mProject->mTracks)
+            trackCount += tracks.GetTracks().size();
+        ImGui::SameLine();
+        ImGui::BeginDisabled(trackCount == 0);
+        if (ImGui::Button(("Bake " + std::to_string(trackCount) + " Tracks##Labelling").c_str()))
+        {
+            size_t frames = 0;
+            for (const auto& [video, tracks] : mProject->mTracks)
+                frames += tracks.Materialize(annotations, video);
+            APP_CORE_INFO("Baked {} tracks into {} frames", trackCount, frames);
+        }
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal | ImGuiHoveredFlags_AllowWhenDisabled))
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("Writes the box of every tracked frame into the annotations for export");
+            ImGui::EndTooltip();
+        }
+        ImGui::EndDisabled();
+
+        std::vector<AnnotationStore::VideoSummary> summaries = annotations.GetSummaries();
+        ImGui::SameLine();
+        ImGui::Text("%zu boxes in %zu videos%s", annotations.GetBoxCount(), summaries.size(), annotations.IsDirty() ? " (unsaved)" : "");
+
+        ImGui::Separator();
+        DatasetExport(lineHeight);
+        ImGui::Separator();
+
+        ImGui::BeginChild("Videos##LabellingChild", ImGui::GetContentRegionAvail(), ImGuiChildFlags_Border);
+        ImGui::Columns(3);
+        ImGui::Text("Video");
+        ImGui::NextColumn();
+        ImGui::Text("Frames");
+        ImGui::NextColumn();
+        ImGui::Text("Boxes");
+        ImGui::NextColumn();
+        ImGui::Separator();
+        for (const auto& summary : summaries)
+        {
+            ImGui::TextUnformatted(std::filesystem::path(summary.mVideo).filename().string().c_str());
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+            {
+                ImGui::BeginTooltip();
+                ImGui::TextUnformatted(summary.mVideo.c_str());
+                ImGui::EndTooltip();
+            }
+            ImGui::NextColumn();
+            ImGui::Text("%d - %d", summary.mFirstFrame, summary.mLastFrame);
+            ImGui::NextColumn();
+            ImGui::Text("%zu", summary.mBoxes);
+            ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+        ImGui::EndChild();
+        ImGui::EndTabItem();
+    }
+
+    void ToolsPanel::DatasetExport(float lineHeight)
+    {
+        DatasetStats stats = mDatasetExporter.GetStats();
+        ImGui::BeginDisabled(stats.mRunning || !mProject->IsProjectLoaded());
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, lineHeight * 6);
+
+        ImGui::Text("Labels: ");
+        ImGui::NextColumn();
+        ImGui::Checkbox("YOLO##Dataset", &mDatasetOptions.mYOLO);
+        ImGui::SameLine();
+        ImGui::Checkbox("COCO##Dataset", &mDatasetOptions.mCOCO);
+        ImGui::NextColumn();
+
+        ImGui::Text("Format: ");
+        ImGui::NextColumn();
+        const char* formats[] = { "JPEG", "PNG" };
+        int format = static_cast<int>(mDatasetOptions.mFormat);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::Combo("##Format##Dataset", &format, formats, IM_ARRAYSIZE(formats)))
+        {
+            mDatasetOptions.mFormat = static_cast<ImageFormat>(format);
+        }
+        if (mDatasetOptions.mFormat == ImageFormat::JPEG)
+        {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(lineHeight * 5);
+            int quality = 33 - mDatasetOptions.mJPEGQuality;
+            if (ImGui::SliderInt("Quality##Dataset", &quality, 2, 31))
+            {
+                mDatasetOptions.mJPEGQuality = 33 - quality;
+            }
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("Max Width: ");
+        ImGui::NextColumn();
+        int maxWidth = static_cast<int>(mDatasetOptions.mMaxWidth);
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::InputInt("##MaxWidth##Dataset", &maxWidth, 64, 256))
+        {
+            mDatasetOptions.mMaxWidth = static_cast<uint32_t>(std::max(0, maxWidth));
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("0 keeps the source size");
+        ImGui::NextColumn();
+
+        ImGui::Text("Split: ");
+        ImGui::NextColumn();
+        float valPercent = mDatasetOptions.mValFraction * 100.f;
+        ImGui::SetNextItemWidth(lineHeight * 8);
+        if (ImGui::SliderFloat("Val %##Dataset", &valPercent, 0.f, 50.f, "%.0f%%"))
+        {
+            mDatasetOptions.mValFraction = valPercent / 100.f;
+        }
+        ImGui::SameLine();
+        int seed = static_cast<int>(mDatasetOptions.mSeed);
+        ImGui::SetNextItemWidth(lineHeight * 5);
+        if (ImGui::InputInt("Seed##Dataset", &seed))
+        {
+            mDatasetOptions.mSeed = static_cast<uint32_t>(seed);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("By Video##Dataset", &mDatasetOptions.mSplitByVideo);
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+        {
+            ImGui::BeginTooltip();
+            ImGui::Text("Keeps every frame of a video in the same split, neighbouring frames are nearly identical");
+            ImGui::EndTooltip();
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("Output Folder: ");
+        ImGui::NextColumn();
+        if (mDatasetOutputBuffer[0] == '\0' && mProject->IsProjectLoaded())
+        {
+            std::string defaultDir = (mProject->GetProjectDir() / "Dataset").string();
+            std::strncpy(mDatasetOutputBuffer, defaultDir.c_str(), sizeof(mDatasetOutputBuffer) - 1);
+        }
+        ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+        ImGui::InputText("##OutputFolder##Dataset", mDatasetOutputBuffer, sizeof(mDatasetOutputBuffer));
+        ImGui::Columns(1);
+        ImGui::EndDisabled();
+
+        if (stats.mRunning)
+        {
+            if (ImGui::Button("Cancel##Dataset"))
+            {
+                mDatasetExporter.Cancel();
+            }
+        }
+        else
+        {
+            AnnotationStore& annotations = mProject->mAnnotations;
+            ImGui::BeginDisabled(annotations.GetBoxCount() == 0 || mDatasetOutputBuffer[0] == '\0'
+                || (!mDatasetOptions.mYOLO && !mDatasetOptions.mCOCO));
+            if (ImGui::Button("Export Dataset##Dataset"))
+            {
+                DatasetOptions options = mDatasetOptions;
+                options.mOutputDir = mDatasetOutputBuffer;
+                if (!mDatasetExporter.Start(annotations, options))
+                    FRAMEEX_CORE_WARN("Unable to start the dataset export to {}", options.mOutputDir.string());
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::TextDisabled("Tracks are exported once baked");
+        }
+
+        if (stats.mFramesTotal > 0)
+        {
+            uint64_t written = stats.mTrain + stats.mVal;
+            std::string overlay = std::to_string(written) + " / " + std::to_string(stats.mFramesTotal) + " Frames, "
+                + std::to_string(stats.mVideosDone) + " / " + std::to_string(stats.mVideosTotal) + " Videos";
+            ImGui::ProgressBar((float)written / stats.mFramesTotal, { -1.f, 0.f }, overlay.c_str());
+
+            double seconds = std::max(stats.mElapsedSeconds, 0.001);
+            ImGui::Text("Train: %llu  Val: %llu  Boxes: %llu  (%.1f MB in %.1f s)", stats.mTrain, stats.mVal, stats.mBoxesTotal, stats.mBytesWritten / 1048576.0, stats.mElapsedSeconds);
+            ImGui::Text("Decoded %llu frames for %llu labelled", stats.mDecodedFrames, stats.mDecode.mItems);
+            if (stats.mFailed > 0)
+                ImGui::TextColored({ 1.f, 0.4f, 0.4f, 1.f }, "Failed: %llu", stats.mFailed);
+
+            // Frames per second of wall time, and per busy second of one worker
+            auto stageText = [seconds](const char* label, const DatasetStats::Stage& stage) {
+                double perWorker = stage.mBusySeconds > 0.0 ? stage.mItems / stage.mBusySeconds : 0.0;
+                ImGui::Text("%s: %.1f frames/s (%d workers, %.1f frames/s each)", label, stage.mItems / seconds, stage.mWorkers, perWorker);
+            };
+            stageText("Decode", stats.mDecode);
+            stageText("Encode", stats.mEncode);
+            stageText("Write", stats.mWrite);
+
+            auto queueBar = [](const char* label, const ExtractStats::Queue& queue) {
+                std::string overlay = std::string(label) + " " + std::to_string(queue.mDepth) + " / " + std::to_string(queue.mCapacity) + "  (full " + std::to_string(queue.mFullWaits) + "x)";
+                ImGui::ProgressBar(queue.mCapacity ? (float)queue.mDepth / queue.mCapacity : 0.f, { -1.f, 0.f }, overlay.c_str());
+            };
+            queueBar("Decode > Encode", stats.mDecodedQueue);
+            queueBar("Encode > Write", stats.mEncodedQueue);
+        }
+    }
+
     void ToolsPanel::CountingTab(float lineHeight)
     {
         bool open_clear_popup = false;
@@ -340,6 +903,60 @@ namespace FrameExtractor
                 ImGui::Text("Export Data (.xlsx)");
                 ImGui::EndTooltip();
             }
+            ImGui::SameLine();
+
+            ScanProgress scanProgress = mScanner.GetProgress();
+            if (scanProgress.IsRunning())
+            {
+                if (ImGui::Button("Cancel Scan##Counting", { 0, lineHeight * 1.5f + ImGui::GetStyle().FramePadding.y * 2 }))
+                {
+                    mScanner.Cancel();
+                }
+            }
+            else if (ImGui::Button("Scan Videos##Counting", { 0, lineHeight * 1.5f + ImGui::GetStyle().FramePadding.y * 2 }))
+            {
+                if (!mProject->IsProjectLoaded())
+                {
+                    open_error_popup = true;
+                }
+                else
+                {
+                    std::vector<std::filesystem::path> videos(mProject->mVideosInProject.begin(), mProject->mVideosInProject.end());
+                    std::sort(videos.begin(), videos.end());
+                    mScanner.Scan(videos, mScanOptions);
+                    mScanSelection = -1;
+                }
+            }
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+            {
+                ImGui::BeginTooltip();
+                ImGui::Text("Find black, frozen and corrupted stretches in the project's videos");
+                ImGui::EndTooltip();
+            }
+            ImGui::SameLine();
+            bool packetsOnly = mScanOptions.mDepth == ScanDepth::Packets;
+            if (ImGui::Checkbox("Packets Only##Counting", &packetsOnly))
+            {
+                mScanOptions.mDepth = packetsOnly ? ScanDepth::Packets : ScanDepth::Full;
+            }
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+            {
+                ImGui::BeginTooltip();
+                ImGui::Text("Only checks timestamps and truncation, without decoding.\nRuns at disk speed but cannot see black or frozen video.");
+                ImGui::EndTooltip();
+            }
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(lineHeight * 3);
+            float gapSeconds = static_cast<float>(mScanOptions.mGapSeconds);
+            if (ImGui::InputFloat("Gap (s)##Counting", &gapSeconds, 0.f, 0.f, "%.1f"))
+            {
+                mScanOptions.mGapSeconds = std::max(0.1f, gapSeconds);
+            }
+            if (scanProgress.mDone != mScanReports.size())
+            {
+                mScanReports = mScanner.GetReports();
+            }
+            ScanResults(lineHeight, scanProgress);
 
 
             ImGui::SetNextWindowSize({ lineHeight * 9.75f, lineHeight * 5.25f }, ImGuiCond_Always);
@@ -1196,6 +1813,23 @@ namespace FrameExtractor
                                                 idx2++;
                                             }
 
+                                            if (mScanSelection >= 0 && mScanSelection < (int)mScanReports.size())
+                                            {
+                                                ImGui::Separator();
+                                                const ScanReport& report = mScanReports[mScanSelection];
+                                                // One command for the whole report, a single undo takes it back out
+                                                if (ImGui::Button(("Accept Scan of " + report.mPath.filename().string() + "##Counting" + std::to_string(idx)).c_str()))
+                                                {
+                                                    CommandHistory::execute(std::make_unique<ModifyPropertyCommand<CountingEntrance>>(&Entrance, Entrance, ApplyScanReport(Entrance, report)));
+                                                }
+                                                if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal))
+                                                {
+                                                    ImGui::BeginTooltip();
+                                                    ImGui::Text("Blank starts and ends go to Blank Videos, other stretches and timestamp gaps to Frame Skips.\nDecode errors, timestamp disorder and truncation add the video to Corrupted Videos.");
+                                                    ImGui::EndTooltip();
+                                                }
+                                            }
+
                                             ImGui::Separator();
                                             ImGui::PushFont(ImGuiManager::BoldFont);
                                             ImGui::Text("Additional Notes");
@@ -14,6 +14,7 @@
 #include <GUI/ImGuiManager.hpp>
 #include <GUI/GuiResourcesManager.hpp>
 #include <Graphics/Video.hpp>
+#include <Graphics/FramePool.hpp>
 namespace FrameExtractor
 {
 
@@ -36,6 +37,15 @@ namespace FrameExtractor
 
     void ViewportPanel::OnImGuiRender(float dt)
     {
+        // Frame numbers, the activity index and the filmstrip wait for the
+        // built index on a first open
+        if (mVideo && mVideo->UpdateIndex())
+        {
+            mFrameNumber = (int32_t)mVideo->GetCurrentFrame();
+            DTTrack = (float)mVideo->GetPlaybackTime();
+            if (!mActivity)
+                mActivity = MakeRef<ActivityIndex>(*mVideo);
+        }
 		//ImGui::SetNextWindowSize(mViewportSize);
 		//ImGui::SetNextWindowPos(mViewportPos);
 
@@ -58,9 +68,19 @@ namespace FrameExtractor
         auto cursor = ImGui::GetCursorScreenPos();
         auto regionX = contentRegion.x * 0.85f;
         auto regionY = contentRegion.y;
+        ImVec2 imageSize(contentRegion.x * 0.85f, contentRegion.y - lineHeight * 2.5f);
+        bool imageHovered = false;
         if (mVideo)
         {
-            ImGui::Image((ImTextureID)mVideo->GetFrame()->GetTextureID(), ImVec2(contentRegion.x * 0.85f, contentRegion.y - lineHeight * 2.5f));
+            // Convert and upload only as many pixels as are shown
+            uint32_t outputWidth = mNativeResolution ? 0 : (uint32_t)std::max(imageSize.x, 1.f);
+            uint32_t outputHeight = mNativeResolution ? 0 : (uint32_t)std::max(imageSize.y, 1.f);
+            if (mVideo->SetOutputSize(outputWidth, outputHeight) && !mIsPlaying)
+            {
+                mVideo->Decode((uint32_t)mFrameNumber);
+            }
+            ImGui::Image((ImTextureID)mVideo->GetFrame()->GetTextureID(), imageSize);
+            imageHovered = ImGui::IsItemHovered();
             if (ImGui::BeginDragDropTarget()) {
                 if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ITEM_NAME")) {
                     const char* droppedItem = static_cast<const char*>(payload->Data);
@@ -155,20 +175,8 @@ namespace FrameExtractor
         {
             if (mVideo)
             {
-                int totalSeconds = mFrameNumber / mVideo->GetFPS();
-                int frames = mFrameNumber % mVideo->GetFPS();
-                int seconds = totalSeconds % 60;
-                int minutes = (totalSeconds / 60) % 60;
-                int hours = totalSeconds / 3600;
-
-                std::ostringstream oss;
-                oss << std::setfill('0')
-                    << std::setw(2) << hours << ":"
-                    << std::setw(2) << minutes << ":"
-                    << std::setw(2) << seconds << ":"
-                    << std::setw(2) << frames;
-
-                ImGui::Text(oss.str().c_str());
+                std::string timecode = mVideo->GetTimecode((uint32_t)mFrameNumber);
+                ImGui::Text(timecode.c_str());
             }
             else
             {
@@ -180,23 +188,12 @@ namespace FrameExtractor
         {
             if(mVideo)
             {
-                int totalSeconds = (mVideo->GetMaxFrames() - 1) / mVideo->GetFPS();
-                int frames = (mVideo->GetMaxFrames() - 1) % mVideo->GetFPS();
-                int seconds = totalSeconds % 60;
-                int minutes = (totalSeconds / 60) % 60;
-                int hours = totalSeconds / 3600;
-
-                std::ostringstream oss;
-                oss << std::setfill('0')
-                    << std::setw(2) << hours << ":"
-                    << std::setw(2) << minutes << ":"
-                    << std::setw(2) << seconds << ":"
-                    << std::setw(2) << frames;
-
-                ImGui::SetNextItemWidth(ImGui::CalcTextSize(oss.str().c_str()).x);
-                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetContentRegionAvail().x - ImGui::CalcTextSize(oss.str().c_str()).x));
-
-                ImGui::Text(oss.str().c_str());
+                std::string timecode = mVideo->GetTimecode(mVideo->GetMaxFrames() - 1);
+
+                ImGui::SetNextItemWidth(ImGui::CalcTextSize(timecode.c_str()).x);
+                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (ImGui::GetContentRegionAvail().x - ImGui::CalcTextSize(timecode.c_str()).x));
+
+                ImGui::Text(timecode.c_str());
             }
             else
             {
@@ -235,12 +232,12 @@ namespace FrameExtractor
                     auto currentTime = std::chrono::high_resolution_clock::now();
                     if ((uint32_t)mFrameNumber < mVideo->GetMaxFrames())
                     {
-                        if (mSpeedMultiplier < 50 && mSpeedMultiplier > 0)
-                            mVideo->DecodeTime(dt, mSpeedMultiplier);
-                        else
-                            mVideo->Decode(mFrameNumber);
-                        DTTrack += dt * mSpeedMultiplier;
-                        mFrameNumber = (int)(DTTrack * mVideo->GetFPS());
+                        // Frames come from the decode thread, the video owns the clock.
+                        // Reverse speeds are decoded a GOP at a time and played backwards,
+                        // high speeds in either direction only show keyframes.
+                        mVideo->DecodeTime(dt, mSpeedMultiplier);
+                        DTTrack = (float)mVideo->GetPlaybackTime();
+                        mFrameNumber = (int32_t)mVideo->GetCurrentFrame();
                         if ((uint32_t)mFrameNumber >= mVideo->GetMaxFrames())
                         {
                             mFrameNumber = mVideo->GetMaxFrames() - 1;
@@ -278,14 +275,16 @@ namespace FrameExtractor
 
             draw_list->AddLine(ImVec2(x, y1), ImVec2(x, y2), IM_COL32(200, 200, 200, 255));
         }
+        DrawActivityHeatmap(slider_pos, slider_size);
 
         if (mVideo)
         {
             if (ImGui::IsItemDeactivatedAfterEdit()) {
                 initialIn = false;
                 mIsPlaying = wasPlaying;
-                DTTrack = (float)mFrameNumber / mVideo->GetFPS();
+                DTTrack = (float)mVideo->GetFrameTime((uint32_t)mFrameNumber);
             }
+            DrawFilmstrip(slider_width);
         }
 
         ImGui::Spacing();
@@ -377,7 +376,7 @@ namespace FrameExtractor
                 if(mVideo)
                 {
                     CommandHistory::execute(std::make_unique<PlayCommand>(&mIsPlaying, &mFrameNumber, mFrameNumber, mVideo));
-                    DTTrack = (float)mFrameNumber / mVideo->GetFPS();
+                    DTTrack = (float)mVideo->GetFrameTime((uint32_t)mFrameNumber);
                 }
             }
         }
@@ -476,10 +475,24 @@ namespace FrameExtractor
             ImGui::EndTooltip();
         }
 
+        if (mVideo && isWindowFocused && shiftHeld)
+        {
+            if (ImGui::IsKeyPressed(ImGuiKey_RightArrow))
+                JumpToActivity(true);
+            else if (ImGui::IsKeyPressed(ImGuiKey_LeftArrow))
+                JumpToActivity(false);
+        }
+
         std::string statusText;
 
 
-        if (mSpeedMultiplier > 0)
+        if (mSpeedMultiplier > 0 && mVideo && mIsPlaying && mAdaptiveSpeed.mEnabled)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << mVideo->GetEffectiveSpeed();
+            statusText = "  Auto " + oss.str() + " x >>" + "##ViewportControl";
+        }
+        else if (mSpeedMultiplier > 0)
         {
             std::ostringstream oss;
             oss << std::fixed << std::setprecision(2) << mSpeedMultiplier;
@@ -510,21 +523,179 @@ namespace FrameExtractor
         }
 
 
-        if(mVideo)
+        if (mVideo && ImGui::CollapsingHeader("Image Adjustments##ViewportControl"))
+        {
+            bool changed = false;
+            changed |= ImGui::SliderFloat("Brightness##ViewportControl", &mColorAdjust.mBrightness, -0.5f, 0.5f, "%.2f");
+            changed |= ImGui::SliderFloat("Contrast##ViewportControl", &mColorAdjust.mContrast, 0.5f, 2.5f, "%.2f");
+            changed |= ImGui::SliderFloat("Gamma##ViewportControl", &mColorAdjust.mGamma, 0.5f, 3.0f, "%.2f");
+            ImGui::Checkbox("Native Resolution##ViewportControl", &mNativeResolution);
+            if (ImGui::Button("Reset##ViewportColorAdjust"))
+            {
+                mColorAdjust = ColorAdjust();
+                changed = true;
+            }
+            if (changed)
+            {
+                mVideo->SetColorAdjust(mColorAdjust);
+                // Playing frames pick the change up on their own
+                if (!mIsPlaying)
+                    mVideo->Decode((uint32_t)mFrameNumber);
+            }
+        }
+
+        if (mVideo && mActivity && ImGui::CollapsingHeader("Motion Activity##ViewportControl"))
+        {
+            if (mActivity->IsComplete())
+                ImGui::Text("Analysed: %u frames", mActivity->GetFrameCount());
+            else
+                ImGui::ProgressBar(mActivity->GetFrameCount() ? (float)mActivity->GetAnalysedFrames() / mActivity->GetFrameCount() : 0.f, { -1.f, 0.f }, "Analysing motion");
+            ImGui::Text("Energy Here: %u", mActivity->GetEnergy((uint32_t)mFrameNumber));
+            ImGui::SliderInt("Threshold##ViewportActivity", &mActivityThreshold, 1, 64);
+            if (ImGui::Button("Previous Activity##ViewportActivity"))
+                JumpToActivity(false);
+            ImGui::SameLine();
+            if (ImGui::Button("Next Activity##ViewportActivity"))
+                JumpToActivity(true);
+            ImGui::TextDisabled("Shift + Left / Right");
+        }
+
+        // Not a command, toggling it does not touch the undo stack
+        if (mVideo && ImGui::CollapsingHeader("Adaptive Speed##ViewportControl"))
         {
-            if (mBBCache.find(mVideo->GetPath()) != mBBCache.end())
+            bool changed = ImGui::Checkbox("Skip Static Scenes##ViewportAdaptive", &mAdaptiveSpeed.mEnabled);
+            changed |= ImGui::SliderFloat("Static Speed##ViewportAdaptive", &mAdaptiveSpeed.mHighSpeed, 2.f, 50.f, "%.0f x");
+            changed |= ImGui::SliderFloat("Look Ahead##ViewportAdaptive", &mAdaptiveSpeed.mLookAhead, 0.25f, 4.f, "%.2f s");
+            int threshold = mAdaptiveSpeed.mThreshold;
+            if (ImGui::SliderInt("Threshold##ViewportAdaptive", &threshold, 1, 64))
             {
-                if (mBBCache[mVideo->GetPath()].find(mFrameNumber) != mBBCache[mVideo->GetPath()].end())
+                mAdaptiveSpeed.mThreshold = static_cast<uint8_t>(threshold);
+                changed = true;
+            }
+            if (changed)
+                mVideo->SetAdaptiveSpeed(mAdaptiveSpeed);
+            ImGui::TextDisabled("Forward playback only");
+        }
+
+        if (mVideo && mProject && ImGui::CollapsingHeader("Labelling##ViewportControl"))
+        {
+            ImGui::SetNextItemWidth(lineHeight * 6);
+            if (ImGui::InputInt("Class##ViewportLabelling", &mLabelClass))
+            {
+                mLabelClass = std::max(0, mLabelClass);
+            }
+            ImGui::TextDisabled("Ctrl + drag draws a box, Ctrl + click selects a track");
+
+            auto tracks = mProject->mTracks.find(mVideo->GetPath());
+            const Track* track = tracks != mProject->mTracks.end() ? tracks->second.GetTrack(mSelectedTrack) : nullptr;
+            if (track)
+            {
+                ImGui::Text("Track #%u, class %u, frames %d - %d, %zu keyframes", track->mID, track->mClass, track->GetFirstFrame(), track->GetLastFrame(), track->mKeyframes.size());
+                uint32_t id = track->mID;
+                if (ImGui::Button("Set Class##ViewportLabelling"))
+                {
+                    CommandHistory::execute(std::make_shared<SetTrackClassCommand>(&tracks->second, id, (uint32_t)mLabelClass));
+                }
+                ImGui::SameLine();
+                ImGui::BeginDisabled(!track->FindKeyframe(mFrameNumber));
+                if (ImGui::Button("Delete Keyframe##ViewportLabelling"))
+                {
+                    CommandHistory::execute(std::make_shared<RemoveTrackKeyframeCommand>(&tracks->second, id, mFrameNumber));
+                }
+                ImGui::EndDisabled();
+                ImGui::SameLine();
+                if (ImGui::Button("Delete Track##ViewportLabelling"))
                 {
-                    const std::vector<BoundingBox>& boxes = mBBCache[mVideo->GetPath()][mFrameNumber];
-                    for (const auto& AABB : boxes)
+                    CommandHistory::execute(std::make_shared<RemoveTrackCommand>(&tracks->second, id));
+                    mSelectedTrack = 0;
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("New Track##ViewportLabelling"))
+                {
+                    mSelectedTrack = 0;
+                }
+
+                // Follows the track's box at this frame through the frames after it
+                // The delete buttons above may have removed the track already
+                track = tracks->second.GetTrack(id);
+                BoundingBox box;
+                bool hasBox = track && track->GetBox(mFrameNumber, box);
+                if (mTracker.IsRunning())
+                {
+                    if (ImGui::Button("Stop Tracking##ViewportLabelling"))
+                    {
+                        mTracker.Cancel();
+                    }
+                }
+                else
+                {
+                    ImGui::BeginDisabled(!hasBox);
+                    if (ImGui::Button("Track Forward##ViewportLabelling") && mTracker.Start(*mVideo, mFrameNumber, box, mTrackerOptions))
                     {
-                        ImVec2 topLeft = { cursor.x + AABB.minX / mVideo->GetWidth() * regionX, cursor.y + AABB.minY / mVideo->GetHeight() * regionY };
-                        ImVec2 bottomRight = { cursor.x + AABB.maxX / mVideo->GetWidth() * regionX, cursor.y + AABB.maxY / mVideo->GetHeight() * regionY };
-                        drawList->AddRect(topLeft, bottomRight, IM_COL32(150, 170, 23, 255), 0.0f, 0, 5.0f); // red border, 2px thick
+                        mTrackerTrack = id;
                     }
+                    ImGui::EndDisabled();
                 }
+                ImGui::SameLine();
+                int maxFrames = (int)mTrackerOptions.mMaxFrames;
+                ImGui::SetNextItemWidth(lineHeight * 5);
+                if (ImGui::InputInt("Frames##ViewportLabelling", &maxFrames, 25, 250))
+                {
+                    mTrackerOptions.mMaxFrames = (uint32_t)std::clamp(maxFrames, 1, 100000);
+                }
+                ImGui::SetNextItemWidth(lineHeight * 6);
+                ImGui::SliderFloat("Min Confidence##ViewportLabelling", &mTrackerOptions.mMinConfidence, 0.1f, 0.95f, "%.2f");
+            }
+            else
+            {
+                ImGui::Text("The next box starts a new track");
+            }
+
+            TrackerProgress progress = mTracker.GetProgress();
+            if (progress.mFramesTotal > 0)
+            {
+                std::string overlay = std::to_string(progress.mFramesTracked) + " / " + std::to_string(progress.mFramesTotal) + " Frames";
+                ImGui::ProgressBar((float)progress.mFramesTracked / progress.mFramesTotal, { -1.f, 0.f }, overlay.c_str());
+                ImGui::Text("Confidence: %.2f  Matching: %.0f box-frames/s%s", progress.mConfidence, progress.mBoxFramesPerSecond, progress.mLostTarget ? "  (lost the target)" : "");
+            }
+        }
+
+        if (mVideo && ImGui::CollapsingHeader("Playback Statistics##ViewportControl"))
+        {
+            PlaybackStats stats = mVideo->GetPlaybackStats();
+            ImGui::Text("Queue Depth: %zu / %zu", stats.mQueueDepth, stats.mQueueCapacity);
+            ImGui::Text("Decoded: %llu", stats.mDecodedFrames);
+            ImGui::Text("Presented: %llu", stats.mPresentedFrames);
+            ImGui::Text("Dropped: %llu", stats.mDroppedFrames);
+            ImGui::Text("Underruns: %llu", stats.mUnderruns);
+            ImGui::Text("Decoding: %s", stats.mKeyframesOnly ? "Keyframes Only" : "All Frames");
+            ImGui::Text("Effective Speed: %.2f x", stats.mEffectiveSpeed);
+            ImGui::Text("Conversion: %s", ColorConverter::GetPathName(mVideo->GetColorConverter().GetPath()));
+            ImGui::Text("Output: %u x %u (Source %u x %u)", mVideo->GetOutputWidth(), mVideo->GetOutputHeight(), mVideo->GetWidth(), mVideo->GetHeight());
+            ImGui::Text("UI Frame Rate: %.1f fps", ImGui::GetIO().Framerate);
+
+            FrameCacheStats cache = mVideo->GetCacheStats();
+            ImGui::Separator();
+            ImGui::Text("Cached Frames: %zu (%.1f / %.1f MB)", cache.mFrames, cache.mBytesUsed / 1048576.0, cache.mBudget / 1048576.0);
+            ImGui::Text("Cache Hits: %llu  Misses: %llu  Evictions: %llu", cache.mHits, cache.mMisses, cache.mEvictions);
+            if (ImGui::SliderInt("Frame Cache Budget (MB)##ViewportControl", &mCacheBudgetMB, 0, 4096))
+            {
+                mVideo->SetCacheBudget(static_cast<size_t>(mCacheBudgetMB) << 20);
             }
+
+            // Shared by every open video
+            FramePoolStats pool = FramePool::GetInstance().GetStats();
+            double bufferReuse = pool.mBufferRequests ? 100.0 * (1.0 - (double)pool.mBufferAllocations / pool.mBufferRequests) : 0.0;
+            double scalerReuse = pool.mScalerRequests ? 100.0 * (1.0 - (double)pool.mScalerCreations / pool.mScalerRequests) : 0.0;
+            ImGui::Separator();
+            ImGui::Text("Pooled Buffers: %.1f MB in %zu pools", pool.mBytesHeld / 1048576.0, pool.mPools);
+            ImGui::Text("Buffer Reuse: %.1f%% (%llu of %llu allocated)", bufferReuse, pool.mBufferAllocations, pool.mBufferRequests);
+            ImGui::Text("Scaler Reuse: %.1f%% (%zu idle)", scalerReuse, pool.mIdleScalers);
+        }
+
+        if (mVideo && mProject)
+        {
+            DrawLabels(cursor, imageSize, imageHovered);
         }
 
         ImGui::End();        
@@ -534,130 +705,280 @@ namespace FrameExtractor
     {
         return mName.c_str();
     }
+    float ViewportPanel::GetSpeedStep(int32_t index)
+    {
+        index = std::clamp<int32_t>(index, -SPEED_STEP_COUNT, SPEED_STEP_COUNT);
+        if (index == 0)
+            return 1.f;
+        return index > 0 ? SPEED_STEPS[index - 1] : -SPEED_STEPS[-index - 1];
+    }
     void ViewportPanel::SpeedUp()
     {
-        if (mSpeedMultiplier == 8) return;
+        if (mSpeedMultiplierIndex == SPEED_STEP_COUNT) return;
         if (++mSpeedMultiplierIndex == 0) { mSpeedMultiplierIndex = 1; }
-        switch (mSpeedMultiplierIndex)
-        {
-        case 1:
-            mSpeedMultiplier = 1.0f;
-            return;
-        case 2:
-            mSpeedMultiplier = 1.25f;
-            return;
-        case 3:
-            mSpeedMultiplier = 1.5f;
-            return;
-        case 4:
-            mSpeedMultiplier = 2.0f;
-            return;
-        case 5:
-            mSpeedMultiplier = 5.f;
-			return;
-        case 6:
-            mSpeedMultiplier = 10.0f;
-			return;
-        case 7:
-            mSpeedMultiplier = 20.0f;
-            return;
-        case 8:
-            mSpeedMultiplier = 50.0f;
-			return;
-        case -1:
-            mSpeedMultiplier = -1.0f;
-            return;
-        case -2:
-            mSpeedMultiplier = -1.25f;
-            return;
-        case -3:
-            mSpeedMultiplier = -1.5f;
-            return;
-        case -4:
-            mSpeedMultiplier = -2.0f;
-            return;
-        case -5:
-            mSpeedMultiplier = -5.f;
-            return;
-        case -6:
-            mSpeedMultiplier = -10.0f;
-            return;
-        case -7:
-            mSpeedMultiplier = -20.0f;
-            return;
-        case -8:
-            mSpeedMultiplier = -50.0f;
-            return;
-        default:
-            return;
-        }
-        
+        mSpeedMultiplier = GetSpeedStep(mSpeedMultiplierIndex);
     }
     void ViewportPanel::SlowDown()
     {
-        if (mSpeedMultiplier == -8) return;
+        if (mSpeedMultiplierIndex == -SPEED_STEP_COUNT) return;
         if (--mSpeedMultiplierIndex == 0) { mSpeedMultiplierIndex = -1; }
-        switch (mSpeedMultiplierIndex)
+        mSpeedMultiplier = GetSpeedStep(mSpeedMultiplierIndex);
+    }
+    Filmstrip* ViewportPanel::GetFilmstrip()
+    {
+        if (mVideo->IsIndexEstimated())
+            return nullptr;
+        auto it = std::find_if(mFilmstrips.begin(), mFilmstrips.end(), [this](const Ref<Filmstrip>& strip) { return strip->GetPath() == mVideo->GetPath(); });
+        if (it != mFilmstrips.end())
         {
-        case 1:
-            mSpeedMultiplier = 1.0f;
-            return;
-        case 2:
-            mSpeedMultiplier = 1.25f;
-            return;
-        case 3:
-            mSpeedMultiplier = 1.5f;
-            return;
-        case 4:
-            mSpeedMultiplier = 2.0f;
-            return;
-        case 5:
-            mSpeedMultiplier = 5.f;
-            return;
-        case 6:
-            mSpeedMultiplier = 10.0f;
-            return;
-        case 7:
-            mSpeedMultiplier = 20.0f;
+            mFilmstrips.splice(mFilmstrips.begin(), mFilmstrips, it);
+            return mFilmstrips.front().get();
+        }
+
+        mFilmstrips.push_front(MakeRef<Filmstrip>(*mVideo));
+        if (mFilmstrips.size() > MAX_FILMSTRIPS)
+            mFilmstrips.pop_back();
+        return mFilmstrips.front().get();
+    }
+
+    void ViewportPanel::DrawActivityHeatmap(ImVec2 sliderPos, ImVec2 sliderSize)
+    {
+        if (!mVideo || !mActivity || sliderSize.x <= 0.f)
             return;
-        case 8:
-            mSpeedMultiplier = 50.0f;
+
+        // Two pixel columns, each showing the busiest frame it covers
+        uint32_t bucketCount = std::max(1u, (uint32_t)(sliderSize.x / 2.f));
+        mActivity->Summarize(bucketCount, mActivityBuckets);
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        float bucketWidth = sliderSize.x / bucketCount;
+        float top = sliderPos.y + sliderSize.y * 0.5f;
+        float bottom = sliderPos.y + sliderSize.y;
+        for (uint32_t i = 0; i < bucketCount; i++)
+        {
+            uint8_t energy = mActivityBuckets[i];
+            if (energy == 0)
+                continue;
+            // Faint below the threshold, solid from twice the threshold up
+            int alpha = std::min(220, energy * 220 / std::max(1, mActivityThreshold * 2));
+            ImU32 colour = energy >= mActivityThreshold ? IM_COL32(255, 120, 20, alpha) : IM_COL32(120, 160, 255, alpha);
+            float x = sliderPos.x + i * bucketWidth;
+            drawList->AddRectFilled({ x, top }, { x + bucketWidth, bottom }, colour);
+        }
+    }
+
+    void ViewportPanel::JumpToActivity(bool forward)
+    {
+        if (!mVideo || !mActivity)
             return;
-        case -1:
-            mSpeedMultiplier = -1.0f;
+
+        uint32_t found = 0;
+        uint8_t threshold = (uint8_t)std::clamp(mActivityThreshold, 1, 255);
+        bool ok = forward ? mActivity->FindNext((uint32_t)mFrameNumber, threshold, found) : mActivity->FindPrevious((uint32_t)mFrameNumber, threshold, found);
+        if (!ok)
             return;
-        case -2:
-            mSpeedMultiplier = -1.25f;
+        CommandHistory::execute(std::make_unique<SetVideoFrameCommand>(&mFrameNumber, mFrameNumber, (int32_t)found, mVideo));
+        DTTrack = (float)mVideo->GetFrameTime(found);
+        mIsPlaying = false;
+    }
+
+    void ViewportPanel::DrawLabels(ImVec2 imagePos, ImVec2 imageSize, bool imageHovered)
+    {
+        if (mTrackerTrack && !mTracker.IsRunning())
+            ApplyTrackerResults();
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        float scaleX = imageSize.x / mVideo->GetWidth();
+        float scaleY = imageSize.y / mVideo->GetHeight();
+        auto drawBox = [&](const BoundingBox& box, ImU32 colour, float thickness, const std::string& label) {
+            ImVec2 topLeft = { imagePos.x + box.minX * scaleX, imagePos.y + box.minY * scaleY };
+            ImVec2 bottomRight = { imagePos.x + box.maxX * scaleX, imagePos.y + box.maxY * scaleY };
+            drawList->AddRect(topLeft, bottomRight, colour, 0.0f, 0, thickness);
+            drawList->AddText({ topLeft.x + 4.f, topLeft.y + 2.f }, colour, label.c_str());
+        };
+
+        // Saved and baked boxes
+        AnnotationSpan boxes = mProject->mAnnotations.GetFrame(mVideo->GetPath(), mFrameNumber);
+        for (size_t i = 0; i < boxes.mCount; i++)
+        {
+            std::string label = std::to_string(boxes.mClass[i]);
+            if (boxes.mTrack[i])
+                label += " #" + std::to_string(boxes.mTrack[i]);
+            drawBox(boxes.GetBox(i), IM_COL32(150, 170, 23, 255), 5.0f, label);
+        }
+
+        // Tracks, interpolated between their keyframes
+        std::vector<Annotation> active;
+        auto tracks = mProject->mTracks.find(mVideo->GetPath());
+        if (tracks != mProject->mTracks.end())
+            tracks->second.GetActive(mFrameNumber, active);
+        for (const auto& annotation : active)
+        {
+            bool keyframe = tracks->second.GetTrack(annotation.mTrack)->FindKeyframe(mFrameNumber) != nullptr;
+            ImU32 colour = annotation.mTrack == mSelectedTrack ? IM_COL32(255, 210, 40, 255) : IM_COL32(82, 168, 255, 255);
+            drawBox(annotation.mBox, colour, keyframe ? 4.0f : 2.0f, std::to_string(annotation.mClass) + " #" + std::to_string(annotation.mTrack));
+        }
+
+        ImGuiIO& io = ImGui::GetIO();
+        if (imageHovered && io.KeyCtrl && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+        {
+            mDrawingBox = true;
+            mDragStart = io.MousePos;
+            mIsPlaying = false;
+        }
+        if (!mDrawingBox)
             return;
-        case -3:
-            mSpeedMultiplier = -1.5f;
+
+        drawList->AddRect(mDragStart, io.MousePos, IM_COL32(255, 210, 40, 255), 0.0f, 0, 2.0f);
+        if (!ImGui::IsMouseReleased(ImGuiMouseButton_Left))
             return;
-        case -4:
-            mSpeedMultiplier = -2.0f;
+        mDrawingBox = false;
+
+        auto toVideo = [&](ImVec2 point) {
+            return ImVec2{ std::clamp((point.x - imagePos.x) / scaleX, 0.f, (float)mVideo->GetWidth()), std::clamp((point.y - imagePos.y) / scaleY, 0.f, (float)mVideo->GetHeight()) };
+        };
+        ImVec2 a = toVideo(mDragStart);
+        ImVec2 b = toVideo(io.MousePos);
+        BoundingBox box{ std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x), std::max(a.y, b.y) };
+        if ((box.maxX - box.minX) * scaleX < 4.f || (box.maxY - box.minY) * scaleY < 4.f)
+        {
+            // A click picks the smallest track under the mouse
+            mSelectedTrack = 0;
+            float smallest = FLT_MAX;
+            for (const auto& annotation : active)
+            {
+                const BoundingBox& candidate = annotation.mBox;
+                float area = (candidate.maxX - candidate.minX) * (candidate.maxY - candidate.minY);
+                if (a.x >= candidate.minX && a.x <= candidate.maxX && a.y >= candidate.minY && a.y <= candidate.maxY && area < smallest)
+                {
+                    smallest = area;
+                    mSelectedTrack = annotation.mTrack;
+                }
+            }
             return;
-        case -5:
-            mSpeedMultiplier = -5.f;
+        }
+
+        TrackModel& model = mProject->mTracks[mVideo->GetPath()];
+        if (model.GetTrack(mSelectedTrack))
+        {
+            CommandHistory::execute(std::make_shared<SetTrackKeyframesCommand>(&model, mSelectedTrack, std::vector<TrackKeyframe>{ { mFrameNumber, box } }));
             return;
-        case -6:
-            mSpeedMultiplier = -10.0f;
+        }
+        auto added = std::make_shared<AddTrackCommand>(&model, (uint32_t)mLabelClass, mFrameNumber, box);
+        CommandHistory::execute(added);
+        mSelectedTrack = added->GetID();
+    }
+
+    void ViewportPanel::ApplyTrackerResults()
+    {
+        std::vector<TrackedBox> results = mTracker.GetResults();
+        uint32_t id = mTrackerTrack;
+        mTrackerTrack = 0;
+        auto tracks = mProject->mTracks.find(mTracker.GetPath());
+        const Track* track = tracks != mProject->mTracks.end() ? tracks->second.GetTrack(id) : nullptr;
+        if (!track || results.empty())
             return;
-        case -7:
-            mSpeedMultiplier = -20.0f;
+
+        // Starting from the box the run started from, only keyframes that
+        // interpolation would miss are added
+        TrackedBox start;
+        start.mFrame = mTracker.GetStartFrame();
+        if (!track->GetBox(start.mFrame, start.mBox))
             return;
-        case -8:
-            mSpeedMultiplier = -50.0f;
+        results.insert(results.begin(), start);
+        std::vector<TrackedBox> keyframes = BoxTracker::Simplify(results, mTrackerOptions.mTolerance);
+        std::vector<TrackKeyframe> added;
+        for (size_t i = 1; i < keyframes.size(); i++)
+            added.push_back({ keyframes[i].mFrame, keyframes[i].mBox });
+        CommandHistory::execute(std::make_shared<SetTrackKeyframesCommand>(&tracks->second, id, std::move(added)));
+        APP_CORE_INFO("Tracked #{} over {} frames with {} keyframes", id, results.size() - 1, keyframes.size() - 1);
+    }
+
+    void ViewportPanel::DrawFilmstrip(float width)
+    {
+        Filmstrip* strip = GetFilmstrip();
+        if (!strip)
             return;
-        default:
+        strip->Update();
+        if (strip->GetSampleCount() == 0 || width <= 0.f)
             return;
+
+        float height = 40.f * ImGuiManager::styleMultiplier;
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::InvisibleButton("##Filmstrip", { width, height });
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(origin, { origin.x + width, origin.y + height }, IM_COL32(20, 20, 20, 255));
+
+        // As many cells as fit at the samples' aspect ratio, each shows the
+        // sample under its centre
+        uint32_t samples = strip->GetSampleCount();
+        int cells = std::max(1, (int)(width / (height * strip->GetAspectRatio())));
+        float cellWidth = width / cells;
+        ImTextureID atlas = (ImTextureID)strip->GetTexture()->GetTextureID();
+        for (int cell = 0; cell < cells; cell++)
+        {
+            uint32_t slot = std::min(samples - 1, (uint32_t)((cell + 0.5f) / cells * samples));
+            if (const Filmstrip::Sample* sample = strip->GetSample(slot))
+            {
+                ImVec2 min = { origin.x + cell * cellWidth, origin.y };
+                drawList->AddImage(atlas, min, { min.x + cellWidth - 1.f, origin.y + height }, { sample->mU0, sample->mV0 }, { sample->mU1, sample->mV1 });
+            }
+        }
+
+        float position = mVideo->GetMaxFrames() > 1 ? (float)mFrameNumber / (mVideo->GetMaxFrames() - 1) : 0.f;
+        drawList->AddLine({ origin.x + position * width, origin.y }, { origin.x + position * width, origin.y + height }, IM_COL32(255, 60, 60, 255), 2.f);
+
+        if (ImGui::IsItemHovered())
+        {
+            float t = std::clamp((ImGui::GetMousePos().x - origin.x) / width, 0.f, 1.f);
+            const Filmstrip::Sample* sample = strip->GetSample(std::min(samples - 1, (uint32_t)(t * samples)));
+            if (sample)
+            {
+                // Straight from the atlas, the main decoder is left alone
+                float previewWidth = Filmstrip::SAMPLE_WIDTH * ImGuiManager::styleMultiplier;
+                ImGui::BeginTooltip();
+                ImGui::Image(atlas, { previewWidth, previewWidth / strip->GetAspectRatio() }, { sample->mU0, sample->mV0 }, { sample->mU1, sample->mV1 });
+                ImGui::Text("%s  (frame %u)", mVideo->GetTimecode(sample->mFrame).c_str(), sample->mFrame);
+                if (strip->GetReadyCount() < samples)
+                    ImGui::TextDisabled("Sampling %u / %u", strip->GetReadyCount(), samples);
+                ImGui::EndTooltip();
+
+                if (ImGui::IsItemClicked(ImGuiMouseButton_Left))
+                {
+                    CommandHistory::execute(std::make_unique<SetVideoFrameCommand>(&mFrameNumber, mFrameNumber, (int32_t)sample->mFrame, mVideo));
+                    DTTrack = (float)mVideo->GetFrameTime(sample->mFrame);
+                    mIsPlaying = false;
+                }
+            }
         }
     }
+
     void ViewportPanel::SetVideo(std::filesystem::path path)
     {
+        mActivity.reset();
         if (mVideo)
             delete mVideo;
         mVideo = new Video(path);
-        mVideo->DecodeTime(1.0f/60, mSpeedMultiplier);
+        // Analysed once in the background, later opens read the sidecar
+        if (!mVideo->IsIndexEstimated())
+            mActivity = MakeRef<ActivityIndex>(*mVideo);
+        mVideo->SetCacheBudget(static_cast<size_t>(mCacheBudgetMB) << 20);
+        mVideo->SetColorAdjust(mColorAdjust);
+        mVideo->SetAdaptiveSpeed(mAdaptiveSpeed);
+        mVideo->Decode(0);
         DTTrack = 0.f;
         mFrameNumber = 0;
     }
+
+    void ViewportPanel::OpenAt(const std::filesystem::path& path, uint32_t frameNumber)
+    {
+        if (!mVideo || mVideo->GetPath() != path)
+            SetVideo(path);
+        if (mVideo->GetMaxFrames() == 0)
+            return;
+        mIsPlaying = false;
+        mFrameNumber = (int32_t)std::min(frameNumber, mVideo->GetMaxFrames() - 1);
+        mVideo->Decode((uint32_t)mFrameNumber);
+        DTTrack = (float)mVideo->GetFrameTime((uint32_t)mFrameNumber);
+        ImGui::SetWindowFocus(mName.c_str());
+    }
 }
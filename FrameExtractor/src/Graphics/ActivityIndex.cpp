@@ -0,0 +1,268 @@
+/******************************************************************************
+/*!
+\file       ActivityIndex.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Activity Index class, a per frame motion energy track
+			of a video built in the background and kept in a sidecar file.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/ActivityIndex.hpp>
+#include <Graphics/Video.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRAMEEX_X86
+#include <emmintrin.h>
+#endif
+
+namespace FrameExtractor
+{
+	static constexpr uint32_t ACTIVITY_MAGIC = 0x41585246; // "FRXA"
+	static constexpr uint32_t ACTIVITY_VERSION = 1;
+
+	struct ActivityHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint64_t mFileSize;
+		int64_t mWriteTime;
+		uint32_t mGridWidth;
+		uint32_t mGridHeight;
+		uint32_t mEnergyScale;
+		uint32_t mCount;
+	};
+
+	static int64_t GetWriteTime(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		auto time = std::filesystem::last_write_time(path, ec);
+		return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+	}
+
+	ActivityIndex::ActivityIndex(const Video& video) : mPath(video.GetPath()), mIndex(video.GetIndex())
+	{
+		mEnergy.resize(mIndex.GetFrameCount(), 0);
+		if (Load())
+		{
+			mAnalysed = GetFrameCount();
+			mComplete = true;
+			return;
+		}
+		if (!mIndex.IsEmpty())
+			mThread = std::thread(&ActivityIndex::AnalyseLoop, this);
+	}
+
+	ActivityIndex::~ActivityIndex()
+	{
+		mStop = true;
+		if (mThread.joinable())
+			mThread.join();
+	}
+
+	std::filesystem::path ActivityIndex::GetSidecarPath(const std::filesystem::path& videoPath)
+	{
+		std::filesystem::path sidecar = videoPath;
+		sidecar += ".frexact";
+		return sidecar;
+	}
+
+	uint32_t ActivityIndex::SumAbsDiff(const uint8_t* a, const uint8_t* b, size_t size)
+	{
+		uint32_t sum = 0;
+		size_t i = 0;
+#ifdef FRAMEEX_X86
+		// SSE2 is part of x64, no dispatch needed. Each PSADBW sums 8 bytes per lane.
+		__m128i total = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			total = _mm_add_epi64(total, _mm_sad_epu8(va, vb));
+		}
+		sum = static_cast<uint32_t>(_mm_cvtsi128_si32(total)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(total, total)));
+#endif
+		for (; i < size; i++)
+			sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+		return sum;
+	}
+
+	uint8_t ActivityIndex::GetEnergy(uint32_t frameIndex) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return frameIndex < mEnergy.size() ? mEnergy[frameIndex] : 0;
+	}
+
+	void ActivityIndex::Summarize(uint32_t bucketCount, std::vector<uint8_t>& buckets) const
+	{
+		buckets.assign(bucketCount, 0);
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mEnergy.empty() || bucketCount == 0)
+			return;
+		for (size_t i = 0; i < mEnergy.size(); i++)
+		{
+			size_t bucket = i * bucketCount / mEnergy.size();
+			buckets[bucket] = std::max(buckets[bucket], mEnergy[i]);
+		}
+	}
+
+	bool ActivityIndex::IsActive(uint32_t frameIndex, uint8_t threshold) const
+	{
+		// Part of a run of at least MIN_ACTIVE_RUN frames above the threshold
+		if (frameIndex >= mEnergy.size() || mEnergy[frameIndex] < threshold)
+			return false;
+		uint32_t begin = frameIndex;
+		while (begin > 0 && frameIndex - begin + 1 < MIN_ACTIVE_RUN && mEnergy[begin - 1] >= threshold)
+			begin--;
+		uint32_t end = frameIndex + 1;
+		while (end < mEnergy.size() && end - begin < MIN_ACTIVE_RUN && mEnergy[end] >= threshold)
+			end++;
+		return end - begin >= MIN_ACTIVE_RUN;
+	}
+
+	bool ActivityIndex::FindNext(uint32_t frameIndex, uint8_t threshold, uint32_t& found) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		uint32_t count = static_cast<uint32_t>(mEnergy.size());
+		uint32_t i = frameIndex;
+		while (i < count && IsActive(i, threshold))
+			i++;
+		for (; i < count; i++)
+		{
+			if (IsActive(i, threshold))
+			{
+				found = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ActivityIndex::FindPrevious(uint32_t frameIndex, uint8_t threshold, uint32_t& found) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (frameIndex == 0 || mEnergy.empty())
+			return false;
+		int64_t i = std::min<int64_t>(frameIndex, mEnergy.size() - 1);
+		// Leave the run we are in, then the quiet stretch before it
+		while (i >= 0 && IsActive(static_cast<uint32_t>(i), threshold))
+			i--;
+		while (i >= 0 && !IsActive(static_cast<uint32_t>(i), threshold))
+			i--;
+		if (i < 0)
+			return false;
+		while (i > 0 && IsActive(static_cast<uint32_t>(i - 1), threshold))
+			i--;
+		found = static_cast<uint32_t>(i);
+		return true;
+	}
+
+	bool ActivityIndex::Load()
+	{
+		std::ifstream file(GetSidecarPath(mPath), std::ios::binary);
+		if (!file)
+			return false;
+
+		ActivityHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		std::error_code ec;
+		if (!file || header.mMagic != ACTIVITY_MAGIC || header.mVersion != ACTIVITY_VERSION
+			|| header.mGridWidth != GRID_WIDTH || header.mGridHeight != GRID_HEIGHT || header.mEnergyScale != ENERGY_SCALE
+			|| header.mCount != GetFrameCount())
+			return false;
+		if (header.mFileSize != std::filesystem::file_size(mPath, ec) || header.mWriteTime != GetWriteTime(mPath))
+			return false;
+
+		std::vector<uint8_t> energy(header.mCount);
+		file.read(reinterpret_cast<char*>(energy.data()), energy.size());
+		if (!file)
+			return false;
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEnergy = std::move(energy);
+		return true;
+	}
+
+	bool ActivityIndex::Save() const
+	{
+		std::ofstream file(GetSidecarPath(mPath), std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			FRAMEEX_CORE_WARN("Unable to write activity index for {}", mPath.string());
+			return false;
+		}
+
+		std::error_code ec;
+		ActivityHeader header{};
+		header.mMagic = ACTIVITY_MAGIC;
+		header.mVersion = ACTIVITY_VERSION;
+		header.mFileSize = std::filesystem::file_size(mPath, ec);
+		header.mWriteTime = GetWriteTime(mPath);
+		header.mGridWidth = GRID_WIDTH;
+		header.mGridHeight = GRID_HEIGHT;
+		header.mEnergyScale = ENERGY_SCALE;
+		std::lock_guard<std::mutex> lock(mMutex);
+		header.mCount = static_cast<uint32_t>(mEnergy.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(mEnergy.data()), mEnergy.size());
+		return static_cast<bool>(file);
+	}
+
+	void ActivityIndex::AnalyseLoop()
+	{
+		// Playback and scrubbing come first, the index fills in when they leave time
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+		DecodeSession session;
+		if (!session.Open(mPath, DecodePolicy::For(DecodeUseCase::Background), false))
+		{
+			FRAMEEX_CORE_WARN("Activity: unable to decode {}: {}", mPath.string(), session.GetError());
+			return;
+		}
+
+		AVFrame* frame = av_frame_alloc();
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = nullptr;
+		std::vector<uint8_t> grid(GRID_WIDTH * GRID_HEIGHT);
+		std::vector<uint8_t> previous(GRID_WIDTH * GRID_HEIGHT);
+		bool hasPrevious = false;
+
+		int ret = 0;
+		while (!mStop && (ret = session.ReceiveFrame(frame)) == 0)
+		{
+			// The grid only needs luma, GRAY8 makes swscale skip the chroma planes
+			if (!scaler)
+				scaler = pool.AcquireScaler(frame->width, frame->height, frame->format, GRID_WIDTH, GRID_HEIGHT, AV_PIX_FMT_GRAY8, SWS_AREA);
+			if (!scaler)
+				break;
+			uint8_t* dstData[4] = { grid.data() };
+			int dstLinesize[4] = { static_cast<int>(GRID_WIDTH) };
+			sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+
+			uint32_t frameIndex = mIndex.FindFrame(DecodeSession::GetPTS(frame));
+			uint32_t energy = 0;
+			if (hasPrevious)
+				energy = std::min<uint32_t>(255, SumAbsDiff(grid.data(), previous.data(), grid.size()) * ENERGY_SCALE / static_cast<uint32_t>(grid.size()));
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (frameIndex < mEnergy.size())
+					mEnergy[frameIndex] = static_cast<uint8_t>(energy);
+			}
+			grid.swap(previous);
+			hasPrevious = true;
+			mAnalysed++;
+			av_frame_unref(frame);
+		}
+		mComplete = ret == AVERROR_EOF;
+		if (session.GetDecodeErrors() > 0)
+			FRAMEEX_CORE_WARN("Activity: {} damaged frames skipped in {}", session.GetDecodeErrors(), mPath.string());
+
+		pool.ReleaseScaler(scaler);
+		av_frame_free(&frame);
+
+		if (mComplete)
+			Save();
+	}
+}
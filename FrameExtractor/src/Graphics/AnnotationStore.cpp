@@ -0,0 +1,373 @@
+/******************************************************************************
+/*!
+\file       AnnotationStore.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Annotation Store class, the per project bounding
+			boxes kept column by column and memory mapped on load.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/AnnotationStore.hpp>
+
+namespace FrameExtractor
+{
+	static constexpr uint32_t STORE_MAGIC = 0x4C585246; // "FRXL"
+	static constexpr uint32_t STORE_VERSION = 1;
+
+	// Header, the video records, the six box columns, the frame offsets of
+	// every video one after another, then the path strings
+	struct StoreHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint64_t mVideoCount;
+		uint64_t mBoxCount;
+		uint64_t mOffsetCount;
+		uint64_t mPathBytes;
+	};
+
+	struct AnnotationStore::VideoRecord
+	{
+		uint64_t mPathOffset;
+		uint64_t mPathLength;
+		uint64_t mOffsetsStart; // Index of the video's first entry in the offset column
+		int32_t mFirstFrame;
+		uint32_t mFrameCount;
+	};
+
+	void AnnotationStore::Columns::Append(const AnnotationSpan& span)
+	{
+		mMinX.insert(mMinX.end(), span.mMinX, span.mMinX + span.mCount);
+		mMinY.insert(mMinY.end(), span.mMinY, span.mMinY + span.mCount);
+		mMaxX.insert(mMaxX.end(), span.mMaxX, span.mMaxX + span.mCount);
+		mMaxY.insert(mMaxY.end(), span.mMaxY, span.mMaxY + span.mCount);
+		mClass.insert(mClass.end(), span.mClass, span.mClass + span.mCount);
+		mTrack.insert(mTrack.end(), span.mTrack, span.mTrack + span.mCount);
+	}
+
+	AnnotationSpan AnnotationStore::Columns::GetSpan(size_t begin, size_t end) const
+	{
+		end = std::min(end, Size());
+		if (begin >= end)
+			return {};
+		return { mMinX.data() + begin, mMinY.data() + begin, mMaxX.data() + begin, mMaxY.data() + begin, mClass.data() + begin, mTrack.data() + begin, end - begin };
+	}
+
+	std::filesystem::path AnnotationStore::GetStoreFile(const std::filesystem::path& projectDir)
+	{
+		return projectDir / "Annotations.frexann";
+	}
+
+	std::string AnnotationStore::MakeKey(const std::filesystem::path& video)
+	{
+		std::error_code ec;
+		std::filesystem::path absolute = std::filesystem::absolute(video, ec);
+		return (ec ? video : absolute).lexically_normal().generic_string();
+	}
+
+	bool AnnotationStore::Open(const std::filesystem::path& storeFile)
+	{
+		Close();
+		mPath = storeFile;
+		return Map();
+	}
+
+	bool AnnotationStore::Map()
+	{
+		const std::filesystem::path& storeFile = mPath;
+		std::error_code ec;
+		if (!std::filesystem::exists(storeFile, ec))
+			return true;
+		if (!mFile.Open(storeFile))
+			return false;
+
+		const uint8_t* data = mFile.GetData();
+		size_t size = mFile.GetSize();
+		const StoreHeader* header = reinterpret_cast<const StoreHeader*>(data);
+		if (size < sizeof(StoreHeader) || header->mMagic != STORE_MAGIC || header->mVersion != STORE_VERSION
+			|| header->mVideoCount > size / sizeof(VideoRecord) || header->mBoxCount > size / 4 || header->mOffsetCount > size / 4
+			|| sizeof(StoreHeader) + header->mVideoCount * sizeof(VideoRecord) + (header->mBoxCount * 6 + header->mOffsetCount) * 4 + header->mPathBytes != size)
+		{
+			FRAMEEX_CORE_WARN("Ignoring annotation store {}, it is from another version or damaged", storeFile.string());
+			mFile.Close();
+			return false;
+		}
+
+		const VideoRecord* records = reinterpret_cast<const VideoRecord*>(data + sizeof(StoreHeader));
+		const uint8_t* columns = data + sizeof(StoreHeader) + header->mVideoCount * sizeof(VideoRecord);
+		size_t columnBytes = header->mBoxCount * sizeof(float);
+		mMinX = reinterpret_cast<const float*>(columns);
+		mMinY = reinterpret_cast<const float*>(columns + columnBytes);
+		mMaxX = reinterpret_cast<const float*>(columns + columnBytes * 2);
+		mMaxY = reinterpret_cast<const float*>(columns + columnBytes * 3);
+		mClass = reinterpret_cast<const uint32_t*>(columns + columnBytes * 4);
+		mTrack = reinterpret_cast<const uint32_t*>(columns + columnBytes * 5);
+		const uint32_t* offsets = reinterpret_cast<const uint32_t*>(columns + columnBytes * 6);
+
+		mVideos.reserve(header->mVideoCount);
+		for (uint64_t i = 0; i < header->mVideoCount; i++)
+		{
+			const VideoRecord& record = records[i];
+			if (record.mPathOffset + record.mPathLength > size || record.mOffsetsStart + record.mFrameCount + 1 > header->mOffsetCount)
+				continue;
+			// Offsets must climb within the box columns or a lookup could read past them
+			const uint32_t* videoOffsets = offsets + record.mOffsetsStart;
+			bool valid = videoOffsets[record.mFrameCount] <= header->mBoxCount;
+			for (uint32_t frame = 0; valid && frame < record.mFrameCount; frame++)
+				valid = videoOffsets[frame] <= videoOffsets[frame + 1];
+			if (!valid)
+				continue;
+
+			std::string_view key(reinterpret_cast<const char*>(data + record.mPathOffset), record.mPathLength);
+			mVideos[key] = { record.mFirstFrame, record.mFrameCount, videoOffsets };
+			// Summaries kept through a failed Save already cover the file
+			auto [entry, inserted] = mSummaries.try_emplace(std::string(key));
+			if (!inserted)
+				continue;
+			VideoSummary& summary = entry->second;
+			summary.mVideo = key;
+			summary.mFirstFrame = record.mFirstFrame;
+			summary.mLastFrame = record.mFirstFrame + static_cast<int32_t>(record.mFrameCount) - 1;
+			summary.mBoxes = videoOffsets[record.mFrameCount] - videoOffsets[0];
+		}
+		return true;
+	}
+
+	void AnnotationStore::Close()
+	{
+		Unmap();
+		mEdited.clear();
+		mSummaries.clear();
+		mPath.clear();
+	}
+
+	void AnnotationStore::Unmap()
+	{
+		mVideos.clear();
+		mFile.Close();
+		mMinX = mMinY = mMaxX = mMaxY = nullptr;
+		mClass = mTrack = nullptr;
+	}
+
+	AnnotationSpan AnnotationStore::GetMappedFrame(const MappedVideo& video, int32_t frame) const
+	{
+		int64_t index = static_cast<int64_t>(frame) - video.mFirstFrame;
+		if (index < 0 || index >= video.mFrameCount)
+			return {};
+		uint32_t begin = video.mOffsets[index];
+		uint32_t end = video.mOffsets[index + 1];
+		return { mMinX + begin, mMinY + begin, mMaxX + begin, mMaxY + begin, mClass + begin, mTrack + begin, end - begin };
+	}
+
+	AnnotationSpan AnnotationStore::GetFrame(const std::filesystem::path& video, int32_t frame) const
+	{
+		if (mVideos.empty() && mEdited.empty())
+			return {};
+
+		std::string key = MakeKey(video);
+		auto edited = mEdited.find(key);
+		if (edited != mEdited.end())
+		{
+			auto it = edited->second.find(frame);
+			if (it != edited->second.end())
+				return it->second.GetSpan();
+		}
+		auto mapped = mVideos.find(key);
+		return mapped != mVideos.end() ? GetMappedFrame(mapped->second, frame) : AnnotationSpan{};
+	}
+
+	void AnnotationStore::Query(const std::filesystem::path& video, int32_t first, int32_t last, const std::function<void(int32_t, const AnnotationSpan&)>& visit) const
+	{
+		std::string key = MakeKey(video);
+		auto mapped = mVideos.find(key);
+		auto edited = mEdited.find(key);
+		const std::map<int32_t, Columns>* edits = edited != mEdited.end() ? &edited->second : nullptr;
+		std::map<int32_t, Columns>::const_iterator next;
+		if (edits)
+			next = edits->lower_bound(first);
+
+		// Edited frames before f are visited first, an edited f replaces the mapped one
+		auto visitEditsBefore = [&](int64_t f) {
+			for (; edits && next != edits->end() && next->first < f && next->first <= last; ++next)
+			{
+				if (next->second.Size() > 0)
+					visit(next->first, next->second.GetSpan());
+			}
+		};
+
+		if (mapped != mVideos.end())
+		{
+			const MappedVideo& v = mapped->second;
+			int64_t begin = std::max<int64_t>(first, v.mFirstFrame);
+			int64_t end = std::min<int64_t>(last, static_cast<int64_t>(v.mFirstFrame) + v.mFrameCount - 1);
+			for (int64_t f = begin; f <= end; f++)
+			{
+				visitEditsBefore(f);
+				if (edits && next != edits->end() && next->first == f)
+				{
+					if (next->second.Size() > 0)
+						visit(next->first, next->second.GetSpan());
+					++next;
+					continue;
+				}
+				AnnotationSpan span = GetMappedFrame(v, static_cast<int32_t>(f));
+				if (span.mCount > 0)
+					visit(static_cast<int32_t>(f), span);
+			}
+		}
+		visitEditsBefore(static_cast<int64_t>(last) + 1);
+	}
+
+	void AnnotationStore::SetFrame(const std::filesystem::path& video, int32_t frame, const std::vector<Annotation>& boxes)
+	{
+		std::string key = MakeKey(video);
+		size_t previous = GetFrame(video, frame).mCount;
+
+		Columns& columns = mEdited[key][frame];
+		columns = {};
+		for (const auto& box : boxes)
+		{
+			columns.mMinX.push_back(box.mBox.minX);
+			columns.mMinY.push_back(box.mBox.minY);
+			columns.mMaxX.push_back(box.mBox.maxX);
+			columns.mMaxY.push_back(box.mBox.maxY);
+			columns.mClass.push_back(box.mClass);
+			columns.mTrack.push_back(box.mTrack);
+		}
+
+		auto [it, added] = mSummaries.try_emplace(key);
+		VideoSummary& summary = it->second;
+		if (added)
+		{
+			summary.mVideo = key;
+			summary.mFirstFrame = frame;
+			summary.mLastFrame = frame;
+		}
+		if (!boxes.empty())
+		{
+			summary.mFirstFrame = std::min(summary.mFirstFrame, frame);
+			summary.mLastFrame = std::max(summary.mLastFrame, frame);
+		}
+		summary.mBoxes = summary.mBoxes - previous + boxes.size();
+	}
+
+	size_t AnnotationStore::GetBoxCount() const
+	{
+		size_t count = 0;
+		for (const auto& [key, summary] : mSummaries)
+			count += summary.mBoxes;
+		return count;
+	}
+
+	std::vector<AnnotationStore::VideoSummary> AnnotationStore::GetSummaries() const
+	{
+		std::vector<VideoSummary> summaries;
+		summaries.reserve(mSummaries.size());
+		for (const auto& [key, summary] : mSummaries)
+		{
+			if (summary.mBoxes > 0)
+				summaries.push_back(summary);
+		}
+		return summaries;
+	}
+
+	bool AnnotationStore::Save()
+	{
+		if (mPath.empty())
+			return false;
+
+		// Gathered into fresh columns while the old ones are still mapped
+		Columns boxes;
+		std::vector<uint32_t> offsets;
+		std::vector<VideoRecord> records;
+		std::string paths;
+		for (const auto& [key, summary] : mSummaries)
+		{
+			size_t videoStart = boxes.Size();
+			std::vector<std::pair<int32_t, size_t>> frames; // Frame, end of its boxes
+			Query(key, INT32_MIN, INT32_MAX, [&](int32_t frame, const AnnotationSpan& span) {
+				boxes.Append(span);
+				frames.emplace_back(frame, boxes.Size());
+			});
+			if (frames.empty())
+				continue;
+			if (boxes.Size() > UINT32_MAX)
+			{
+				FRAMEEX_CORE_ERROR("Unable to save annotation store {}, too many boxes", mPath.string());
+				return false;
+			}
+
+			VideoRecord record{};
+			record.mPathOffset = paths.size();
+			record.mPathLength = key.size();
+			record.mOffsetsStart = offsets.size();
+			record.mFirstFrame = frames.front().first;
+			record.mFrameCount = static_cast<uint32_t>(static_cast<int64_t>(frames.back().first) - frames.front().first + 1);
+			paths += key;
+
+			// Frames without boxes repeat the offset before them
+			uint32_t offset = static_cast<uint32_t>(videoStart);
+			offsets.push_back(offset);
+			size_t next = 0;
+			for (int64_t frame = record.mFirstFrame; frame < static_cast<int64_t>(record.mFirstFrame) + record.mFrameCount; frame++)
+			{
+				if (next < frames.size() && frames[next].first == frame)
+					offset = static_cast<uint32_t>(frames[next++].second);
+				offsets.push_back(offset);
+			}
+			records.push_back(record);
+		}
+
+		std::filesystem::path path = mPath;
+		uint64_t pathsStart = sizeof(StoreHeader) + records.size() * sizeof(VideoRecord) + boxes.Size() * 6 * sizeof(uint32_t) + offsets.size() * sizeof(uint32_t);
+		for (auto& record : records)
+			record.mPathOffset += pathsStart;
+
+		std::filesystem::path temporary = path;
+		temporary += ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				FRAMEEX_CORE_WARN("Unable to write annotation store {}", path.string());
+				return false;
+			}
+			StoreHeader header{ STORE_MAGIC, STORE_VERSION, records.size(), boxes.Size(), offsets.size(), paths.size() };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(VideoRecord));
+			for (const auto* column : { &boxes.mMinX, &boxes.mMinY, &boxes.mMaxX, &boxes.mMaxY })
+				file.write(reinterpret_cast<const char*>(column->data()), column->size() * sizeof(float));
+			for (const auto* column : { &boxes.mClass, &boxes.mTrack, &offsets })
+				file.write(reinterpret_cast<const char*>(column->data()), column->size() * sizeof(uint32_t));
+			file.write(paths.data(), paths.size());
+			if (!file)
+			{
+				FRAMEEX_CORE_WARN("Unable to write annotation store {}", path.string());
+				file.close();
+				std::error_code ec;
+				std::filesystem::remove(temporary, ec);
+				return false;
+			}
+		}
+
+		// The mapping has to be closed before the file is replaced, the edits
+		// are kept until it has been
+		Unmap();
+		std::error_code ec;
+		std::filesystem::rename(temporary, path, ec);
+		if (ec)
+		{
+			FRAMEEX_CORE_WARN("Unable to replace annotation store {}: {}", path.string(), ec.message());
+			std::error_code removeError;
+			std::filesystem::remove(temporary, removeError);
+			Map();
+			return false;
+		}
+		mEdited.clear();
+		mSummaries.clear();
+		return Map();
+	}
+}
@@ -0,0 +1,376 @@
+/******************************************************************************
+/*!
+\file       BatchExtractor.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Batch Extractor class, a pipeline that pulls selected
+			frames out of many videos and writes them as JPEG or PNG files, loose
+			or packed into one frame archive.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/BatchExtractor.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/ImageEncoder.hpp>
+#include <Graphics/VideoIndex.hpp>
+#include <fstream>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace FrameExtractor
+{
+	void BatchExtractor::FrameDeleter::operator()(AVFrame* frame) const
+	{
+		av_frame_free(&frame);
+	}
+
+	namespace
+	{
+		size_t FrameBytes(const AVFrame* frame)
+		{
+			size_t bytes = 0;
+			for (AVBufferRef* buffer : frame->buf)
+				if (buffer)
+					bytes += buffer->size;
+			return bytes;
+		}
+	}
+
+	BatchExtractor::BatchExtractor()
+		: mDecodedQueue(QUEUE_CAPACITY, QUEUE_BYTES), mConvertedQueue(QUEUE_CAPACITY, QUEUE_BYTES), mEncodedQueue(QUEUE_CAPACITY, QUEUE_BYTES)
+	{
+	}
+
+	BatchExtractor::~BatchExtractor()
+	{
+		Cancel();
+		Join();
+	}
+
+	bool BatchExtractor::Start(const std::vector<std::filesystem::path>& videos, const ExtractOptions& options)
+	{
+		if (IsRunning() || videos.empty())
+			return false;
+		Join();
+
+		std::error_code error;
+		std::filesystem::create_directories(options.mOutputDir, error);
+		if (error)
+		{
+			FRAMEEX_CORE_ERROR("BatchExtractor: unable to create {}: {}", options.mOutputDir.string(), error.message());
+			return false;
+		}
+
+		mOptions = options;
+		std::sort(mOptions.mRanges.begin(), mOptions.mRanges.end());
+		mOptions.mFrameStep = std::max(1u, mOptions.mFrameStep);
+		mOptions.mInterval = std::max(0.001, mOptions.mInterval);
+		mOptions.mJPEGQuality = std::clamp(mOptions.mJPEGQuality, 2, 31);
+		{
+			std::lock_guard<std::mutex> lock(mVideoMutex);
+			std::set<std::string> names;
+			mVideos.clear();
+			for (const auto& video : videos)
+				mVideos.push_back({ video, FrameArchive::MakeUniqueName(video, names) });
+		}
+		mDecodedQueue.Reopen();
+		mConvertedQueue.Reopen();
+		mEncodedQueue.Reopen();
+		mCancel = false;
+		mVideosDone = 0;
+		mVideosTotal = videos.size();
+		mDecoded = 0;
+		mSelected = 0;
+		mConverted = 0;
+		mEncoded = 0;
+		mWritten = 0;
+		mBytesWritten = 0;
+		mFailed = 0;
+		mElapsedMilliseconds = -1;
+		mStarted = std::chrono::steady_clock::now();
+		mArchivePath.clear();
+		if (mOptions.mOutput == ExtractOutput::Archive)
+		{
+			std::time_t now = std::time(nullptr);
+			char name[64] = {};
+			std::strftime(name, sizeof(name), "Frames_%Y%m%d_%H%M%S", std::localtime(&now));
+			mArchivePath = mOptions.mOutputDir / (std::string(name) + FrameArchive::EXTENSION);
+		}
+
+		// Decoding is the heaviest stage, PNG encoding comes close
+		int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		int decodeWorkers = std::clamp(cores / 2, 1, static_cast<int>(std::min<size_t>(videos.size(), 8)));
+		int convertWorkers = std::clamp(cores / 4, 1, 4);
+		int encodeWorkers = std::clamp(options.mFormat == ImageFormat::PNG ? cores / 2 : cores / 4, 1, 8);
+		mDecodeWorkers = decodeWorkers;
+		mConvertWorkers = convertWorkers;
+		mEncodeWorkers = encodeWorkers;
+		mActiveStages = decodeWorkers + convertWorkers + encodeWorkers + 1;
+		for (int i = 0; i < decodeWorkers; i++)
+			mThreads.emplace_back(&BatchExtractor::DecodeWorker, this);
+		for (int i = 0; i < convertWorkers; i++)
+			mThreads.emplace_back(&BatchExtractor::ConvertWorker, this);
+		for (int i = 0; i < encodeWorkers; i++)
+			mThreads.emplace_back(&BatchExtractor::EncodeWorker, this);
+		mThreads.emplace_back(&BatchExtractor::WriteWorker, this);
+		return true;
+	}
+
+	void BatchExtractor::Cancel()
+	{
+		mCancel = true;
+		{
+			std::lock_guard<std::mutex> lock(mVideoMutex);
+			mVideos.clear();
+		}
+		mDecodedQueue.Abort();
+		mConvertedQueue.Abort();
+		mEncodedQueue.Abort();
+	}
+
+	void BatchExtractor::Join()
+	{
+		for (auto& thread : mThreads)
+			thread.join();
+		mThreads.clear();
+	}
+
+	ExtractStats BatchExtractor::GetStats() const
+	{
+		ExtractStats stats;
+		stats.mVideosDone = mVideosDone;
+		stats.mVideosTotal = mVideosTotal;
+		stats.mDecoded = mDecoded;
+		stats.mSelected = mSelected;
+		stats.mConverted = mConverted;
+		stats.mEncoded = mEncoded;
+		stats.mWritten = mWritten;
+		stats.mBytesWritten = mBytesWritten;
+		stats.mFailed = mFailed;
+		stats.mArchive = mArchivePath;
+		stats.mRunning = IsRunning();
+		int64_t elapsed = mElapsedMilliseconds;
+		stats.mElapsedSeconds = elapsed >= 0 ? elapsed / 1000.0 : std::chrono::duration<double>(std::chrono::steady_clock::now() - mStarted).count();
+		stats.mDecodedQueue = { mDecodedQueue.Size(), mDecodedQueue.Capacity(), mDecodedQueue.GetFullWaits(), mDecodedQueue.Bytes() };
+		stats.mConvertedQueue = { mConvertedQueue.Size(), mConvertedQueue.Capacity(), mConvertedQueue.GetFullWaits(), mConvertedQueue.Bytes() };
+		stats.mEncodedQueue = { mEncodedQueue.Size(), mEncodedQueue.Capacity(), mEncodedQueue.GetFullWaits(), mEncodedQueue.Bytes() };
+		return stats;
+	}
+
+	void BatchExtractor::DecodeWorker()
+	{
+		while (!mCancel)
+		{
+			VideoSource video;
+			{
+				std::lock_guard<std::mutex> lock(mVideoMutex);
+				if (mVideos.empty())
+					break;
+				video = std::move(mVideos.front());
+				mVideos.pop_front();
+			}
+			ExtractVideo(video);
+			mVideosDone++;
+		}
+		// The last decoder out lets the converters drain and finish
+		if (--mDecodeWorkers == 0)
+			mDecodedQueue.Close();
+		mActiveStages--;
+	}
+
+	void BatchExtractor::ExtractVideo(const VideoSource& video)
+	{
+		// One thread per video like thumbnails, but the output is kept at full quality
+		DecodePolicy policy = DecodePolicy::For(DecodeUseCase::Thumbnail);
+		policy.mSkipLoopFilter = false;
+		bool keyframesOnly = mOptions.mMode == ExtractMode::Keyframes;
+		DecodeSession session;
+		bool opened = session.Open(video.mPath, policy, true, [keyframesOnly](AVCodecContext* codecContext) {
+			if (keyframesOnly)
+				codecContext->skip_frame = AVDISCARD_NONKEY;
+		});
+		if (!opened)
+		{
+			FRAMEEX_CORE_WARN("BatchExtractor: unable to decode {}: {}", video.mPath.string(), session.GetError());
+			mFailed++;
+			return;
+		}
+		// Keyframe mode never hands the decoder anything else
+		if (keyframesOnly)
+			session.SetPacketFilter([](const AVPacket& packet) { return (packet.flags & AV_PKT_FLAG_KEY) != 0; });
+
+		// Numbers frames the same way whichever mode selected them
+		VideoIndex index;
+		if (!index.Load(video.mPath))
+		{
+			index.Build(session.GetFormatContext(), session.GetStreamIndex(), &mCancel);
+			if (mCancel)
+				return;
+			index.Save(video.mPath);
+		}
+
+		AVStream* stream = session.GetStream();
+		int64_t startPTS = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+		double fps = session.GetFrameRate() > 0.0 ? session.GetFrameRate() : 25.0;
+		auto source = std::make_shared<const VideoSource>(video);
+		auto seekTo = [&](double seconds) {
+			session.Seek(startPTS + static_cast<int64_t>(seconds / av_q2d(stream->time_base)));
+		};
+
+		double nextTime = 0.0;          // EveryInterval
+		size_t range = 0;               // TimeRanges
+		const auto& ranges = mOptions.mRanges;
+		if (mOptions.mMode == ExtractMode::TimeRanges && !ranges.empty() && ranges[0].first >= SEEK_THRESHOLD_SECONDS)
+			seekTo(ranges[0].first);
+
+		AVFrame* frame = av_frame_alloc();
+		bool done = mOptions.mMode == ExtractMode::TimeRanges && ranges.empty();
+		while (!done && !mCancel && session.ReceiveFrame(frame) == 0)
+		{
+			mDecoded++;
+			int64_t pts = DecodeSession::GetPTS(frame);
+			double time = session.GetTime(pts);
+			// Half a frame of slack so rounded timestamps still land on their target
+			double slack = 0.5 / fps;
+			uint64_t number = index.FindFrame(pts);
+			double seekTarget = -1.0;
+			bool selected = false;
+			switch (mOptions.mMode)
+			{
+			case ExtractMode::EveryNthFrame:
+				selected = number % mOptions.mFrameStep == 0;
+				break;
+			case ExtractMode::Keyframes:
+				selected = true;
+				break;
+			case ExtractMode::EveryInterval:
+				if (time + slack >= nextTime)
+				{
+					selected = true;
+					nextTime = (std::floor((time + slack) / mOptions.mInterval) + 1.0) * mOptions.mInterval;
+					if (nextTime - time >= SEEK_THRESHOLD_SECONDS)
+						seekTarget = nextTime;
+				}
+				break;
+			case ExtractMode::TimeRanges:
+				while (range < ranges.size() && time > ranges[range].second + slack)
+				{
+					range++;
+					if (range < ranges.size() && ranges[range].first - time >= SEEK_THRESHOLD_SECONDS)
+						seekTarget = ranges[range].first;
+				}
+				if (range == ranges.size())
+					done = true;
+				else
+					selected = time + slack >= ranges[range].first;
+				break;
+			}
+
+			if (selected)
+			{
+				SelectedFrame item;
+				item.mFrame.reset(av_frame_clone(frame));
+				item.mSource = { source, number, pts, time };
+				mSelected++;
+				if (!item.mFrame || !mDecodedQueue.Push(std::move(item), FrameBytes(frame)))
+					done = true;
+			}
+			av_frame_unref(frame);
+			if (seekTarget >= 0.0 && !session.IsDraining())
+				seekTo(seekTarget);
+		}
+		av_frame_free(&frame);
+	}
+
+	void BatchExtractor::ConvertWorker()
+	{
+		SelectedFrame item;
+		while (mDecodedQueue.Pop(item))
+		{
+			FramePtr converted(ImageEncoder::Convert(item.mFrame.get(), mOptions.mFormat, mOptions.mMaxWidth));
+			if (!converted)
+				continue;
+			mConverted++;
+
+			item.mFrame = std::move(converted);
+			size_t bytes = FrameBytes(item.mFrame.get());
+			if (!mConvertedQueue.Push(std::move(item), bytes))
+				break;
+		}
+		if (--mConvertWorkers == 0)
+			mConvertedQueue.Close();
+		mActiveStages--;
+	}
+
+	void BatchExtractor::EncodeWorker()
+	{
+		ImageEncoder encoder(mOptions.mFormat, mOptions.mJPEGQuality);
+		SelectedFrame item;
+		// Keeps draining without an encoder so the stages before it can finish
+		while (mConvertedQueue.Pop(item))
+		{
+			if (!encoder.IsAvailable())
+				continue;
+			EncodedFrame encoded;
+			bool ok = encoder.Encode(item.mFrame.get(), encoded.mData);
+			item.mFrame.reset();
+			if (!ok)
+				continue;
+			mEncoded++;
+			encoded.mSource = std::move(item.mSource);
+			size_t bytes = encoded.mData.size();
+			if (!mEncodedQueue.Push(std::move(encoded), bytes))
+				break;
+		}
+		if (--mEncodeWorkers == 0)
+			mEncodedQueue.Close();
+		mActiveStages--;
+	}
+
+	// One writer keeps the disk writing sequentially
+	void BatchExtractor::WriteWorker()
+	{
+		FrameArchiveWriter archive;
+		bool packed = mOptions.mOutput == ExtractOutput::Archive;
+		if (packed && !archive.Open(mArchivePath))
+			mFailed++;
+
+		EncodedFrame encoded;
+		while (mEncodedQueue.Pop(encoded))
+		{
+			const FrameSource& source = encoded.mSource;
+			if (packed)
+			{
+				if (!archive.Append(source.mVideo->mPath, source.mVideo->mName, static_cast<uint32_t>(source.mNumber), source.mPTS, source.mTime, mOptions.mFormat, encoded.mData.data(), encoded.mData.size()))
+				{
+					mFailed++;
+					continue;
+				}
+			}
+			else
+			{
+				std::filesystem::path output = mOptions.mOutputDir / FrameArchive::GetFileName(source.mVideo->mName, source.mNumber, mOptions.mFormat);
+				std::ofstream file(output, std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(encoded.mData.data()), encoded.mData.size());
+				if (!file)
+				{
+					FRAMEEX_CORE_WARN("BatchExtractor: unable to write {}", output.string());
+					mFailed++;
+					continue;
+				}
+			}
+			mWritten++;
+			mBytesWritten += encoded.mData.size();
+		}
+		// A cancelled batch still gets its index, what was written stays readable
+		if (archive.IsOpen() && !archive.Close())
+			mFailed++;
+		mElapsedMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStarted).count();
+		mActiveStages--;
+	}
+}
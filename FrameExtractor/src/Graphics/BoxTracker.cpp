@@ -0,0 +1,340 @@
+/******************************************************************************
+/*!
+\file       BoxTracker.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Box Tracker class, which follows a labelled box
+			through the frames after it by template matching.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/BoxTracker.hpp>
+#include <Graphics/Video.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRAMEEX_X86
+#include <emmintrin.h>
+#endif
+
+namespace FrameExtractor
+{
+	BoxTracker::~BoxTracker()
+	{
+		Cancel();
+	}
+
+	bool BoxTracker::Start(const Video& video, int32_t frame, const BoundingBox& box, const TrackerOptions& options)
+	{
+		Cancel();
+		const VideoIndex& index = video.GetIndex();
+		// Results are keyed by frame number, estimated ones would be off
+		if (index.IsEmpty() || index.IsEstimated() || frame < 0 || static_cast<uint32_t>(frame) + 1 >= index.GetFrameCount()
+			|| box.maxX - box.minX < 1.f || box.maxY - box.minY < 1.f)
+			return false;
+
+		mPath = video.GetPath();
+		mIndex = index;
+		mVideoWidth = video.GetWidth();
+		mVideoHeight = video.GetHeight();
+		mStartFrame = frame;
+		mStartBox = box;
+		mOptions = options;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mResults.clear();
+		}
+		mStop = false;
+		mLostTarget = false;
+		mFramesTracked = 0;
+		mConfidence = 1.f;
+		mMatchMicroseconds = 0;
+		mRunning = true;
+		mThread = std::thread(&BoxTracker::TrackLoop, this);
+		return true;
+	}
+
+	void BoxTracker::Cancel()
+	{
+		mStop = true;
+		if (mThread.joinable())
+			mThread.join();
+	}
+
+	TrackerProgress BoxTracker::GetProgress() const
+	{
+		TrackerProgress progress;
+		progress.mRunning = mRunning;
+		progress.mLostTarget = mLostTarget;
+		progress.mFramesTracked = mFramesTracked;
+		progress.mFramesTotal = mIndex.IsEmpty() ? 0 : std::min(mOptions.mMaxFrames, mIndex.GetFrameCount() - 1 - static_cast<uint32_t>(mStartFrame));
+		progress.mConfidence = mConfidence;
+		int64_t microseconds = mMatchMicroseconds;
+		progress.mBoxFramesPerSecond = microseconds > 0 ? progress.mFramesTracked * 1e6 / microseconds : 0.0;
+		return progress;
+	}
+
+	std::vector<TrackedBox> BoxTracker::GetResults() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mResults;
+	}
+
+	std::vector<TrackedBox> BoxTracker::Simplify(const std::vector<TrackedBox>& boxes, float tolerance)
+	{
+		if (boxes.size() <= 2)
+			return boxes;
+
+		auto fits = [&](size_t from, size_t to) {
+			const TrackedBox& a = boxes[from];
+			const TrackedBox& b = boxes[to];
+			for (size_t i = from + 1; i < to; i++)
+			{
+				float t = static_cast<float>(boxes[i].mFrame - a.mFrame) / (b.mFrame - a.mFrame);
+				const BoundingBox& box = boxes[i].mBox;
+				if (std::abs(a.mBox.minX + (b.mBox.minX - a.mBox.minX) * t - box.minX) > tolerance
+					|| std::abs(a.mBox.minY + (b.mBox.minY - a.mBox.minY) * t - box.minY) > tolerance
+					|| std::abs(a.mBox.maxX + (b.mBox.maxX - a.mBox.maxX) * t - box.maxX) > tolerance
+					|| std::abs(a.mBox.maxY + (b.mBox.maxY - a.mBox.maxY) * t - box.maxY) > tolerance)
+					return false;
+			}
+			return true;
+		};
+
+		std::vector<TrackedBox> kept = { boxes.front() };
+		size_t anchor = 0;
+		for (size_t i = 2; i < boxes.size(); i++)
+		{
+			if (fits(anchor, i))
+				continue;
+			anchor = i - 1;
+			kept.push_back(boxes[anchor]);
+		}
+		kept.push_back(boxes.back());
+		return kept;
+	}
+
+	uint32_t BoxTracker::DotProduct(const uint8_t* a, const uint8_t* b, size_t size)
+	{
+		uint32_t sum = 0;
+		size_t i = 0;
+#ifdef FRAMEEX_X86
+		// Widen to 16 bits, PMADDWD multiplies and adds pairs into 32 bit lanes
+		__m128i zero = _mm_setzero_si128();
+		__m128i total = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			total = _mm_add_epi32(total, _mm_madd_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero)));
+			total = _mm_add_epi32(total, _mm_madd_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero)));
+		}
+		total = _mm_add_epi32(total, _mm_shuffle_epi32(total, _MM_SHUFFLE(1, 0, 3, 2)));
+		total = _mm_add_epi32(total, _mm_shuffle_epi32(total, _MM_SHUFFLE(2, 3, 0, 1)));
+		sum = static_cast<uint32_t>(_mm_cvtsi128_si32(total));
+#endif
+		for (; i < size; i++)
+			sum += static_cast<uint32_t>(a[i]) * b[i];
+		return sum;
+	}
+
+	void BoxTracker::CutPatch(const std::vector<uint8_t>& image, uint32_t imageWidth, int32_t x, int32_t y, Patch& patch)
+	{
+		patch.mPixels.resize(static_cast<size_t>(patch.mWidth) * patch.mHeight);
+		patch.mSum = 0;
+		patch.mSumSquares = 0;
+		for (uint32_t row = 0; row < patch.mHeight; row++)
+		{
+			const uint8_t* source = image.data() + static_cast<size_t>(y + row) * imageWidth + x;
+			uint8_t* destination = patch.mPixels.data() + static_cast<size_t>(row) * patch.mWidth;
+			std::memcpy(destination, source, patch.mWidth);
+			for (uint32_t column = 0; column < patch.mWidth; column++)
+			{
+				patch.mSum += destination[column];
+				patch.mSumSquares += destination[column] * destination[column];
+			}
+		}
+	}
+
+	float BoxTracker::Match(const std::vector<uint8_t>& image, uint32_t imageWidth, uint32_t imageHeight, const Patch& patch, int32_t& x, int32_t& y, int32_t radius)
+	{
+		int32_t x0 = std::max(0, x - radius);
+		int32_t y0 = std::max(0, y - radius);
+		int32_t x1 = std::min(static_cast<int32_t>(imageWidth - patch.mWidth), x + radius);
+		int32_t y1 = std::min(static_cast<int32_t>(imageHeight - patch.mHeight), y + radius);
+		if (x1 < x0 || y1 < y0)
+			return 0.f;
+
+		// Integral images of the searched area give every candidate's sums in O(1)
+		uint32_t areaWidth = static_cast<uint32_t>(x1 - x0) + patch.mWidth;
+		uint32_t areaHeight = static_cast<uint32_t>(y1 - y0) + patch.mHeight;
+		size_t stride = areaWidth + 1;
+		std::vector<uint64_t> sums(stride * (areaHeight + 1), 0);
+		std::vector<uint64_t> squares(stride * (areaHeight + 1), 0);
+		for (uint32_t row = 0; row < areaHeight; row++)
+		{
+			const uint8_t* source = image.data() + static_cast<size_t>(y0 + row) * imageWidth + x0;
+			uint64_t rowSum = 0;
+			uint64_t rowSquares = 0;
+			for (uint32_t column = 0; column < areaWidth; column++)
+			{
+				rowSum += source[column];
+				rowSquares += source[column] * source[column];
+				sums[(row + 1) * stride + column + 1] = sums[row * stride + column + 1] + rowSum;
+				squares[(row + 1) * stride + column + 1] = squares[row * stride + column + 1] + rowSquares;
+			}
+		}
+
+		double n = static_cast<double>(patch.mWidth) * patch.mHeight;
+		double patchVariance = patch.mSumSquares - static_cast<double>(patch.mSum) * patch.mSum / n;
+		if (patchVariance < 1.0)
+			return 0.f;
+
+		double best = -1.0;
+		int32_t bestX = x;
+		int32_t bestY = y;
+		for (int32_t cy = y0; cy <= y1; cy++)
+		{
+			for (int32_t cx = x0; cx <= x1; cx++)
+			{
+				size_t left = static_cast<size_t>(cx - x0);
+				size_t top = static_cast<size_t>(cy - y0);
+				auto areaSum = [&](const std::vector<uint64_t>& table) {
+					return table[(top + patch.mHeight) * stride + left + patch.mWidth] - table[top * stride + left + patch.mWidth]
+						- table[(top + patch.mHeight) * stride + left] + table[top * stride + left];
+				};
+				double sum = static_cast<double>(areaSum(sums));
+				double variance = areaSum(squares) - sum * sum / n;
+				if (variance < 1.0)
+					continue;
+
+				uint64_t dot = 0;
+				for (uint32_t row = 0; row < patch.mHeight; row++)
+					dot += DotProduct(image.data() + static_cast<size_t>(cy + row) * imageWidth + cx, patch.mPixels.data() + static_cast<size_t>(row) * patch.mWidth, patch.mWidth);
+				double score = (dot - sum * patch.mSum / n) / std::sqrt(variance * patchVariance);
+				if (score > best)
+				{
+					best = score;
+					bestX = cx;
+					bestY = cy;
+				}
+			}
+		}
+		x = bestX;
+		y = bestY;
+		return static_cast<float>(std::clamp(best, 0.0, 1.0));
+	}
+
+	void BoxTracker::TrackLoop()
+	{
+		// The box's long side shrinks to TEMPLATE_SIZE, the frame with it
+		float boxWidth = mStartBox.maxX - mStartBox.minX;
+		float boxHeight = mStartBox.maxY - mStartBox.minY;
+		float scale = std::max(1.f, std::max(boxWidth, boxHeight) / TEMPLATE_SIZE);
+
+		DecodeSession session;
+		bool opened = session.Open(mPath, DecodePolicy::For(DecodeUseCase::Analysis), false, [scale](AVCodecContext* codecContext) {
+			// Codecs that can decode at a fraction of the size save most of the work
+			int lowres = 0;
+			while (lowres < codecContext->codec->max_lowres && (1 << (lowres + 1)) <= scale)
+				lowres++;
+			codecContext->lowres = lowres;
+		});
+		if (!opened)
+		{
+			FRAMEEX_CORE_WARN("BoxTracker: unable to decode {}: {}", mPath.string(), session.GetError());
+			mRunning = false;
+			return;
+		}
+		session.Seek(mIndex.GetEntry(mIndex.GetKeyframe(static_cast<uint32_t>(mStartFrame))).mPTS);
+
+		uint32_t imageWidth = std::max(8u, static_cast<uint32_t>(std::lround(mVideoWidth / scale)));
+		uint32_t imageHeight = std::max(8u, static_cast<uint32_t>(std::lround(mVideoHeight / scale)));
+		float scaleX = static_cast<float>(mVideoWidth) / imageWidth;
+		float scaleY = static_cast<float>(mVideoHeight) / imageHeight;
+		std::vector<uint8_t> image(static_cast<size_t>(imageWidth) * imageHeight);
+
+		Patch patch;
+		patch.mWidth = std::clamp(static_cast<uint32_t>(std::lround(boxWidth / scaleX)), 4u, imageWidth);
+		patch.mHeight = std::clamp(static_cast<uint32_t>(std::lround(boxHeight / scaleY)), 4u, imageHeight);
+		int32_t x = std::clamp(static_cast<int32_t>(std::lround(mStartBox.minX / scaleX)), 0, static_cast<int32_t>(imageWidth - patch.mWidth));
+		int32_t y = std::clamp(static_cast<int32_t>(std::lround(mStartBox.minY / scaleY)), 0, static_cast<int32_t>(imageHeight - patch.mHeight));
+		// Half the patch per frame covers fast walkers without matching the whole frame
+		int32_t radius = static_cast<int32_t>(std::max(patch.mWidth, patch.mHeight) / 2 + 2);
+		uint32_t lastFrame = static_cast<uint32_t>(mStartFrame) + mOptions.mMaxFrames;
+		bool hasPatch = false;
+
+		AVFrame* frame = av_frame_alloc();
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = nullptr;
+		bool done = false;
+		std::chrono::steady_clock::time_point started;
+		while (!done && !mStop && session.ReceiveFrame(frame) == 0)
+		{
+			uint32_t frameIndex = mIndex.FindFrame(DecodeSession::GetPTS(frame));
+			if (frameIndex < static_cast<uint32_t>(mStartFrame))
+			{
+				av_frame_unref(frame);
+				continue;
+			}
+
+			// Matching compares brightness alone, so the frame is scaled straight to one grey plane
+			if (!scaler)
+				scaler = pool.AcquireScaler(frame->width, frame->height, frame->format, imageWidth, imageHeight, AV_PIX_FMT_GRAY8, SWS_AREA);
+			if (!scaler)
+			{
+				av_frame_unref(frame);
+				done = true;
+				break;
+			}
+			uint8_t* dstData[4] = { image.data() };
+			int dstLinesize[4] = { static_cast<int>(imageWidth) };
+			sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+			av_frame_unref(frame);
+
+			if (!hasPatch)
+			{
+				CutPatch(image, imageWidth, x, y, patch);
+				hasPatch = true;
+				started = std::chrono::steady_clock::now();
+				continue;
+			}
+
+			float confidence = Match(image, imageWidth, imageHeight, patch, x, y, radius);
+			mConfidence = confidence;
+			if (confidence < mOptions.mMinConfidence)
+			{
+				mLostTarget = true;
+				done = true;
+				break;
+			}
+			if (confidence >= REFRESH_CONFIDENCE)
+				CutPatch(image, imageWidth, x, y, patch);
+
+			TrackedBox tracked;
+			tracked.mFrame = static_cast<int32_t>(frameIndex);
+			tracked.mBox = { x * scaleX, y * scaleY, x * scaleX + boxWidth, y * scaleY + boxHeight };
+			tracked.mConfidence = confidence;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mResults.push_back(tracked);
+			}
+			mFramesTracked++;
+			mMatchMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+			done = frameIndex >= lastFrame;
+		}
+
+		pool.ReleaseScaler(scaler);
+		av_frame_free(&frame);
+		mRunning = false;
+	}
+}
@@ -0,0 +1,414 @@
+/******************************************************************************
+/*!
+\file       ColorConverter.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Color Converter class, a same size YUV to RGB
+			converter with brightness, contrast and gamma applied in the same
+			pass.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/ColorConverter.hpp>
+#include <cstring>
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRAMEEX_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC emits any intrinsic without flags, GCC and Clang need it per function
+#if defined(_MSC_VER)
+#define FRAMEEX_TARGET(isa)
+#else
+#define FRAMEEX_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace FrameExtractor
+{
+	// Q16 fixed point. Contrast and brightness are folded into the matrix, so
+	// only gamma needs the lookup table.
+	struct Coefficients
+	{
+		int32_t mYOffset;
+		int32_t mY;
+		int32_t mRV;
+		int32_t mGU;
+		int32_t mGV;
+		int32_t mBU;
+		int32_t mAdd;
+	};
+
+	using RowKernel = void(*)(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, const Coefficients& c, bool nv12, bool rgba);
+
+	static inline uint8_t Clamp8(int32_t value)
+	{
+		return static_cast<uint8_t>(value < 0 ? 0 : value > 255 ? 255 : value);
+	}
+
+	static void ConvertPixels(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int begin, int end, const Coefficients& c, bool nv12, bool rgba)
+	{
+		int channels = rgba ? 4 : 3;
+		for (int x = begin; x < end; x++)
+		{
+			int32_t cu = (nv12 ? u[(x >> 1) * 2] : u[x >> 1]) - 128;
+			int32_t cv = (nv12 ? u[(x >> 1) * 2 + 1] : v[x >> 1]) - 128;
+			int32_t luma = c.mY * (y[x] - c.mYOffset) + c.mAdd;
+			uint8_t* pixel = dst + x * channels;
+			pixel[0] = Clamp8((luma + c.mRV * cv) >> 16);
+			pixel[1] = Clamp8((luma - c.mGU * cu - c.mGV * cv) >> 16);
+			pixel[2] = Clamp8((luma + c.mBU * cu) >> 16);
+			if (rgba)
+				pixel[3] = 255;
+		}
+	}
+
+	static void ConvertRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, const Coefficients& c, bool nv12, bool rgba)
+	{
+		ConvertPixels(y, u, v, dst, 0, width, c, nv12, rgba);
+	}
+
+#ifdef FRAMEEX_X86
+	// Loads 16 chroma samples for 16 pixels, each sample repeated twice
+	FRAMEEX_TARGET("sse4.1")
+	static inline void LoadChroma(const uint8_t* u, const uint8_t* v, int x, bool nv12, __m128i& outU, __m128i& outV)
+	{
+		if (nv12)
+		{
+			__m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+			outU = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+			outV = _mm_shuffle_epi8(uv, _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15));
+		}
+		else
+		{
+			__m128i u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2));
+			__m128i v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2));
+			outU = _mm_unpacklo_epi8(u8, u8);
+			outV = _mm_unpacklo_epi8(v8, v8);
+		}
+	}
+
+	// Interleaves 16 pixels of planar R, G and B into RGB24 or RGBA
+	FRAMEEX_TARGET("sse4.1")
+	static inline void StorePixels(uint8_t* dst, __m128i r, __m128i g, __m128i b, bool rgba)
+	{
+		__m128i alpha = _mm_set1_epi8(-1);
+		__m128i rgLo = _mm_unpacklo_epi8(r, g);
+		__m128i rgHi = _mm_unpackhi_epi8(r, g);
+		__m128i baLo = _mm_unpacklo_epi8(b, alpha);
+		__m128i baHi = _mm_unpackhi_epi8(b, alpha);
+		__m128i p0 = _mm_unpacklo_epi16(rgLo, baLo);
+		__m128i p1 = _mm_unpackhi_epi16(rgLo, baLo);
+		__m128i p2 = _mm_unpacklo_epi16(rgHi, baHi);
+		__m128i p3 = _mm_unpackhi_epi16(rgHi, baHi);
+		if (rgba)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), p0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), p1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), p2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), p3);
+			return;
+		}
+
+		// Each store writes 4 bytes past its pixels, the next store overwrites them
+		__m128i dropAlpha = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		p0 = _mm_shuffle_epi8(p0, dropAlpha);
+		p1 = _mm_shuffle_epi8(p1, dropAlpha);
+		p2 = _mm_shuffle_epi8(p2, dropAlpha);
+		p3 = _mm_shuffle_epi8(p3, dropAlpha);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), p0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), p1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 24), p2);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 36), p3);
+		int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(p3, 8));
+		std::memcpy(dst + 44, &tail, sizeof(tail));
+	}
+
+	FRAMEEX_TARGET("sse4.1")
+	static void ConvertRowSSE41(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, const Coefficients& c, bool nv12, bool rgba)
+	{
+		const __m128i yOffset = _mm_set1_epi32(c.mYOffset);
+		const __m128i yMul = _mm_set1_epi32(c.mY);
+		const __m128i rv = _mm_set1_epi32(c.mRV);
+		const __m128i gu = _mm_set1_epi32(c.mGU);
+		const __m128i gv = _mm_set1_epi32(c.mGV);
+		const __m128i bu = _mm_set1_epi32(c.mBU);
+		const __m128i add = _mm_set1_epi32(c.mAdd);
+		const __m128i mid = _mm_set1_epi32(128);
+		int channels = rgba ? 4 : 3;
+
+		int x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+			__m128i u8, v8;
+			LoadChroma(u, v, x, nv12, u8, v8);
+
+			__m128i r32[4], g32[4], b32[4];
+			for (int i = 0; i < 4; i++)
+			{
+				__m128i luma = _mm_add_epi32(_mm_mullo_epi32(_mm_sub_epi32(_mm_cvtepu8_epi32(y8), yOffset), yMul), add);
+				__m128i cu = _mm_sub_epi32(_mm_cvtepu8_epi32(u8), mid);
+				__m128i cv = _mm_sub_epi32(_mm_cvtepu8_epi32(v8), mid);
+				r32[i] = _mm_srai_epi32(_mm_add_epi32(luma, _mm_mullo_epi32(cv, rv)), 16);
+				g32[i] = _mm_srai_epi32(_mm_sub_epi32(luma, _mm_add_epi32(_mm_mullo_epi32(cu, gu), _mm_mullo_epi32(cv, gv))), 16);
+				b32[i] = _mm_srai_epi32(_mm_add_epi32(luma, _mm_mullo_epi32(cu, bu)), 16);
+				y8 = _mm_srli_si128(y8, 4);
+				u8 = _mm_srli_si128(u8, 4);
+				v8 = _mm_srli_si128(v8, 4);
+			}
+
+			__m128i r = _mm_packus_epi16(_mm_packs_epi32(r32[0], r32[1]), _mm_packs_epi32(r32[2], r32[3]));
+			__m128i g = _mm_packus_epi16(_mm_packs_epi32(g32[0], g32[1]), _mm_packs_epi32(g32[2], g32[3]));
+			__m128i b = _mm_packus_epi16(_mm_packs_epi32(b32[0], b32[1]), _mm_packs_epi32(b32[2], b32[3]));
+			StorePixels(dst + x * channels, r, g, b, rgba);
+		}
+		ConvertPixels(y, u, v, dst, x, width, c, nv12, rgba);
+	}
+
+	FRAMEEX_TARGET("avx2")
+	static inline __m128i PackChannel(__m256i lo, __m256i hi)
+	{
+		// packs works within 128 bit lanes, the permute puts the pixels back in order
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+		return _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+	}
+
+	FRAMEEX_TARGET("avx2")
+	static void ConvertRowAVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, const Coefficients& c, bool nv12, bool rgba)
+	{
+		const __m256i yOffset = _mm256_set1_epi32(c.mYOffset);
+		const __m256i yMul = _mm256_set1_epi32(c.mY);
+		const __m256i rv = _mm256_set1_epi32(c.mRV);
+		const __m256i gu = _mm256_set1_epi32(c.mGU);
+		const __m256i gv = _mm256_set1_epi32(c.mGV);
+		const __m256i bu = _mm256_set1_epi32(c.mBU);
+		const __m256i add = _mm256_set1_epi32(c.mAdd);
+		const __m256i mid = _mm256_set1_epi32(128);
+		int channels = rgba ? 4 : 3;
+
+		int x = 0;
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+			__m128i u8, v8;
+			LoadChroma(u, v, x, nv12, u8, v8);
+
+			__m256i r32[2], g32[2], b32[2];
+			for (int i = 0; i < 2; i++)
+			{
+				__m256i luma = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(_mm256_cvtepu8_epi32(y8), yOffset), yMul), add);
+				__m256i cu = _mm256_sub_epi32(_mm256_cvtepu8_epi32(u8), mid);
+				__m256i cv = _mm256_sub_epi32(_mm256_cvtepu8_epi32(v8), mid);
+				r32[i] = _mm256_srai_epi32(_mm256_add_epi32(luma, _mm256_mullo_epi32(cv, rv)), 16);
+				g32[i] = _mm256_srai_epi32(_mm256_sub_epi32(luma, _mm256_add_epi32(_mm256_mullo_epi32(cu, gu), _mm256_mullo_epi32(cv, gv))), 16);
+				b32[i] = _mm256_srai_epi32(_mm256_add_epi32(luma, _mm256_mullo_epi32(cu, bu)), 16);
+				y8 = _mm_srli_si128(y8, 8);
+				u8 = _mm_srli_si128(u8, 8);
+				v8 = _mm_srli_si128(v8, 8);
+			}
+
+			StorePixels(dst + x * channels, PackChannel(r32[0], r32[1]), PackChannel(g32[0], g32[1]), PackChannel(b32[0], b32[1]), rgba);
+		}
+		ConvertPixels(y, u, v, dst, x, width, c, nv12, rgba);
+	}
+#endif
+
+	static Coefficients BuildCoefficients(const AVFrame* src, const ColorAdjust& adjust)
+	{
+		bool fullRange = src->color_range == AVCOL_RANGE_JPEG || src->format == AV_PIX_FMT_YUVJ420P;
+		bool bt709 = src->colorspace == AVCOL_SPC_BT709
+			|| (src->colorspace == AVCOL_SPC_UNSPECIFIED && src->height >= 720);
+
+		double kr = bt709 ? 1.5748 : 1.402;
+		double kgu = bt709 ? 0.187324 : 0.344136;
+		double kgv = bt709 ? 0.468124 : 0.714136;
+		double kb = bt709 ? 1.8556 : 1.772;
+		double yScale = fullRange ? 1.0 : 255.0 / 219.0;
+		double cScale = fullRange ? 1.0 : 255.0 / 224.0;
+
+		// out = contrast * (rgb - 128) + 128 + brightness
+		double contrast = adjust.mContrast;
+		double offset = 128.0 * (1.0 - contrast) + 255.0 * adjust.mBrightness;
+
+		Coefficients c;
+		c.mYOffset = fullRange ? 0 : 16;
+		c.mY = static_cast<int32_t>(std::lround(65536.0 * contrast * yScale));
+		c.mRV = static_cast<int32_t>(std::lround(65536.0 * contrast * cScale * kr));
+		c.mGU = static_cast<int32_t>(std::lround(65536.0 * contrast * cScale * kgu));
+		c.mGV = static_cast<int32_t>(std::lround(65536.0 * contrast * cScale * kgv));
+		c.mBU = static_cast<int32_t>(std::lround(65536.0 * contrast * cScale * kb));
+		c.mAdd = static_cast<int32_t>(std::lround(65536.0 * offset)) + (1 << 15);
+		return c;
+	}
+
+	ColorConverter::ColorConverter() : mPath(GetBestPath()), mTables(std::make_shared<Tables>())
+	{
+	}
+
+	bool ColorConverter::IsSupported(int pixelFormat)
+	{
+		return pixelFormat == AV_PIX_FMT_YUV420P || pixelFormat == AV_PIX_FMT_YUVJ420P || pixelFormat == AV_PIX_FMT_NV12;
+	}
+
+	ColorConverter::Path ColorConverter::GetBestPath()
+	{
+#ifdef FRAMEEX_X86
+		static const Path best = []() {
+			int info[4] = {};
+#if defined(_MSC_VER)
+			__cpuid(info, 1);
+#else
+			__cpuid(1, info[0], info[1], info[2], info[3]);
+#endif
+			bool sse41 = (info[2] & (1 << 19)) != 0;
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+
+			// AVX2 also needs the OS to save the upper halves of the registers
+			bool avx2 = false;
+			if (osxsave && avx)
+			{
+#if defined(_MSC_VER)
+				bool ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+				__cpuidex(info, 7, 0);
+#else
+				uint32_t xcrLow = 0, xcrHigh = 0;
+				__asm__("xgetbv" : "=a"(xcrLow), "=d"(xcrHigh) : "c"(0));
+				bool ymmEnabled = (xcrLow & 0x6) == 0x6;
+				__cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+#endif
+				avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+			}
+			return avx2 ? Path::AVX2 : sse41 ? Path::SSE41 : Path::Scalar;
+		}();
+		return best;
+#else
+		return Path::Scalar;
+#endif
+	}
+
+	const char* ColorConverter::GetPathName(Path path)
+	{
+		switch (path)
+		{
+		case Path::Scalar:
+			return "Scalar";
+		case Path::SSE41:
+			return "SSE4.1";
+		case Path::AVX2:
+			return "AVX2";
+		}
+		return "Unknown";
+	}
+
+	void ColorConverter::SetAdjust(const ColorAdjust& adjust)
+	{
+		auto tables = std::make_shared<Tables>();
+		tables->mAdjust = adjust;
+		tables->mUseLut = adjust.mGamma > 0.f && adjust.mGamma != 1.f;
+		tables->mUseFullLut = tables->mUseLut || adjust.mBrightness != 0.f || adjust.mContrast != 1.f;
+
+		double exponent = tables->mUseLut ? 1.0 / adjust.mGamma : 1.0;
+		for (int channel = 0; channel < 3; channel++)
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				double linear = adjust.mContrast * (i - 128.0) + 128.0 + 255.0 * adjust.mBrightness;
+				double adjusted = std::clamp(linear, 0.0, 255.0);
+				tables->mLut[channel][i] = Clamp8(static_cast<int32_t>(std::lround(255.0 * std::pow(i / 255.0, exponent))));
+				tables->mFullLut[channel][i] = Clamp8(static_cast<int32_t>(std::lround(255.0 * std::pow(adjusted / 255.0, exponent))));
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTables = std::move(tables);
+	}
+
+	void ColorConverter::ApplyAdjust(uint8_t* rgb, int width, int height, int stride, bool rgba) const
+	{
+		std::shared_ptr<const Tables> tables = GetTables();
+		if (!tables->mUseFullLut)
+			return;
+
+		int channels = rgba ? 4 : 3;
+		for (int row = 0; row < height; row++)
+		{
+			uint8_t* pixel = rgb + static_cast<ptrdiff_t>(row) * stride;
+			for (int x = 0; x < width; x++, pixel += channels)
+			{
+				pixel[0] = tables->mFullLut[0][pixel[0]];
+				pixel[1] = tables->mFullLut[1][pixel[1]];
+				pixel[2] = tables->mFullLut[2][pixel[2]];
+			}
+		}
+	}
+
+	ColorAdjust ColorConverter::GetAdjust() const
+	{
+		return GetTables()->mAdjust;
+	}
+
+	void ColorConverter::SetPath(Path path)
+	{
+		mPath = std::min(path, GetBestPath());
+	}
+
+	std::shared_ptr<const ColorConverter::Tables> ColorConverter::GetTables() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mTables;
+	}
+
+	bool ColorConverter::Convert(const AVFrame* src, uint8_t* dst, int dstStride, bool rgba) const
+	{
+		if (!IsSupported(src->format))
+			return false;
+
+		std::shared_ptr<const Tables> tables = GetTables();
+		Coefficients coefficients = BuildCoefficients(src, tables->mAdjust);
+		bool nv12 = src->format == AV_PIX_FMT_NV12;
+		int channels = rgba ? 4 : 3;
+
+		RowKernel kernel = ConvertRowScalar;
+#ifdef FRAMEEX_X86
+		if (mPath == Path::AVX2)
+			kernel = ConvertRowAVX2;
+		else if (mPath == Path::SSE41)
+			kernel = ConvertRowSSE41;
+#endif
+
+		for (int row = 0; row < src->height; row++)
+		{
+			const uint8_t* y = src->data[0] + static_cast<ptrdiff_t>(row) * src->linesize[0];
+			const uint8_t* u = src->data[1] + static_cast<ptrdiff_t>(row / 2) * src->linesize[1];
+			const uint8_t* v = nv12 ? nullptr : src->data[2] + static_cast<ptrdiff_t>(row / 2) * src->linesize[2];
+			uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dstStride;
+			kernel(y, u, v, out, src->width, coefficients, nv12, rgba);
+
+			// Gamma is applied while the row is still in cache
+			if (tables->mUseLut)
+			{
+				for (int x = 0; x < src->width; x++)
+				{
+					uint8_t* pixel = out + x * channels;
+					pixel[0] = tables->mLut[0][pixel[0]];
+					pixel[1] = tables->mLut[1][pixel[1]];
+					pixel[2] = tables->mLut[2][pixel[2]];
+				}
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,555 @@
+/******************************************************************************
+/*!
+\file       DatasetExporter.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Dataset Exporter class, a pipeline that writes the
+			labelled frames of a project as a YOLO and COCO training set.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/DatasetExporter.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/ImageEncoder.hpp>
+#include <Graphics/VideoIndex.hpp>
+#include <fstream>
+#include <set>
+#include <yaml-cpp/yaml.h>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace FrameExtractor
+{
+	static const char* SPLIT_NAMES[] = { "train", "val" };
+
+	static int64_t MicrosecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// The part of the box inside the image, false when nothing is left
+	static bool ClampBox(const BoundingBox& box, int width, int height, BoundingBox& clamped)
+	{
+		clamped.minX = std::clamp(std::min(box.minX, box.maxX), 0.f, static_cast<float>(width));
+		clamped.maxX = std::clamp(std::max(box.minX, box.maxX), 0.f, static_cast<float>(width));
+		clamped.minY = std::clamp(std::min(box.minY, box.maxY), 0.f, static_cast<float>(height));
+		clamped.maxY = std::clamp(std::max(box.minY, box.maxY), 0.f, static_cast<float>(height));
+		return clamped.maxX - clamped.minX >= 1.f && clamped.maxY - clamped.minY >= 1.f;
+	}
+
+	static std::string EscapeJSON(const std::string& text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char code[8] = {};
+				std::snprintf(code, sizeof(code), "\\u%04x", c);
+				escaped += code;
+			}
+			else
+				escaped += c;
+		}
+		return escaped;
+	}
+
+	// Images go straight into the file and annotations into a side file that
+	// is appended on Close, so neither list is held in memory
+	class CocoWriter
+	{
+	public:
+		bool Open(const std::filesystem::path& path)
+		{
+			mAnnotationPath = path;
+			mAnnotationPath += ".annotations.tmp";
+			mFile.open(path, std::ios::binary | std::ios::trunc);
+			mAnnotations.open(mAnnotationPath, std::ios::binary | std::ios::trunc);
+			if (!mFile || !mAnnotations)
+			{
+				FRAMEEX_CORE_ERROR("DatasetExporter: unable to create {}", path.string());
+				mFile.close();
+				mAnnotations.close();
+				return false;
+			}
+			mFile << "{\"info\":{\"description\":\"FrameExtractor dataset\"},\"images\":[";
+			return true;
+		}
+
+		inline bool IsOpen() const { return mFile.is_open(); }
+
+		void AddImage(uint64_t id, const std::string& fileName, int width, int height)
+		{
+			mFile << (mImages++ ? ",\n" : "\n") << "{\"id\":" << id << ",\"file_name\":\"" << EscapeJSON(fileName)
+				<< "\",\"width\":" << width << ",\"height\":" << height << "}";
+		}
+
+		// bbox is x, y, width, height in pixels of the written image
+		void AddAnnotation(uint64_t imageID, uint32_t category, float x, float y, float width, float height)
+		{
+			char line[256] = {};
+			std::snprintf(line, sizeof(line), "%s{\"id\":%llu,\"image_id\":%llu,\"category_id\":%u,\"bbox\":[%.2f,%.2f,%.2f,%.2f],\"area\":%.2f,\"iscrowd\":0}",
+				mAnnotationCount ? ",\n" : "\n", static_cast<unsigned long long>(mAnnotationCount + 1), static_cast<unsigned long long>(imageID),
+				category, x, y, width, height, width * height);
+			mAnnotations << line;
+			mAnnotationCount++;
+		}
+
+		// COCO keeps category 0 free, class n is category n + 1
+		bool Close(const std::vector<uint32_t>& classes)
+		{
+			mAnnotations.close();
+			mFile << "\n],\"annotations\":[";
+			{
+				std::ifstream annotations(mAnnotationPath, std::ios::binary);
+				// Streaming an empty buffer would fail the output
+				if (annotations.peek() != std::ifstream::traits_type::eof())
+					mFile << annotations.rdbuf();
+			}
+			mFile << "\n],\"categories\":[";
+			for (size_t i = 0; i < classes.size(); i++)
+				mFile << (i ? ",\n" : "\n") << "{\"id\":" << classes[i] + 1 << ",\"name\":\"" << classes[i] << "\",\"supercategory\":\"object\"}";
+			mFile << "\n]}\n";
+			bool good = mFile.good();
+			mFile.close();
+			std::error_code error;
+			std::filesystem::remove(mAnnotationPath, error);
+			return good;
+		}
+	private:
+		std::ofstream mFile;
+		std::ofstream mAnnotations;
+		std::filesystem::path mAnnotationPath;
+		uint64_t mImages = 0;
+		uint64_t mAnnotationCount = 0;
+	};
+
+	void DatasetExporter::FrameDeleter::operator()(AVFrame* frame) const
+	{
+		av_frame_free(&frame);
+	}
+
+	DatasetExporter::DatasetExporter() : mDecodedQueue(QUEUE_CAPACITY), mEncodedQueue(QUEUE_CAPACITY)
+	{
+	}
+
+	DatasetExporter::~DatasetExporter()
+	{
+		Cancel();
+		Join();
+	}
+
+	DatasetSplit DatasetExporter::GetSplit(const std::string& key, uint32_t seed, float valFraction)
+	{
+		// FNV-1a over the seed and key, then a final mix so the top bits are spread
+		uint64_t hash = 14695981039346656037ull;
+		for (int i = 0; i < 4; i++)
+			hash = (hash ^ ((seed >> (i * 8)) & 0xFF)) * 1099511628211ull;
+		for (char c : key)
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		double value = (hash >> 11) * (1.0 / 9007199254740992.0);
+		return value < valFraction ? DatasetSplit::Val : DatasetSplit::Train;
+	}
+
+	bool DatasetExporter::Start(const AnnotationStore& store, const DatasetOptions& options)
+	{
+		if (IsRunning())
+			return false;
+		Join();
+
+		// Copied out now, the store is not safe to read from the workers
+		mJobs.clear();
+		std::set<uint32_t> classes;
+		std::set<std::string> names;
+		mFramesTotal = 0;
+		mBoxesTotal = 0;
+		for (const auto& summary : store.GetSummaries())
+		{
+			VideoJob job;
+			job.mVideo = summary.mVideo;
+			store.Query(job.mVideo, 0, INT32_MAX, [&](int32_t frame, const AnnotationSpan& span) {
+				job.mFrames.push_back(frame);
+				job.mOffsets.push_back(static_cast<uint32_t>(job.mBoxes.size()));
+				for (size_t i = 0; i < span.mCount; i++)
+				{
+					job.mBoxes.push_back(span[i]);
+					classes.insert(span.mClass[i]);
+				}
+			});
+			if (job.mFrames.empty())
+				continue;
+			job.mOffsets.push_back(static_cast<uint32_t>(job.mBoxes.size()));
+
+			job.mName = FrameArchive::MakeUniqueName(job.mVideo, names);
+			mFramesTotal += job.mFrames.size();
+			mBoxesTotal += job.mBoxes.size();
+			mJobs.push_back(std::move(job));
+		}
+		if (mJobs.empty())
+			return false;
+
+		std::error_code error;
+		for (const char* split : SPLIT_NAMES)
+		{
+			std::filesystem::create_directories(options.mOutputDir / "images" / split, error);
+			if (!error && options.mYOLO)
+				std::filesystem::create_directories(options.mOutputDir / "labels" / split, error);
+			if (error)
+				break;
+		}
+		if (!error && options.mCOCO)
+			std::filesystem::create_directories(options.mOutputDir / "annotations", error);
+		if (error)
+		{
+			FRAMEEX_CORE_ERROR("DatasetExporter: unable to create {}: {}", options.mOutputDir.string(), error.message());
+			mJobs.clear();
+			return false;
+		}
+
+		mOptions = options;
+		mOptions.mJPEGQuality = std::clamp(mOptions.mJPEGQuality, 2, 31);
+		mOptions.mValFraction = std::clamp(mOptions.mValFraction, 0.f, 1.f);
+		mClasses.assign(classes.begin(), classes.end());
+		mDecodedQueue.Reopen();
+		mEncodedQueue.Reopen();
+		mCancel = false;
+		mNextJob = 0;
+		mVideosDone = 0;
+		mDecodedFrames = 0;
+		mDecoded = 0;
+		mEncoded = 0;
+		mTrain = 0;
+		mVal = 0;
+		mBytesWritten = 0;
+		mFailed = 0;
+		mDecodeMicroseconds = 0;
+		mEncodeMicroseconds = 0;
+		mWriteMicroseconds = 0;
+		mElapsedMilliseconds = -1;
+		mStarted = std::chrono::steady_clock::now();
+
+		// Conversion runs with the encoders, together they cost about as much as decoding
+		int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		mDecodeWorkerCount = std::clamp(cores / 2, 1, static_cast<int>(std::min<size_t>(mJobs.size(), 8)));
+		mEncodeWorkerCount = std::clamp(cores / 2, 1, 8);
+		mDecodeWorkers = mDecodeWorkerCount;
+		mEncodeWorkers = mEncodeWorkerCount;
+		mActiveStages = mDecodeWorkerCount + mEncodeWorkerCount + 1;
+		for (int i = 0; i < mDecodeWorkerCount; i++)
+			mThreads.emplace_back(&DatasetExporter::DecodeWorker, this);
+		for (int i = 0; i < mEncodeWorkerCount; i++)
+			mThreads.emplace_back(&DatasetExporter::EncodeWorker, this);
+		mThreads.emplace_back(&DatasetExporter::WriteWorker, this);
+		return true;
+	}
+
+	void DatasetExporter::Cancel()
+	{
+		mCancel = true;
+		mDecodedQueue.Abort();
+		mEncodedQueue.Abort();
+	}
+
+	void DatasetExporter::Join()
+	{
+		for (auto& thread : mThreads)
+			thread.join();
+		mThreads.clear();
+	}
+
+	DatasetStats DatasetExporter::GetStats() const
+	{
+		DatasetStats stats;
+		stats.mVideosDone = mVideosDone;
+		stats.mVideosTotal = mJobs.size();
+		stats.mFramesTotal = mFramesTotal;
+		stats.mBoxesTotal = mBoxesTotal;
+		stats.mDecodedFrames = mDecodedFrames;
+		stats.mTrain = mTrain;
+		stats.mVal = mVal;
+		stats.mBytesWritten = mBytesWritten;
+		stats.mFailed = mFailed;
+		stats.mRunning = IsRunning();
+		int64_t elapsed = mElapsedMilliseconds;
+		stats.mElapsedSeconds = elapsed >= 0 ? elapsed / 1000.0 : std::chrono::duration<double>(std::chrono::steady_clock::now() - mStarted).count();
+		stats.mDecode = { mDecoded, mDecodeWorkerCount, mDecodeMicroseconds / 1e6 };
+		stats.mEncode = { mEncoded, mEncodeWorkerCount, mEncodeMicroseconds / 1e6 };
+		stats.mWrite = { stats.mTrain + stats.mVal, 1, mWriteMicroseconds / 1e6 };
+		stats.mDecodedQueue = { mDecodedQueue.Size(), mDecodedQueue.Capacity(), mDecodedQueue.GetFullWaits() };
+		stats.mEncodedQueue = { mEncodedQueue.Size(), mEncodedQueue.Capacity(), mEncodedQueue.GetFullWaits() };
+		return stats;
+	}
+
+	void DatasetExporter::DecodeWorker()
+	{
+		while (!mCancel)
+		{
+			size_t job = mNextJob++;
+			if (job >= mJobs.size())
+				break;
+			ExportVideo(mJobs[job]);
+			mVideosDone++;
+		}
+		// The last decoder out lets the encoders drain and finish
+		if (--mDecodeWorkers == 0)
+			mDecodedQueue.Close();
+		mActiveStages--;
+	}
+
+	void DatasetExporter::ExportVideo(const VideoJob& job)
+	{
+		auto started = std::chrono::steady_clock::now();
+		int64_t waited = 0;
+		// Same as batch extraction, one thread per video at full quality
+		DecodePolicy policy = DecodePolicy::For(DecodeUseCase::Thumbnail);
+		policy.mSkipLoopFilter = false;
+		DecodeSession session;
+		if (!session.Open(job.mVideo, policy))
+		{
+			FRAMEEX_CORE_WARN("DatasetExporter: unable to decode {}: {}", job.mVideo.string(), session.GetError());
+			mFailed += job.mFrames.size();
+			return;
+		}
+
+		VideoIndex index;
+		if (!index.Load(job.mVideo))
+		{
+			index.Build(session.GetFormatContext(), session.GetStreamIndex());
+			index.Save(job.mVideo);
+		}
+		// Labelled frames past the end of the stream are never found
+		size_t count = std::lower_bound(job.mFrames.begin(), job.mFrames.end(), static_cast<int32_t>(index.GetFrameCount())) - job.mFrames.begin();
+		mFailed += job.mFrames.size() - count;
+
+		uint32_t seekedTo = 0;
+		auto seekTo = [&](uint32_t frameIndex) {
+			seekedTo = index.GetKeyframe(frameIndex);
+			session.Seek(index.GetEntry(seekedTo).mPTS);
+		};
+		if (count > 0)
+			seekTo(static_cast<uint32_t>(job.mFrames[0]));
+
+		AVFrame* frame = av_frame_alloc();
+		size_t next = 0;
+		bool done = count == 0;
+		while (!done && !mCancel && session.ReceiveFrame(frame) == 0)
+		{
+			mDecodedFrames++;
+			uint32_t frameIndex = index.FindFrame(DecodeSession::GetPTS(frame));
+			// Labelled frames the decoder went past were not in the stream
+			while (next < count && static_cast<uint32_t>(job.mFrames[next]) < frameIndex)
+			{
+				mFailed++;
+				next++;
+			}
+			if (next < count && static_cast<uint32_t>(job.mFrames[next]) == frameIndex)
+			{
+				LabelledFrame item;
+				item.mFrame.reset(av_frame_clone(frame));
+				item.mJob = &job;
+				item.mItem = static_cast<uint32_t>(next++);
+				mDecoded++;
+				auto pushed = std::chrono::steady_clock::now();
+				if (!item.mFrame || !mDecodedQueue.Push(std::move(item)))
+					done = true;
+				waited += MicrosecondsSince(pushed);
+			}
+			av_frame_unref(frame);
+			if (next == count)
+				done = true;
+			// A later GOP is reached sooner by seeking than by decoding the gap
+			else if (!session.IsDraining() && index.GetKeyframe(static_cast<uint32_t>(job.mFrames[next])) > std::max(seekedTo, frameIndex + 1))
+				seekTo(static_cast<uint32_t>(job.mFrames[next]));
+		}
+		if (!mCancel)
+			mFailed += count - next;
+
+		av_frame_free(&frame);
+		mDecodeMicroseconds += MicrosecondsSince(started) - waited;
+	}
+
+	void DatasetExporter::EncodeWorker()
+	{
+		ImageEncoder encoder(mOptions.mFormat, mOptions.mJPEGQuality);
+		LabelledFrame item;
+		// Keeps draining without an encoder so the decoders can finish
+		while (mDecodedQueue.Pop(item))
+		{
+			if (!encoder.IsAvailable())
+				continue;
+			auto started = std::chrono::steady_clock::now();
+			EncodedFrame encoded;
+			encoded.mJob = item.mJob;
+			encoded.mItem = item.mItem;
+			encoded.mSourceWidth = item.mFrame->width;
+			encoded.mSourceHeight = item.mFrame->height;
+			FramePtr converted(ImageEncoder::Convert(item.mFrame.get(), mOptions.mFormat, mOptions.mMaxWidth));
+			item.mFrame.reset();
+			if (!converted || !encoder.Encode(converted.get(), encoded.mData))
+			{
+				mFailed++;
+				continue;
+			}
+			encoded.mWidth = converted->width;
+			encoded.mHeight = converted->height;
+			converted.reset();
+
+			// Centre and size normalised to the image, so scaling does not change them
+			if (mOptions.mYOLO)
+			{
+				const VideoJob& job = *encoded.mJob;
+				float width = static_cast<float>(encoded.mSourceWidth);
+				float height = static_cast<float>(encoded.mSourceHeight);
+				for (uint32_t i = job.mOffsets[encoded.mItem]; i < job.mOffsets[encoded.mItem + 1]; i++)
+				{
+					BoundingBox box;
+					if (!ClampBox(job.mBoxes[i].mBox, encoded.mSourceWidth, encoded.mSourceHeight, box))
+						continue;
+					char line[96] = {};
+					std::snprintf(line, sizeof(line), "%u %.6f %.6f %.6f %.6f\n", job.mBoxes[i].mClass,
+						(box.minX + box.maxX) * 0.5f / width, (box.minY + box.maxY) * 0.5f / height,
+						(box.maxX - box.minX) / width, (box.maxY - box.minY) / height);
+					encoded.mLabels += line;
+				}
+			}
+			mEncodeMicroseconds += MicrosecondsSince(started);
+			mEncoded++;
+			if (!mEncodedQueue.Push(std::move(encoded)))
+				break;
+		}
+		if (--mEncodeWorkers == 0)
+			mEncodedQueue.Close();
+		mActiveStages--;
+	}
+
+	// One writer keeps the disk writing sequentially and the JSON in one piece
+	void DatasetExporter::WriteWorker()
+	{
+		const std::filesystem::path& root = mOptions.mOutputDir;
+		CocoWriter coco[2];
+		if (mOptions.mCOCO)
+		{
+			for (size_t split = 0; split < 2; split++)
+			{
+				if (!coco[split].Open(root / "annotations" / (std::string("instances_") + SPLIT_NAMES[split] + ".json")))
+					mFailed++;
+			}
+		}
+
+		uint64_t imageID = 0;
+		EncodedFrame encoded;
+		while (mEncodedQueue.Pop(encoded))
+		{
+			auto started = std::chrono::steady_clock::now();
+			const VideoJob& job = *encoded.mJob;
+			char number[32] = {};
+			std::snprintf(number, sizeof(number), "_%07d", job.mFrames[encoded.mItem]);
+			std::string stem = job.mName + number;
+			DatasetSplit split = GetSplit(mOptions.mSplitByVideo ? job.mName : stem, mOptions.mSeed, mOptions.mValFraction);
+			const char* splitName = SPLIT_NAMES[static_cast<size_t>(split)];
+			std::string fileName = stem + FrameArchive::GetExtension(mOptions.mFormat);
+
+			std::filesystem::path output = root / "images" / splitName / fileName;
+			std::ofstream file(output, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(encoded.mData.data()), encoded.mData.size());
+			if (!file)
+			{
+				FRAMEEX_CORE_WARN("DatasetExporter: unable to write {}", output.string());
+				mFailed++;
+				mWriteMicroseconds += MicrosecondsSince(started);
+				continue;
+			}
+			file.close();
+			if (mOptions.mYOLO)
+			{
+				// Frames whose boxes all fell outside still get an empty file, YOLO reads it as background
+				std::ofstream labels(root / "labels" / splitName / (stem + ".txt"), std::ios::binary | std::ios::trunc);
+				labels << encoded.mLabels;
+				if (!labels)
+					mFailed++;
+			}
+
+			CocoWriter& writer = coco[static_cast<size_t>(split)];
+			if (writer.IsOpen())
+			{
+				writer.AddImage(++imageID, fileName, encoded.mWidth, encoded.mHeight);
+				float scaleX = static_cast<float>(encoded.mWidth) / encoded.mSourceWidth;
+				float scaleY = static_cast<float>(encoded.mHeight) / encoded.mSourceHeight;
+				for (uint32_t i = job.mOffsets[encoded.mItem]; i < job.mOffsets[encoded.mItem + 1]; i++)
+				{
+					BoundingBox box;
+					if (ClampBox(job.mBoxes[i].mBox, encoded.mSourceWidth, encoded.mSourceHeight, box))
+						writer.AddAnnotation(imageID, job.mBoxes[i].mClass + 1, box.minX * scaleX, box.minY * scaleY, (box.maxX - box.minX) * scaleX, (box.maxY - box.minY) * scaleY);
+				}
+			}
+			(split == DatasetSplit::Val ? mVal : mTrain)++;
+			mBytesWritten += encoded.mData.size() + encoded.mLabels.size();
+			mWriteMicroseconds += MicrosecondsSince(started);
+		}
+
+		// A cancelled export still gets valid JSON for what was written
+		for (CocoWriter& writer : coco)
+		{
+			if (writer.IsOpen() && !writer.Close(mClasses))
+				mFailed++;
+		}
+		if (mOptions.mYOLO && !WriteDataYAML())
+			mFailed++;
+		mElapsedMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStarted).count();
+		mActiveStages--;
+	}
+
+	bool DatasetExporter::WriteDataYAML() const
+	{
+		// Runs on the writer thread, nothing here may throw
+		std::error_code error;
+		std::filesystem::path root = std::filesystem::absolute(mOptions.mOutputDir, error);
+		if (error)
+		{
+			FRAMEEX_CORE_WARN("DatasetExporter: unable to resolve {}: {}", mOptions.mOutputDir.string(), error.message());
+			return false;
+		}
+
+		YAML::Emitter emitter;
+		emitter << YAML::BeginMap;
+		emitter << YAML::Key << "path" << YAML::Value << root.generic_string();
+		emitter << YAML::Key << "train" << YAML::Value << "images/train";
+		emitter << YAML::Key << "val" << YAML::Value << "images/val";
+		emitter << YAML::Key << "names" << YAML::Value << YAML::BeginMap;
+		// YOLO takes nc from the number of names and needs every label below
+		// it, so IDs no box uses get a placeholder
+		uint32_t count = mClasses.empty() ? 0 : mClasses.back() + 1;
+		for (uint32_t id = 0, used = 0; id < count; id++)
+		{
+			bool isUsed = used < mClasses.size() && mClasses[used] == id;
+			used += isUsed;
+			emitter << YAML::Key << id << YAML::Value << (isUsed ? std::to_string(id) : "unused_" + std::to_string(id));
+		}
+		emitter << YAML::EndMap;
+		emitter << YAML::EndMap;
+
+		std::filesystem::path path = mOptions.mOutputDir / "data.yaml";
+		std::ofstream file(path);
+		file << emitter.c_str() << "\n";
+		if (!file)
+		{
+			FRAMEEX_CORE_WARN("DatasetExporter: unable to write {}", path.string());
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+/*!
+\file       DecodePolicy.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the decoder threading policies used for each kind of
+			decoding the application does.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/DecodePolicy.hpp>
+#include <thread>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+namespace FrameExtractor
+{
+	// Frame threading stops scaling well past this for H.264 and HEVC
+	static constexpr int MAX_DECODE_THREADS = 16;
+
+	DecodePolicy DecodePolicy::For(DecodeUseCase useCase)
+	{
+		int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+		DecodePolicy policy;
+		policy.mUseCase = useCase;
+		switch (useCase)
+		{
+		case DecodeUseCase::Playback:
+			// Frame threading adds one frame of delay per thread, which the
+			// playback queue hides
+			policy.mThreadCount = std::min(cores, MAX_DECODE_THREADS);
+			policy.mThreadType = FF_THREAD_FRAME | FF_THREAD_SLICE;
+			break;
+		case DecodeUseCase::Scrubbing:
+			// Slice threading returns each frame as soon as it is decoded
+			policy.mThreadCount = std::min(cores, MAX_DECODE_THREADS);
+			policy.mThreadType = FF_THREAD_SLICE;
+			break;
+		case DecodeUseCase::Analysis:
+			policy.mThreadCount = std::clamp(cores - 1, 1, MAX_DECODE_THREADS);
+			policy.mThreadType = FF_THREAD_FRAME | FF_THREAD_SLICE;
+			break;
+		case DecodeUseCase::Thumbnail:
+			// Parallelism comes from decoding several files at once
+			policy.mThreadCount = 1;
+			policy.mThreadType = FF_THREAD_SLICE;
+			policy.mSkipLoopFilter = true;
+			break;
+		case DecodeUseCase::Grid:
+			// A handful of streams share the cores, and the loop filter's
+			// artefacts do not survive being shrunk into a tile
+			policy.mThreadCount = std::clamp(cores / 4, 1, 4);
+			policy.mThreadType = FF_THREAD_FRAME | FF_THREAD_SLICE;
+			policy.mSkipLoopFilter = true;
+			break;
+		case DecodeUseCase::Background:
+			// Decodes on the calling thread alone, so lowering that thread's
+			// priority covers all of the work. The results are shrunk far
+			// past where the loop filter would show.
+			policy.mThreadCount = 1;
+			policy.mThreadType = FF_THREAD_SLICE;
+			policy.mSkipLoopFilter = true;
+			break;
+		}
+		return policy;
+	}
+
+	const char* DecodePolicy::GetName(DecodeUseCase useCase)
+	{
+		switch (useCase)
+		{
+		case DecodeUseCase::Playback:
+			return "Playback";
+		case DecodeUseCase::Scrubbing:
+			return "Scrubbing";
+		case DecodeUseCase::Analysis:
+			return "Analysis";
+		case DecodeUseCase::Thumbnail:
+			return "Thumbnail";
+		case DecodeUseCase::Grid:
+			return "Grid";
+		case DecodeUseCase::Background:
+			return "Background";
+		}
+		return "Unknown";
+	}
+
+	void DecodePolicy::Apply(AVCodecContext* codecContext) const
+	{
+		codecContext->thread_count = mThreadCount;
+		codecContext->thread_type = mThreadType;
+		if (mSkipLoopFilter)
+			codecContext->skip_loop_filter = AVDISCARD_ALL;
+		if (mLowres > 0 && codecContext->codec)
+			codecContext->lowres = std::min(mLowres, static_cast<int>(codecContext->codec->max_lowres));
+	}
+}
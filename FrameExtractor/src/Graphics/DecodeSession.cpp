@@ -0,0 +1,181 @@
+/******************************************************************************
+/*!
+\file       DecodeSession.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Decode Session class, a demuxer and decoder over the
+			video stream of one file for the background decoding passes.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace FrameExtractor
+{
+	DecodeSession::~DecodeSession()
+	{
+		Close();
+	}
+
+	bool DecodeSession::OpenInput(const std::filesystem::path& path, bool probe)
+	{
+		Close();
+		int ret = avformat_open_input(&mFormatContext, path.string().c_str(), nullptr, nullptr);
+		if (ret != 0)
+		{
+			char error[AV_ERROR_MAX_STRING_SIZE] = {};
+			av_strerror(ret, error, sizeof(error));
+			mError = error;
+			return false;
+		}
+		if (probe)
+			avformat_find_stream_info(mFormatContext, nullptr);
+
+		mStreamIndex = av_find_best_stream(mFormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+		if (mStreamIndex < 0)
+		{
+			Close();
+			mError = "No video stream";
+			return false;
+		}
+		mStream = mFormatContext->streams[mStreamIndex];
+		for (unsigned int i = 0; i < mFormatContext->nb_streams; i++)
+		{
+			if ((int)i != mStreamIndex)
+				mFormatContext->streams[i]->discard = AVDISCARD_ALL;
+		}
+		mPacket = av_packet_alloc();
+		return true;
+	}
+
+	bool DecodeSession::OpenDecoder(const DecodePolicy& policy, const std::function<void(AVCodecContext*)>& configure)
+	{
+		if (!mStream)
+			return false;
+
+		const AVCodec* codec = avcodec_find_decoder(mStream->codecpar->codec_id);
+		mCodecContext = codec ? avcodec_alloc_context3(codec) : nullptr;
+		bool opened = false;
+		if (mCodecContext && avcodec_parameters_to_context(mCodecContext, mStream->codecpar) >= 0)
+		{
+			policy.Apply(mCodecContext);
+			FramePool::Install(mCodecContext);
+			if (configure)
+				configure(mCodecContext);
+			opened = avcodec_open2(mCodecContext, codec, nullptr) >= 0;
+		}
+		if (!opened)
+		{
+			avcodec_free_context(&mCodecContext);
+			mError = "Unsupported codec";
+			return false;
+		}
+		mDraining = false;
+		return true;
+	}
+
+	bool DecodeSession::Open(const std::filesystem::path& path, const DecodePolicy& policy, bool probe, const std::function<void(AVCodecContext*)>& configure)
+	{
+		if (!OpenInput(path, probe))
+			return false;
+		if (!OpenDecoder(policy, configure))
+		{
+			std::string error = mError;
+			Close();
+			mError = error;
+			return false;
+		}
+		return true;
+	}
+
+	void DecodeSession::Close()
+	{
+		av_packet_free(&mPacket);
+		avcodec_free_context(&mCodecContext);
+		if (mFormatContext)
+			avformat_close_input(&mFormatContext);
+		mStream = nullptr;
+		mStreamIndex = -1;
+		mDraining = false;
+		mDecodeErrors = 0;
+		mError.clear();
+	}
+
+	int DecodeSession::ReadPacket()
+	{
+		int ret = 0;
+		while ((ret = av_read_frame(mFormatContext, mPacket)) >= 0)
+		{
+			if (mPacket->stream_index == mStreamIndex)
+				return 0;
+			av_packet_unref(mPacket);
+		}
+		return ret;
+	}
+
+	int DecodeSession::ReceiveFrame(AVFrame* frame, int maxPackets)
+	{
+		for (int packets = 0;;)
+		{
+			int ret = avcodec_receive_frame(mCodecContext, frame);
+			if (ret == 0 || ret == AVERROR_EOF)
+				return ret;
+			// A damaged frame does not end the pass, the next GOP may decode. The
+			// decoder is fed a packet before it is asked again, so an error that
+			// keeps repeating still runs into maxPackets and the end of the file.
+			if (ret != AVERROR(EAGAIN))
+				mDecodeErrors++;
+			if (mDraining)
+				return AVERROR_EOF;
+			if (packets++ >= maxPackets)
+				return AVERROR(EAGAIN);
+
+			if (ReadPacket() < 0)
+			{
+				// Whatever the decoder still holds comes out before the end
+				avcodec_send_packet(mCodecContext, nullptr);
+				mDraining = true;
+				continue;
+			}
+			if (!mPacketFilter || mPacketFilter(*mPacket))
+			{
+				ret = avcodec_send_packet(mCodecContext, mPacket);
+				if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+					mDecodeErrors++;
+			}
+			av_packet_unref(mPacket);
+		}
+	}
+
+	void DecodeSession::Seek(int64_t pts)
+	{
+		av_seek_frame(mFormatContext, mStreamIndex, pts, AVSEEK_FLAG_BACKWARD);
+		if (mCodecContext)
+			avcodec_flush_buffers(mCodecContext);
+		mDraining = false;
+	}
+
+	int64_t DecodeSession::GetPTS(const AVFrame* frame)
+	{
+		return frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+	}
+
+	double DecodeSession::GetTime(int64_t pts) const
+	{
+		int64_t startPTS = mStream->start_time != AV_NOPTS_VALUE ? mStream->start_time : 0;
+		return std::max(0.0, (pts - startPTS) * av_q2d(mStream->time_base));
+	}
+
+	double DecodeSession::GetFrameRate() const
+	{
+		AVRational rate = av_guess_frame_rate(mFormatContext, mStream, nullptr);
+		return rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 0.0;
+	}
+}
@@ -0,0 +1,171 @@
+/******************************************************************************
+/*!
+\file       Filmstrip.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Filmstrip class, evenly spaced keyframe samples of a
+			video decoded in the background into one texture atlas.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/Filmstrip.hpp>
+#include <Graphics/Video.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavutil/imgutils.h>
+}
+
+namespace FrameExtractor
+{
+	// Packets read after a seek while waiting for the keyframe to come out
+	static constexpr int MAX_SEEK_PACKETS = 256;
+
+	Filmstrip::Filmstrip(const Video& video, uint32_t sampleCount) : mPath(video.GetPath()), mIndex(video.GetIndex())
+	{
+		mSampleCount = std::min(sampleCount, mIndex.GetFrameCount());
+		mSampleWidth = std::max(1u, std::min(SAMPLE_WIDTH, video.GetWidth()));
+		mSampleHeight = video.GetWidth() ? std::max(1u, (mSampleWidth * video.GetHeight() + video.GetWidth() / 2) / video.GetWidth()) : 1;
+		mColumns = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(mSampleCount)))));
+		uint32_t rows = std::max(1u, (mSampleCount + mColumns - 1) / mColumns);
+
+		uint32_t atlasWidth = mColumns * mSampleWidth;
+		uint32_t atlasHeight = rows * mSampleHeight;
+		mAtlas = MakeRef<Texture>(atlasWidth, atlasHeight);
+		mSamples.resize(mSampleCount);
+		mReady.resize(mSampleCount, false);
+		for (uint32_t slot = 0; slot < mSampleCount; slot++)
+		{
+			Sample& sample = mSamples[slot];
+			uint32_t x = (slot % mColumns) * mSampleWidth;
+			uint32_t y = (slot / mColumns) * mSampleHeight;
+			sample.mU0 = static_cast<float>(x) / atlasWidth;
+			sample.mV0 = static_cast<float>(y) / atlasHeight;
+			sample.mU1 = static_cast<float>(x + mSampleWidth) / atlasWidth;
+			sample.mV1 = static_cast<float>(y + mSampleHeight) / atlasHeight;
+		}
+
+		if (mSampleCount > 0)
+			mThread = std::thread(&Filmstrip::DecodeLoop, this);
+	}
+
+	Filmstrip::~Filmstrip()
+	{
+		mStop = true;
+		if (mThread.joinable())
+			mThread.join();
+	}
+
+	void Filmstrip::Update()
+	{
+		std::vector<Decoded> decoded;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			decoded.swap(mDecoded);
+		}
+		for (const auto& sample : decoded)
+		{
+			mAtlas->UpdateRegion((sample.mSlot % mColumns) * mSampleWidth, (sample.mSlot / mColumns) * mSampleHeight, mSampleWidth, mSampleHeight, sample.mPixels.data());
+			mSamples[sample.mSlot].mFrame = sample.mFrame;
+			if (!mReady[sample.mSlot])
+			{
+				mReady[sample.mSlot] = true;
+				mReadyCount++;
+			}
+		}
+	}
+
+	const Filmstrip::Sample* Filmstrip::GetSample(uint32_t slot) const
+	{
+		if (mReadyCount == 0 || slot >= mSampleCount)
+			return nullptr;
+		// Until a slot is decoded it borrows its nearest decoded neighbour
+		for (uint32_t distance = 0; distance < mSampleCount; distance++)
+		{
+			if (slot >= distance && mReady[slot - distance])
+				return &mSamples[slot - distance];
+			if (slot + distance < mSampleCount && mReady[slot + distance])
+				return &mSamples[slot + distance];
+		}
+		return nullptr;
+	}
+
+	std::vector<uint32_t> Filmstrip::GetRefinementOrder() const
+	{
+		// Midpoints breadth first, each pass halves the gaps between samples
+		std::vector<uint32_t> order;
+		order.reserve(mSampleCount);
+		std::deque<std::pair<uint32_t, uint32_t>> ranges = { { 0, mSampleCount } };
+		while (!ranges.empty())
+		{
+			auto [begin, end] = ranges.front();
+			ranges.pop_front();
+			if (begin >= end)
+				continue;
+			uint32_t middle = begin + (end - begin) / 2;
+			order.push_back(middle);
+			ranges.emplace_back(begin, middle);
+			ranges.emplace_back(middle + 1, end);
+		}
+		return order;
+	}
+
+	void Filmstrip::DecodeLoop()
+	{
+		DecodeSession session;
+		if (!session.Open(mPath, DecodePolicy::For(DecodeUseCase::Thumbnail), false, [](AVCodecContext* codecContext) { codecContext->skip_frame = AVDISCARD_NONKEY; }))
+		{
+			FRAMEEX_CORE_WARN("Filmstrip: unable to decode {}: {}", mPath.string(), session.GetError());
+			return;
+		}
+		session.SetPacketFilter([](const AVPacket& packet) { return (packet.flags & AV_PKT_FLAG_KEY) != 0; });
+
+		AVFrame* frame = av_frame_alloc();
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = nullptr;
+		// Short clips and long GOPs land several slots on the same keyframe
+		std::map<uint32_t, std::vector<uint8_t>> decodedKeyframes;
+		uint32_t frameCount = mIndex.GetFrameCount();
+
+		for (uint32_t slot : GetRefinementOrder())
+		{
+			if (mStop)
+				break;
+
+			// Middle of the slot's share of the video
+			uint32_t target = static_cast<uint32_t>((static_cast<uint64_t>(slot) * 2 + 1) * frameCount / (2ull * mSampleCount));
+			uint32_t keyframe = mIndex.GetKeyframe(std::min(target, frameCount - 1));
+			auto known = decodedKeyframes.find(keyframe);
+			if (known == decodedKeyframes.end())
+			{
+				session.Seek(mIndex.GetEntry(keyframe).mPTS);
+				bool decoded = session.ReceiveFrame(frame, MAX_SEEK_PACKETS) == 0;
+				if (!decoded)
+					continue;
+
+				scaler = scaler ? scaler : pool.AcquireScaler(frame->width, frame->height, frame->format, mSampleWidth, mSampleHeight, AV_PIX_FMT_RGB24, SWS_AREA);
+				if (!scaler)
+				{
+					av_frame_unref(frame);
+					break;
+				}
+				std::vector<uint8_t> pixels(static_cast<size_t>(mSampleWidth) * mSampleHeight * 3);
+				uint8_t* dstData[4] = {};
+				int dstLinesize[4] = {};
+				av_image_fill_arrays(dstData, dstLinesize, pixels.data(), AV_PIX_FMT_RGB24, mSampleWidth, mSampleHeight, 1);
+				sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+				av_frame_unref(frame);
+				known = decodedKeyframes.emplace(keyframe, std::move(pixels)).first;
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mDecoded.push_back({ slot, keyframe, known->second });
+		}
+
+		pool.ReleaseScaler(scaler);
+		av_frame_free(&frame);
+	}
+}
@@ -0,0 +1,244 @@
+/******************************************************************************
+/*!
+\file       FrameArchive.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Frame Archive classes, a single file of encoded frames
+			written in one sequential pass and read back memory mapped.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/FrameArchive.hpp>
+
+namespace FrameExtractor
+{
+	static constexpr uint32_t ARCHIVE_MAGIC = 0x50585246; // "FRXP"
+	static constexpr uint32_t ARCHIVE_VERSION = 2;
+
+	struct ArchiveHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+	};
+
+	// Records, then video records, then the path and name strings, then this
+	struct ArchiveFooter
+	{
+		uint64_t mIndexOffset;
+		uint64_t mRecordCount;
+		uint64_t mVideoCount;
+		uint32_t mMagic;
+		uint32_t mVersion;
+	};
+
+	const char* FrameArchive::GetExtension(ImageFormat format)
+	{
+		return format == ImageFormat::PNG ? ".png" : ".jpg";
+	}
+
+	std::string FrameArchive::MakeUniqueName(const std::filesystem::path& video, std::set<std::string>& taken)
+	{
+		std::string stem = video.stem().string();
+		std::string name = stem;
+		for (int n = 2; !taken.insert(name).second; n++)
+			name = stem + "_" + std::to_string(n);
+		return name;
+	}
+
+	std::string FrameArchive::GetFileName(const std::string& name, uint64_t frameIndex, ImageFormat format)
+	{
+		char number[32] = {};
+		std::snprintf(number, sizeof(number), "_%07llu", static_cast<unsigned long long>(frameIndex));
+		return name + number + GetExtension(format);
+	}
+
+	FrameArchiveWriter::~FrameArchiveWriter()
+	{
+		if (IsOpen())
+			Close();
+	}
+
+	bool FrameArchiveWriter::Open(const std::filesystem::path& path)
+	{
+		if (IsOpen())
+			Close();
+		mPath = path;
+		mRecords.clear();
+		mVideos.clear();
+		mNames.clear();
+		mVideoLookup.clear();
+		mFile.open(path, std::ios::binary | std::ios::trunc);
+		if (!mFile)
+		{
+			FRAMEEX_CORE_ERROR("Unable to create frame archive {}", path.string());
+			return false;
+		}
+		ArchiveHeader header{ ARCHIVE_MAGIC, ARCHIVE_VERSION };
+		mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		mOffset = sizeof(header);
+		return static_cast<bool>(mFile);
+	}
+
+	bool FrameArchiveWriter::Append(const std::filesystem::path& video, const std::string& name, uint32_t frameIndex, int64_t pts, double time, ImageFormat format, const uint8_t* data, size_t size)
+	{
+		if (!IsOpen())
+			return false;
+
+		std::string key = video.generic_string();
+		auto [it, added] = mVideoLookup.try_emplace(key, static_cast<uint32_t>(mVideos.size()));
+		if (added)
+		{
+			mVideos.push_back(key);
+			mNames.push_back(name);
+		}
+
+		mFile.write(reinterpret_cast<const char*>(data), size);
+		if (!mFile)
+			return false;
+		FrameArchive::Record record{};
+		record.mOffset = mOffset;
+		record.mSize = size;
+		record.mPTS = pts;
+		record.mTime = time;
+		record.mFrameIndex = frameIndex;
+		record.mVideo = it->second;
+		record.mFormat = static_cast<uint32_t>(format);
+		mRecords.push_back(record);
+		mOffset += size;
+		return true;
+	}
+
+	bool FrameArchiveWriter::Close()
+	{
+		if (!IsOpen())
+			return false;
+
+		// The records are read in place from the mapping, keep them aligned
+		static constexpr char padding[8] = {};
+		size_t pad = (8 - mOffset % 8) % 8;
+		mFile.write(padding, pad);
+		uint64_t indexOffset = mOffset + pad;
+
+		uint64_t pathOffset = indexOffset + mRecords.size() * sizeof(FrameArchive::Record) + mVideos.size() * sizeof(FrameArchive::VideoRecord);
+		mFile.write(reinterpret_cast<const char*>(mRecords.data()), mRecords.size() * sizeof(FrameArchive::Record));
+		uint64_t nameOffset = pathOffset;
+		for (const auto& video : mVideos)
+			nameOffset += video.size();
+		for (size_t i = 0; i < mVideos.size(); i++)
+		{
+			FrameArchive::VideoRecord record{ pathOffset, mVideos[i].size(), nameOffset, mNames[i].size() };
+			mFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+			pathOffset += mVideos[i].size();
+			nameOffset += mNames[i].size();
+		}
+		for (const auto& video : mVideos)
+			mFile.write(video.data(), video.size());
+		for (const auto& name : mNames)
+			mFile.write(name.data(), name.size());
+		ArchiveFooter footer{ indexOffset, mRecords.size(), mVideos.size(), ARCHIVE_MAGIC, ARCHIVE_VERSION };
+		mFile.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+		bool written = static_cast<bool>(mFile);
+		mFile.close();
+		if (!written)
+			FRAMEEX_CORE_ERROR("Unable to finish frame archive {}", mPath.string());
+		mRecords.clear();
+		mVideos.clear();
+		mNames.clear();
+		mVideoLookup.clear();
+		return written;
+	}
+
+	bool FrameArchive::Open(const std::filesystem::path& path)
+	{
+		Close();
+		if (!mFile.Open(path))
+			return false;
+
+		const uint8_t* data = mFile.GetData();
+		size_t size = mFile.GetSize();
+		const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(data);
+		const ArchiveFooter* footer = size >= sizeof(ArchiveHeader) + sizeof(ArchiveFooter) ? reinterpret_cast<const ArchiveFooter*>(data + size - sizeof(ArchiveFooter)) : nullptr;
+		uint64_t indexEnd = size - sizeof(ArchiveFooter);
+		if (!footer || header->mMagic != ARCHIVE_MAGIC || footer->mMagic != ARCHIVE_MAGIC || footer->mVersion != ARCHIVE_VERSION
+			|| footer->mIndexOffset > indexEnd || footer->mIndexOffset % 8 != 0
+			|| footer->mRecordCount > (indexEnd - footer->mIndexOffset) / sizeof(Record)
+			|| footer->mVideoCount > (indexEnd - footer->mIndexOffset - footer->mRecordCount * sizeof(Record)) / sizeof(VideoRecord))
+		{
+			FRAMEEX_CORE_WARN("{} is not a finished frame archive", path.string());
+			mFile.Close();
+			return false;
+		}
+		mIndexOffset = footer->mIndexOffset;
+		mRecordCount = footer->mRecordCount;
+		mVideoCount = footer->mVideoCount;
+		return true;
+	}
+
+	void FrameArchive::Close()
+	{
+		mFile.Close();
+		mRecordCount = 0;
+		mVideoCount = 0;
+		mIndexOffset = 0;
+	}
+
+	FrameArchive::Entry FrameArchive::GetEntry(size_t index) const
+	{
+		Entry entry;
+		if (index >= mRecordCount)
+			return entry;
+
+		const uint8_t* data = mFile.GetData();
+		size_t size = mFile.GetSize();
+		const Record& record = reinterpret_cast<const Record*>(data + mIndexOffset)[index];
+		if (record.mOffset + record.mSize <= mIndexOffset)
+		{
+			entry.mData = data + record.mOffset;
+			entry.mSize = record.mSize;
+		}
+		if (record.mVideo < mVideoCount)
+		{
+			const VideoRecord& video = reinterpret_cast<const VideoRecord*>(data + mIndexOffset + mRecordCount * sizeof(Record))[record.mVideo];
+			if (video.mPathOffset + video.mPathLength <= size)
+				entry.mVideo = std::string_view(reinterpret_cast<const char*>(data + video.mPathOffset), video.mPathLength);
+			if (video.mNameOffset + video.mNameLength <= size)
+				entry.mName = std::string_view(reinterpret_cast<const char*>(data + video.mNameOffset), video.mNameLength);
+		}
+		entry.mFrameIndex = record.mFrameIndex;
+		entry.mPTS = record.mPTS;
+		entry.mTime = record.mTime;
+		entry.mFormat = static_cast<ImageFormat>(record.mFormat);
+		return entry;
+	}
+
+	size_t FrameArchive::Unpack(const std::filesystem::path& directory, std::atomic<size_t>* progress, const std::atomic<bool>* cancel) const
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (ec)
+		{
+			FRAMEEX_CORE_ERROR("Unable to create {}: {}", directory.string(), ec.message());
+			return 0;
+		}
+
+		size_t written = 0;
+		for (size_t i = 0; i < mRecordCount && !(cancel && *cancel); i++)
+		{
+			Entry entry = GetEntry(i);
+			if (entry.mData && !entry.mName.empty())
+			{
+				// The name the batch gave the video, archive order need not be batch order
+				std::ofstream file(directory / GetFileName(std::string(entry.mName), entry.mFrameIndex, entry.mFormat), std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(entry.mData), entry.mSize);
+				if (file)
+					written++;
+			}
+			if (progress)
+				(*progress)++;
+		}
+		return written;
+	}
+}
@@ -0,0 +1,111 @@
+/******************************************************************************
+/*!
+\file       FrameCache.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Frame Cache class, a memory bounded LRU cache of
+			converted frames keyed by frame index.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/FrameCache.hpp>
+
+namespace FrameExtractor
+{
+	FrameCache::FrameCache(size_t budget) : mBudget(budget)
+	{
+	}
+
+	const CachedFrame* FrameCache::Get(uint32_t frameIndex)
+	{
+		auto it = mLookup.find(frameIndex);
+		if (it == mLookup.end())
+		{
+			mMisses++;
+			return nullptr;
+		}
+
+		mHits++;
+		mEntries.splice(mEntries.begin(), mEntries, it->second);
+		return &it->second->second;
+	}
+
+	bool FrameCache::Contains(uint32_t frameIndex) const
+	{
+		return mLookup.contains(frameIndex);
+	}
+
+	CachedFrame* FrameCache::Insert(uint32_t frameIndex, size_t bytes)
+	{
+		if (bytes > mBudget)
+			return nullptr;
+
+		auto existing = mLookup.find(frameIndex);
+		if (existing != mLookup.end())
+		{
+			mBytesUsed -= existing->second->second.mData.size();
+			mSpareBuffers.push_back(std::move(existing->second->second.mData));
+			mEntries.erase(existing->second);
+			mLookup.erase(existing);
+		}
+
+		EvictUntil(mBudget - bytes);
+
+		// Evicted frames are usually the same size, reuse their allocation
+		std::vector<uint8_t> buffer;
+		if (!mSpareBuffers.empty())
+		{
+			buffer = std::move(mSpareBuffers.back());
+			mSpareBuffers.pop_back();
+		}
+		buffer.resize(bytes);
+
+		mEntries.emplace_front(frameIndex, CachedFrame{ std::move(buffer) });
+		mLookup[frameIndex] = mEntries.begin();
+		mBytesUsed += bytes;
+		return &mEntries.front().second;
+	}
+
+	void FrameCache::EvictUntil(size_t budget)
+	{
+		while (mBytesUsed > budget && !mEntries.empty())
+		{
+			auto& [index, cached] = mEntries.back();
+			mBytesUsed -= cached.mData.size();
+			if (mSpareBuffers.empty())
+				mSpareBuffers.push_back(std::move(cached.mData));
+			mLookup.erase(index);
+			mEntries.pop_back();
+			mEvictions++;
+		}
+	}
+
+	void FrameCache::SetBudget(size_t budget)
+	{
+		mBudget = budget;
+		EvictUntil(mBudget);
+		if (mEntries.empty())
+			mSpareBuffers.clear();
+	}
+
+	void FrameCache::Clear()
+	{
+		mEntries.clear();
+		mLookup.clear();
+		mSpareBuffers.clear();
+		mBytesUsed = 0;
+	}
+
+	FrameCacheStats FrameCache::GetStats() const
+	{
+		FrameCacheStats stats;
+		stats.mHits = mHits;
+		stats.mMisses = mMisses;
+		stats.mEvictions = mEvictions;
+		stats.mBytesUsed = mBytesUsed;
+		stats.mBudget = mBudget;
+		stats.mFrames = mEntries.size();
+		return stats;
+	}
+}
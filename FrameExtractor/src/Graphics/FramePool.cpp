@@ -0,0 +1,211 @@
+/******************************************************************************
+/*!
+\file       FramePool.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Frame Pool, a process wide pool of frame buffers and
+			scaler contexts shared by every Video.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace FrameExtractor
+{
+	// Idle scalers kept for geometries nobody is using at the moment
+	static constexpr size_t MAX_IDLE_SCALERS = 8;
+	// One pool per plane per geometry, a few videos' worth
+	static constexpr size_t MAX_BUFFER_POOLS = 24;
+	// Room FFmpeg's own allocator leaves past the end of each plane
+	static constexpr size_t PLANE_PADDING = 16 + 64 - 1;
+
+	FramePool::~FramePool()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		// Pools are freed once the last buffer taken from them is returned
+		for (auto& [key, entry] : mBufferPools)
+			av_buffer_pool_uninit(&entry.mPool);
+		for (auto& [key, scaler] : mIdleScalers)
+			sws_freeContext(scaler);
+		mBufferPools.clear();
+		mIdleScalers.clear();
+	}
+
+	AVBufferRef* FramePool::Allocate(void* opaque, size_t size)
+	{
+		uint8_t* data = static_cast<uint8_t*>(av_malloc(size));
+		if (!data)
+			return nullptr;
+
+		AVBufferRef* buffer = av_buffer_create(data, size, &FramePool::Free, reinterpret_cast<void*>(static_cast<uintptr_t>(size)), 0);
+		if (!buffer)
+		{
+			av_free(data);
+			return nullptr;
+		}
+
+		FramePool* pool = static_cast<FramePool*>(opaque);
+		pool->mBufferAllocations++;
+		pool->mBytesHeld += size;
+		return buffer;
+	}
+
+	void FramePool::Free(void* opaque, uint8_t* data)
+	{
+		GetInstance().mBytesHeld -= static_cast<size_t>(reinterpret_cast<uintptr_t>(opaque));
+		av_free(data);
+	}
+
+	AVBufferRef* FramePool::AcquireBuffer(int format, int width, int height, int plane, size_t size)
+	{
+		mBufferRequests++;
+
+		AVBufferPool* pool = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			BufferKey key{ format, width, height, plane, size };
+			auto it = mBufferPools.find(key);
+			if (it == mBufferPools.end())
+			{
+				if (mBufferPools.size() >= MAX_BUFFER_POOLS)
+				{
+					// The least recently used geometry goes, its idle buffers are
+					// freed now and the ones still out once they are returned
+					auto oldest = std::min_element(mBufferPools.begin(), mBufferPools.end(),
+						[](const auto& a, const auto& b) { return a.second.mLastUse < b.second.mLastUse; });
+					av_buffer_pool_uninit(&oldest->second.mPool);
+					mBufferPools.erase(oldest);
+				}
+				it = mBufferPools.emplace(key, BufferPoolEntry{ av_buffer_pool_init2(size, this, &FramePool::Allocate, nullptr) }).first;
+			}
+			it->second.mLastUse = ++mUseCounter;
+			pool = it->second.mPool;
+		}
+		return pool ? av_buffer_pool_get(pool) : nullptr;
+	}
+
+	void FramePool::Install(AVCodecContext* codecContext)
+	{
+		codecContext->get_buffer2 = &FramePool::GetBuffer2;
+	}
+
+	// Mirrors the layout of avcodec_default_get_buffer2, only the memory
+	// comes from the shared pools
+	int FramePool::GetBuffer2(AVCodecContext* codecContext, AVFrame* frame, int flags)
+	{
+		const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+		if (!(codecContext->codec->capabilities & AV_CODEC_CAP_DR1) || !descriptor || (descriptor->flags & AV_PIX_FMT_FLAG_HWACCEL))
+			return avcodec_default_get_buffer2(codecContext, frame, flags);
+
+		AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+		int width = frame->width;
+		int height = frame->height;
+		int linesizeAlign[AV_NUM_DATA_POINTERS] = {};
+		avcodec_align_dimensions2(codecContext, &width, &height, linesizeAlign);
+
+		int linesize[4] = {};
+		bool unaligned = false;
+		do
+		{
+			if (av_image_fill_linesizes(linesize, format, width) < 0)
+				return AVERROR(EINVAL);
+			width += width & ~(width - 1);
+			unaligned = false;
+			for (int i = 0; i < 4; i++)
+				unaligned |= linesizeAlign[i] > 0 && linesize[i] % linesizeAlign[i] != 0;
+		} while (unaligned);
+
+		ptrdiff_t linesizes[4] = { linesize[0], linesize[1], linesize[2], linesize[3] };
+		size_t sizes[4] = {};
+		if (av_image_fill_plane_sizes(sizes, format, height, linesizes) < 0)
+			return AVERROR(EINVAL);
+
+		FramePool& pool = GetInstance();
+		for (int i = 0; i < 4 && sizes[i] > 0; i++)
+		{
+			frame->buf[i] = pool.AcquireBuffer(format, frame->width, frame->height, i, sizes[i] + PLANE_PADDING);
+			if (!frame->buf[i])
+			{
+				av_frame_unref(frame);
+				return AVERROR(ENOMEM);
+			}
+			frame->data[i] = frame->buf[i]->data;
+			frame->linesize[i] = linesize[i];
+		}
+		frame->extended_data = frame->data;
+		return 0;
+	}
+
+	SwsContext* FramePool::AcquireScaler(int srcWidth, int srcHeight, int srcFormat, int dstWidth, int dstHeight, int dstFormat, int flags)
+	{
+		ScalerKey key{ srcWidth, srcHeight, srcFormat, dstWidth, dstHeight, dstFormat, flags };
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mScalerRequests++;
+			auto it = mIdleScalers.find(key);
+			if (it != mIdleScalers.end())
+			{
+				SwsContext* scaler = it->second;
+				mIdleScalers.erase(it);
+				return scaler;
+			}
+		}
+
+		SwsContext* scaler = sws_getContext(srcWidth, srcHeight, static_cast<AVPixelFormat>(srcFormat), dstWidth, dstHeight, static_cast<AVPixelFormat>(dstFormat), flags, nullptr, nullptr, nullptr);
+		if (scaler)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mScalerCreations++;
+			mScalerKeys[scaler] = key;
+		}
+		return scaler;
+	}
+
+	void FramePool::ReleaseScaler(SwsContext* scaler)
+	{
+		if (!scaler)
+			return;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto key = mScalerKeys.find(scaler);
+		if (key == mScalerKeys.end())
+		{
+			// Not one of ours
+			sws_freeContext(scaler);
+			return;
+		}
+
+		mIdleScalers.emplace(key->second, scaler);
+		if (mIdleScalers.size() > MAX_IDLE_SCALERS)
+		{
+			// Make room by dropping a scaler of some other geometry
+			auto victim = std::find_if(mIdleScalers.begin(), mIdleScalers.end(), [scaler](const auto& idle) { return idle.second != scaler; });
+			mScalerKeys.erase(victim->second);
+			sws_freeContext(victim->second);
+			mIdleScalers.erase(victim);
+		}
+	}
+
+	FramePoolStats FramePool::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		FramePoolStats stats;
+		stats.mBufferRequests = mBufferRequests;
+		stats.mBufferAllocations = mBufferAllocations;
+		stats.mBytesHeld = mBytesHeld;
+		stats.mPools = mBufferPools.size();
+		stats.mScalerRequests = mScalerRequests;
+		stats.mScalerCreations = mScalerCreations;
+		stats.mIdleScalers = mIdleScalers.size();
+		return stats;
+	}
+}
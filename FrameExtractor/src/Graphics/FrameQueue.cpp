@@ -0,0 +1,98 @@
+/******************************************************************************
+/*!
+\file       FrameQueue.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Frame Queue class, a fixed capacity ring of converted
+			frames shared between a decode thread and the UI thread.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/FrameQueue.hpp>
+
+namespace FrameExtractor
+{
+	FrameQueue::FrameQueue(size_t capacity) : mSlots(capacity > 0 ? capacity : 1)
+	{
+	}
+
+	DecodedFrame* FrameQueue::BeginWrite()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mNotFull.wait(lock, [this] { return mAborted || mCount < mSlots.size(); });
+		if (mAborted)
+			return nullptr;
+
+		return &mSlots[(mHead + mCount) % mSlots.size()];
+	}
+
+	void FrameQueue::EndWrite()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mAborted)
+			mCount++;
+	}
+
+	DecodedFrame* FrameQueue::Peek(size_t offset)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (offset >= mCount)
+			return nullptr;
+
+		return &mSlots[(mHead + offset) % mSlots.size()];
+	}
+
+	void FrameQueue::Pop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mCount == 0)
+				return;
+			mHead = (mHead + 1) % mSlots.size();
+			mCount--;
+		}
+		mNotFull.notify_one();
+	}
+
+	void FrameQueue::Clear()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mHead = 0;
+			mCount = 0;
+		}
+		mNotFull.notify_all();
+	}
+
+	void FrameQueue::Abort()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mAborted = true;
+		}
+		mNotFull.notify_all();
+	}
+
+	void FrameQueue::Reset()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mHead = 0;
+		mCount = 0;
+		mAborted = false;
+	}
+
+	void FrameQueue::Resize(size_t capacity)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mSlots.resize(capacity > 0 ? capacity : 1);
+		mHead = 0;
+		mCount = 0;
+	}
+
+	size_t FrameQueue::Size() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mCount;
+	}
+}
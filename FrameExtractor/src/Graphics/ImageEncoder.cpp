@@ -0,0 +1,117 @@
+/******************************************************************************
+/*!
+\file       ImageEncoder.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Image Encoder class, which turns decoded frames into
+			JPEG or PNG images.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/ImageEncoder.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+namespace FrameExtractor
+{
+	ImageEncoder::ImageEncoder(ImageFormat format, int jpegQuality) : mFormat(format), mJPEGQuality(std::clamp(jpegQuality, 2, 31))
+	{
+		bool png = mFormat == ImageFormat::PNG;
+		mEncoder = avcodec_find_encoder(png ? AV_CODEC_ID_PNG : AV_CODEC_ID_MJPEG);
+		if (!mEncoder)
+			FRAMEEX_CORE_ERROR("ImageEncoder: no {} encoder available", png ? "PNG" : "JPEG");
+		mPacket = av_packet_alloc();
+	}
+
+	ImageEncoder::~ImageEncoder()
+	{
+		av_packet_free(&mPacket);
+		avcodec_free_context(&mContext);
+	}
+
+	void ImageEncoder::GetOutputSize(int width, int height, ImageFormat format, uint32_t maxWidth, int& outWidth, int& outHeight)
+	{
+		outWidth = width;
+		outHeight = height;
+		if (maxWidth > 0 && static_cast<uint32_t>(width) > maxWidth)
+		{
+			outHeight = static_cast<int>(static_cast<int64_t>(height) * maxWidth / width);
+			outWidth = static_cast<int>(maxWidth);
+		}
+		// 4:2:0 wants even sizes
+		if (format == ImageFormat::JPEG)
+		{
+			outWidth = std::max(2, outWidth & ~1);
+			outHeight = std::max(2, outHeight & ~1);
+		}
+	}
+
+	AVFrame* ImageEncoder::Convert(const AVFrame* source, ImageFormat format, uint32_t maxWidth)
+	{
+		AVPixelFormat pixelFormat = format == ImageFormat::PNG ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_YUVJ420P;
+		int width = 0;
+		int height = 0;
+		GetOutputSize(source->width, source->height, format, maxWidth, width, height);
+
+		AVFrame* converted = av_frame_alloc();
+		converted->format = pixelFormat;
+		converted->width = width;
+		converted->height = height;
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = pool.AcquireScaler(source->width, source->height, source->format, width, height, pixelFormat, SWS_BICUBIC);
+		if (!scaler || av_frame_get_buffer(converted, 0) < 0)
+		{
+			pool.ReleaseScaler(scaler);
+			av_frame_free(&converted);
+			return nullptr;
+		}
+		sws_scale(scaler, source->data, source->linesize, 0, source->height, converted->data, converted->linesize);
+		pool.ReleaseScaler(scaler);
+		return converted;
+	}
+
+	bool ImageEncoder::Encode(AVFrame* frame, std::vector<uint8_t>& data)
+	{
+		data.clear();
+		if (!mEncoder)
+			return false;
+
+		bool png = mFormat == ImageFormat::PNG;
+		// Encoders are kept while the frame size stays the same, usually the whole batch
+		if (!mContext || mContext->width != frame->width || mContext->height != frame->height)
+		{
+			avcodec_free_context(&mContext);
+			mContext = avcodec_alloc_context3(mEncoder);
+			mContext->width = frame->width;
+			mContext->height = frame->height;
+			mContext->pix_fmt = static_cast<AVPixelFormat>(frame->format);
+			mContext->time_base = { 1, 25 };
+			if (!png)
+			{
+				mContext->flags |= AV_CODEC_FLAG_QSCALE;
+				mContext->global_quality = FF_QP2LAMBDA * mJPEGQuality;
+			}
+			if (avcodec_open2(mContext, mEncoder, nullptr) < 0)
+			{
+				FRAMEEX_CORE_ERROR("ImageEncoder: unable to open the {} encoder", png ? "PNG" : "JPEG");
+				avcodec_free_context(&mContext);
+				return false;
+			}
+		}
+
+		frame->quality = mContext->global_quality;
+		frame->pts = 0;
+		if (avcodec_send_frame(mContext, frame) >= 0 && avcodec_receive_packet(mContext, mPacket) >= 0)
+		{
+			data.assign(mPacket->data, mPacket->data + mPacket->size);
+			av_packet_unref(mPacket);
+		}
+		return !data.empty();
+	}
+}
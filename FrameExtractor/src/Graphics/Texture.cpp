@@ -81,10 +81,21 @@ namespace FrameExtractor
 	{
 		glDeleteTextures(1, &mRendererID);
 	}
-	void Texture::Update(void* buffer)
+	void Texture::Update(const void* buffer)
 	{
 		glBindTexture(GL_TEXTURE_2D, mRendererID);
+		// Rows are tightly packed, widths are not always a multiple of four
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mWidth, mHeight, GL_RGB, GL_UNSIGNED_BYTE, buffer);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void Texture::UpdateRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const void* buffer)
+	{
+		glBindTexture(GL_TEXTURE_2D, mRendererID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, buffer);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 	}
 
 
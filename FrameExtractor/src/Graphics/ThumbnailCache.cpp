@@ -0,0 +1,246 @@
+/******************************************************************************
+/*!
+\file       ThumbnailCache.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Thumbnail Cache class, a per project file of JPEG
+			thumbnails and video metadata that is memory mapped on load.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/ThumbnailCache.hpp>
+
+namespace FrameExtractor
+{
+	static constexpr uint32_t CACHE_MAGIC = 0x54585246; // "FRXT"
+	static constexpr uint32_t CACHE_VERSION = 2;
+
+	// Header, then count records, then the path strings, then the images.
+	// Offsets are from the start of the file.
+	struct CacheHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint64_t mCount;
+	};
+
+	struct ThumbnailCache::Record
+	{
+		uint64_t mFileSize;
+		int64_t mWriteTime;
+		uint64_t mPathOffset;
+		uint64_t mPathLength;
+		uint64_t mImageOffset;
+		uint64_t mImageSize;
+		VideoMetadata mMetadata;
+	};
+
+	static bool GetFileStamp(const std::filesystem::path& path, uint64_t& size, int64_t& writeTime)
+	{
+		std::error_code ec;
+		size = std::filesystem::file_size(path, ec);
+		if (ec)
+			return false;
+		auto time = std::filesystem::last_write_time(path, ec);
+		if (ec)
+			return false;
+		writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+		return true;
+	}
+
+	std::filesystem::path ThumbnailCache::GetCacheFile(const std::filesystem::path& projectDir)
+	{
+		return projectDir / "Thumbnails.frexcache";
+	}
+
+	std::string ThumbnailCache::MakeKey(const std::filesystem::path& videoPath)
+	{
+		// The explorer and the project list do not spell paths the same way
+		std::error_code ec;
+		std::filesystem::path absolute = std::filesystem::absolute(videoPath, ec);
+		return (ec ? videoPath : absolute).lexically_normal().generic_string();
+	}
+
+	bool ThumbnailCache::Open(const std::filesystem::path& cacheFile)
+	{
+		Close();
+		mPath = cacheFile;
+		if (!mFile.Open(cacheFile))
+			return false;
+
+		const uint8_t* data = mFile.GetData();
+		size_t size = mFile.GetSize();
+		const CacheHeader* header = reinterpret_cast<const CacheHeader*>(data);
+		if (size < sizeof(CacheHeader) || header->mMagic != CACHE_MAGIC || header->mVersion != CACHE_VERSION
+			|| header->mCount > (size - sizeof(CacheHeader)) / sizeof(Record))
+		{
+			FRAMEEX_CORE_WARN("Ignoring thumbnail cache {}, it is from another version or damaged", cacheFile.string());
+			mFile.Close();
+			return false;
+		}
+
+		const Record* records = reinterpret_cast<const Record*>(data + sizeof(CacheHeader));
+		mEntries.reserve(header->mCount);
+		for (uint64_t i = 0; i < header->mCount; i++)
+		{
+			const Record& record = records[i];
+			if (record.mPathOffset + record.mPathLength > size || record.mImageOffset + record.mImageSize > size)
+				continue;
+			std::string_view key(reinterpret_cast<const char*>(data + record.mPathOffset), record.mPathLength);
+			mEntries[key] = &record;
+		}
+		return true;
+	}
+
+	void ThumbnailCache::Close()
+	{
+		mEntries.clear();
+		mAdded.clear();
+		mFile.Close();
+		mPath.clear();
+	}
+
+	bool ThumbnailCache::Find(const std::filesystem::path& videoPath, Hit& hit) const
+	{
+		if (mEntries.empty() && mAdded.empty())
+			return false;
+
+		uint64_t fileSize = 0;
+		int64_t writeTime = 0;
+		if (!GetFileStamp(videoPath, fileSize, writeTime))
+			return false;
+
+		std::string key = MakeKey(videoPath);
+		auto added = mAdded.find(key);
+		if (added != mAdded.end())
+		{
+			if (added->second.mFileSize != fileSize || added->second.mWriteTime != writeTime)
+				return false;
+			hit.mMetadata = added->second.mMetadata;
+			hit.mImage = added->second.mImage.empty() ? nullptr : added->second.mImage.data();
+			hit.mImageSize = added->second.mImage.size();
+			return true;
+		}
+
+		auto it = mEntries.find(key);
+		if (it == mEntries.end())
+			return false;
+		const Record& record = *it->second;
+		if (record.mFileSize != fileSize || record.mWriteTime != writeTime)
+			return false;
+		hit.mMetadata = record.mMetadata;
+		hit.mImage = record.mImageSize ? mFile.GetData() + record.mImageOffset : nullptr;
+		hit.mImageSize = record.mImageSize;
+		return true;
+	}
+
+	void ThumbnailCache::Put(const std::filesystem::path& videoPath, const VideoMetadata& metadata, std::vector<uint8_t> image)
+	{
+		Added entry;
+		if (!GetFileStamp(videoPath, entry.mFileSize, entry.mWriteTime))
+			return;
+		entry.mMetadata = metadata;
+		entry.mImage = std::move(image);
+		mAdded[MakeKey(videoPath)] = std::move(entry);
+	}
+
+	bool ThumbnailCache::Save()
+	{
+		if (mPath.empty())
+			return false;
+
+		// Gather everything first, the mapping has to be closed before the file
+		// is replaced. Added entries stay pending until the rename goes through
+		// so a failed save can be retried.
+		struct Pending
+		{
+			std::string mKey;
+			Record mRecord;
+			std::vector<uint8_t> mMapped; // Copied out of the mapping
+			const uint8_t* mImage = nullptr;
+		};
+		std::vector<Pending> pending;
+		pending.reserve(mEntries.size() + mAdded.size());
+		for (const auto& [key, record] : mEntries)
+		{
+			if (mAdded.contains(std::string(key)))
+				continue;
+			const uint8_t* image = mFile.GetData() + record->mImageOffset;
+			pending.push_back({ std::string(key), *record, std::vector<uint8_t>(image, image + record->mImageSize) });
+			pending.back().mImage = pending.back().mMapped.data();
+		}
+		for (const auto& [key, added] : mAdded)
+		{
+			Record record{};
+			record.mFileSize = added.mFileSize;
+			record.mWriteTime = added.mWriteTime;
+			record.mMetadata = added.mMetadata;
+			record.mImageSize = added.mImage.size();
+			pending.push_back({ key, record, {}, added.mImage.data() });
+		}
+
+		std::unordered_map<std::string, Added> added = std::move(mAdded);
+		std::filesystem::path path = mPath;
+		Close();
+		// Maps the old file again and puts the unsaved entries back
+		auto restore = [&]() {
+			Open(path);
+			mAdded = std::move(added);
+		};
+
+		uint64_t offset = sizeof(CacheHeader) + pending.size() * sizeof(Record);
+		for (auto& entry : pending)
+		{
+			entry.mRecord.mPathOffset = offset;
+			entry.mRecord.mPathLength = entry.mKey.size();
+			offset += entry.mKey.size();
+		}
+		for (auto& entry : pending)
+		{
+			entry.mRecord.mImageOffset = offset;
+			offset += entry.mRecord.mImageSize;
+		}
+
+		std::filesystem::path temporary = path;
+		temporary += ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				FRAMEEX_CORE_WARN("Unable to write thumbnail cache {}", path.string());
+				restore();
+				return false;
+			}
+			CacheHeader header{ CACHE_MAGIC, CACHE_VERSION, pending.size() };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			for (const auto& entry : pending)
+				file.write(reinterpret_cast<const char*>(&entry.mRecord), sizeof(Record));
+			for (const auto& entry : pending)
+				file.write(entry.mKey.data(), entry.mKey.size());
+			for (const auto& entry : pending)
+				file.write(reinterpret_cast<const char*>(entry.mImage), entry.mRecord.mImageSize);
+			if (!file)
+			{
+				FRAMEEX_CORE_WARN("Unable to write thumbnail cache {}", path.string());
+				file.close();
+				std::error_code ec;
+				std::filesystem::remove(temporary, ec);
+				restore();
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(temporary, path, ec);
+		if (ec)
+		{
+			FRAMEEX_CORE_WARN("Unable to replace thumbnail cache {}: {}", path.string(), ec.message());
+			std::filesystem::remove(temporary, ec);
+			restore();
+			return false;
+		}
+		return Open(path);
+	}
+}
@@ -0,0 +1,504 @@
+/******************************************************************************
+/*!
+\file       ThumbnailService.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Thumbnail Service class, which decodes the first
+			keyframe of videos and probes their metadata on worker threads and
+			keeps a bounded number of small thumbnail textures.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/ThumbnailService.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+#include <Graphics/VideoIndex.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/parseutils.h>
+#include <libswscale/swscale.h>
+}
+#include <stb_image.h>
+
+namespace FrameExtractor
+{
+	// Packets read while looking for the first decodable keyframe
+	static constexpr int MAX_PROBE_PACKETS = 512;
+	// MJPEG quantiser for cached thumbnails, 2 (best) to 31
+	static constexpr int JPEG_QUALITY = 4;
+
+	ThumbnailService::ThumbnailService(uint32_t size, size_t capacity, unsigned workerCount) : mSize(size), mCapacity(std::max<size_t>(1, capacity))
+	{
+		if (workerCount == 0)
+		{
+			// Leave half the cores to the UI and playback
+			workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+		}
+		for (unsigned i = 0; i < workerCount; i++)
+			mWorkers.emplace_back(&ThumbnailService::WorkerLoop, this);
+	}
+
+	ThumbnailService::~ThumbnailService()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+			mQueue.clear();
+		}
+		mCondition.notify_all();
+		for (auto& worker : mWorkers)
+			worker.join();
+		if (mCache.IsDirty())
+			mCache.Save();
+	}
+
+	const Thumbnail* ThumbnailService::Request(const std::filesystem::path& path)
+	{
+		auto it = mLookup.find(path);
+		if (it != mLookup.end())
+		{
+			mReady.splice(mReady.begin(), mReady, it->second);
+			return &it->second->second;
+		}
+		if (mFailed.contains(path))
+			return nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mInFlight.contains(path))
+				return nullptr;
+		}
+
+		// Only this thread queues work, so nothing can sneak in meanwhile
+		Job job;
+		job.mPath = path;
+		if (mCache.Find(path, job.mCached))
+		{
+			mMetadata[path] = job.mCached.mMetadata;
+		}
+		// Probed videos are cached without an image
+		if (job.mCached.mImage)
+			mDiskHits++;
+		else
+			mDecoded++;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mInFlight.insert(path);
+			mQueue.push_back(std::move(job));
+		}
+		mCondition.notify_one();
+		return nullptr;
+	}
+
+	const VideoMetadata* ThumbnailService::GetMetadata(const std::filesystem::path& path) const
+	{
+		auto it = mMetadata.find(path);
+		return it == mMetadata.end() ? nullptr : &it->second;
+	}
+
+	void ThumbnailService::Probe(const std::vector<std::filesystem::path>& paths)
+	{
+		if (!GetProbeProgress().IsRunning())
+		{
+			mProbesDone = 0;
+			mProbesTotal = 0;
+		}
+
+		std::vector<Job> jobs;
+		for (const auto& path : paths)
+		{
+			if (mMetadata.contains(path))
+				continue;
+			ThumbnailCache::Hit hit;
+			if (mCache.Find(path, hit))
+			{
+				mMetadata[path] = hit.mMetadata;
+				continue;
+			}
+			Job job;
+			job.mType = JobType::Probe;
+			job.mPath = path;
+			jobs.push_back(std::move(job));
+		}
+		if (jobs.empty())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			for (auto& job : jobs)
+			{
+				if (!mInFlight.insert(job.mPath).second)
+					continue;
+				mQueue.push_back(std::move(job));
+				mProbesTotal++;
+			}
+		}
+		mCondition.notify_all();
+	}
+
+	bool ThumbnailService::HasFailed(const std::filesystem::path& path) const
+	{
+		return mFailed.contains(path);
+	}
+
+	void ThumbnailService::Update()
+	{
+		std::deque<Result> results;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			size_t count = std::min(mResults.size(), MAX_UPLOADS_PER_UPDATE);
+			for (size_t i = 0; i < count; i++)
+			{
+				results.push_back(std::move(mResults.front()));
+				mResults.pop_front();
+			}
+		}
+		for (auto& result : results)
+			Store(result);
+
+		// Written once a batch is done, queued jobs may still point into the mapping
+		if (mCache.IsDirty())
+		{
+			bool idle = false;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				idle = mInFlight.empty() && mResults.empty();
+			}
+			if (idle)
+				mCache.Save();
+		}
+	}
+
+	void ThumbnailService::Store(Result& result)
+	{
+		if (result.mProbe)
+		{
+			mProbesDone++;
+			// A thumbnail that finished first already brought better data
+			if (!result.mFailed && !mMetadata.contains(result.mPath))
+			{
+				mMetadata[result.mPath] = result.mMetadata;
+				if (!mCache.GetPath().empty())
+					mCache.Put(result.mPath, result.mMetadata, {});
+			}
+			return;
+		}
+		if (result.mFailed)
+		{
+			mFailed.insert(result.mPath);
+			return;
+		}
+
+		Thumbnail thumbnail;
+		thumbnail.mMetadata = result.mMetadata;
+		thumbnail.mTexture = MakeRef<Texture>(result.mWidth, result.mHeight);
+		thumbnail.mTexture->Update(result.mPixels.data());
+		mMetadata[result.mPath] = result.mMetadata;
+		if (!result.mEncoded.empty() && !mCache.GetPath().empty())
+			mCache.Put(result.mPath, result.mMetadata, std::move(result.mEncoded));
+
+		auto it = mLookup.find(result.mPath);
+		if (it != mLookup.end())
+		{
+			mReady.erase(it->second);
+			mLookup.erase(it);
+		}
+		mReady.emplace_front(result.mPath, std::move(thumbnail));
+		mLookup[result.mPath] = mReady.begin();
+
+		while (mReady.size() > mCapacity)
+		{
+			mLookup.erase(mReady.back().first);
+			mReady.pop_back();
+			mEvictions++;
+		}
+	}
+
+	void ThumbnailService::CancelPending()
+	{
+		DropQueued(false);
+	}
+
+	void ThumbnailService::DropQueued(bool probes)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto dropped = std::remove_if(mQueue.begin(), mQueue.end(), [probes](const Job& job) { return probes || job.mType == JobType::Thumbnail; });
+		for (auto it = dropped; it != mQueue.end(); ++it)
+		{
+			mInFlight.erase(it->mPath);
+			if (it->mType == JobType::Probe)
+				mProbesTotal--;
+		}
+		mQueue.erase(dropped, mQueue.end());
+		mIdleCondition.notify_all();
+	}
+
+	void ThumbnailService::WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mIdleCondition.wait(lock, [this]() { return mInFlight.empty(); });
+	}
+
+	void ThumbnailService::SetCacheFile(const std::filesystem::path& cacheFile)
+	{
+		if (cacheFile == mCache.GetPath())
+			return;
+
+		// Jobs hold pointers into the current mapping, let them finish first.
+		// Probes belong to the old project as well.
+		DropQueued(true);
+		WaitIdle();
+		std::deque<Result> results;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			results.swap(mResults);
+		}
+		for (auto& result : results)
+			Store(result);
+		if (mCache.IsDirty())
+			mCache.Save();
+
+		if (cacheFile.empty())
+			mCache.Close();
+		else
+			mCache.Open(cacheFile);
+	}
+
+	ThumbnailStats ThumbnailService::GetStats() const
+	{
+		ThumbnailStats stats;
+		stats.mReady = mReady.size();
+		stats.mCapacity = mCapacity;
+		stats.mFailed = mFailed.size();
+		stats.mEvictions = mEvictions;
+		stats.mDiskHits = mDiskHits;
+		stats.mDecoded = mDecoded;
+		std::lock_guard<std::mutex> lock(mMutex);
+		stats.mPending = mInFlight.size() + mResults.size();
+		return stats;
+	}
+
+	void ThumbnailService::WorkerLoop()
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this]() { return mStop || !mQueue.empty(); });
+				if (mStop)
+					return;
+				// Newest first, those are the ones on screen
+				job = std::move(mQueue.back());
+				mQueue.pop_back();
+			}
+
+			Result result;
+			if (job.mType == JobType::Probe)
+				result = ProbeVideo(job.mPath);
+			else if (job.mCached.mImage)
+				result = Unpack(job);
+			else
+				result = Generate(job.mPath);
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mInFlight.erase(job.mPath);
+				if (!mStop)
+					mResults.push_back(std::move(result));
+			}
+			mIdleCondition.notify_all();
+		}
+	}
+
+	ThumbnailService::Result ThumbnailService::Generate(const std::filesystem::path& path) const
+	{
+		Result result;
+		result.mPath = path;
+		result.mFailed = true;
+
+		DecodeSession session;
+		if (!session.OpenInput(path, false))
+		{
+			FRAMEEX_CORE_WARN("Thumbnail: unable to open {}: {}", path.string(), session.GetError());
+			return result;
+		}
+		// MP4 headers carry the codec parameters, only probe when they do not
+		if (session.GetStream()->codecpar->width == 0)
+			avformat_find_stream_info(session.GetFormatContext(), nullptr);
+
+		ReadMetadata(session.GetFormatContext(), session.GetStreamIndex(), path, result.mMetadata);
+
+		if (!session.OpenDecoder(DecodePolicy::For(DecodeUseCase::Thumbnail), [](AVCodecContext* codecContext) { codecContext->skip_frame = AVDISCARD_NONKEY; }))
+		{
+			FRAMEEX_CORE_WARN("Thumbnail: unable to open decoder for {}", path.string());
+			return result;
+		}
+		// Only keyframes get through, so decoding starts at the first GOP
+		session.SetPacketFilter([](const AVPacket& packet) { return (packet.flags & AV_PKT_FLAG_KEY) != 0; });
+
+		AVFrame* frame = av_frame_alloc();
+		bool decoded = session.ReceiveFrame(frame, MAX_PROBE_PACKETS) == 0;
+
+		if (decoded && frame->width > 0 && frame->height > 0)
+		{
+			// Fit inside mSize x mSize, never upscale
+			double scale = std::min(1.0, static_cast<double>(mSize) / std::max(frame->width, frame->height));
+			result.mWidth = std::max(1, static_cast<int>(frame->width * scale + 0.5));
+			result.mHeight = std::max(1, static_cast<int>(frame->height * scale + 0.5));
+
+			FramePool& pool = FramePool::GetInstance();
+			SwsContext* scaler = pool.AcquireScaler(frame->width, frame->height, frame->format, result.mWidth, result.mHeight, AV_PIX_FMT_RGB24, SWS_AREA);
+			if (scaler)
+			{
+				result.mPixels.resize(static_cast<size_t>(result.mWidth) * result.mHeight * 3);
+				uint8_t* dstData[4] = {};
+				int dstLinesize[4] = {};
+				av_image_fill_arrays(dstData, dstLinesize, result.mPixels.data(), AV_PIX_FMT_RGB24, result.mWidth, result.mHeight, 1);
+				sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+				pool.ReleaseScaler(scaler);
+				result.mEncoded = EncodeJPEG(result.mPixels, result.mWidth, result.mHeight);
+				result.mFailed = false;
+			}
+		}
+		else
+		{
+			FRAMEEX_CORE_WARN("Thumbnail: no keyframe decoded from {}", path.string());
+		}
+
+		av_frame_free(&frame);
+		return result;
+	}
+
+	ThumbnailService::Result ThumbnailService::Unpack(const Job& job) const
+	{
+		int width = 0, height = 0, channels = 0;
+		uint8_t* pixels = stbi_load_from_memory(job.mCached.mImage, static_cast<int>(job.mCached.mImageSize), &width, &height, &channels, 3);
+		if (!pixels)
+		{
+			FRAMEEX_CORE_WARN("Thumbnail: cached image of {} is damaged, decoding again", job.mPath.string());
+			return Generate(job.mPath);
+		}
+
+		Result result;
+		result.mPath = job.mPath;
+		result.mMetadata = job.mCached.mMetadata;
+		result.mWidth = width;
+		result.mHeight = height;
+		result.mPixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 3);
+		stbi_image_free(pixels);
+		return result;
+	}
+
+	std::vector<uint8_t> ThumbnailService::EncodeJPEG(const std::vector<uint8_t>& pixels, int width, int height)
+	{
+		std::vector<uint8_t> encoded;
+		const AVCodec* encoder = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+		AVCodecContext* encoderContext = encoder ? avcodec_alloc_context3(encoder) : nullptr;
+		if (!encoderContext)
+			return encoded;
+
+		encoderContext->width = width;
+		encoderContext->height = height;
+		encoderContext->pix_fmt = AV_PIX_FMT_YUVJ420P;
+		encoderContext->time_base = { 1, 25 };
+		encoderContext->flags |= AV_CODEC_FLAG_QSCALE;
+		encoderContext->global_quality = FF_QP2LAMBDA * JPEG_QUALITY;
+		AVFrame* frame = av_frame_alloc();
+		AVPacket* packet = av_packet_alloc();
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = pool.AcquireScaler(width, height, AV_PIX_FMT_RGB24, width, height, AV_PIX_FMT_YUVJ420P, SWS_POINT);
+		if (scaler && avcodec_open2(encoderContext, encoder, nullptr) >= 0)
+		{
+			frame->format = AV_PIX_FMT_YUVJ420P;
+			frame->width = width;
+			frame->height = height;
+			frame->quality = encoderContext->global_quality;
+			if (av_frame_get_buffer(frame, 0) >= 0)
+			{
+				const uint8_t* srcData[4] = { pixels.data() };
+				int srcLinesize[4] = { width * 3 };
+				sws_scale(scaler, srcData, srcLinesize, 0, height, frame->data, frame->linesize);
+				if (avcodec_send_frame(encoderContext, frame) >= 0 && avcodec_receive_packet(encoderContext, packet) >= 0)
+				{
+					encoded.assign(packet->data, packet->data + packet->size);
+				}
+			}
+		}
+		pool.ReleaseScaler(scaler);
+		av_packet_free(&packet);
+		av_frame_free(&frame);
+		avcodec_free_context(&encoderContext);
+		return encoded;
+	}
+
+	ThumbnailService::Result ThumbnailService::ProbeVideo(const std::filesystem::path& path)
+	{
+		Result result;
+		result.mPath = path;
+		result.mProbe = true;
+		result.mFailed = true;
+
+		AVFormatContext* formatContext = nullptr;
+		if (avformat_open_input(&formatContext, path.string().c_str(), nullptr, nullptr) != 0)
+		{
+			FRAMEEX_CORE_WARN("Probe: unable to open {}", path.string());
+			return result;
+		}
+		if (avformat_find_stream_info(formatContext, nullptr) < 0)
+		{
+			FRAMEEX_CORE_WARN("Probe: no stream information in {}", path.string());
+		}
+		int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+		if (streamIndex >= 0)
+		{
+			ReadMetadata(formatContext, streamIndex, path, result.mMetadata);
+			result.mFailed = false;
+		}
+		else
+		{
+			FRAMEEX_CORE_WARN("Probe: no video stream in {}", path.string());
+		}
+		avformat_close_input(&formatContext);
+		return result;
+	}
+
+	void ThumbnailService::ReadMetadata(AVFormatContext* formatContext, int streamIndex, const std::filesystem::path& path, VideoMetadata& metadata)
+	{
+		AVStream* stream = formatContext->streams[streamIndex];
+		metadata.mWidth = stream->codecpar->width;
+		metadata.mHeight = stream->codecpar->height;
+		snprintf(metadata.mCodec, sizeof(metadata.mCodec), "%s", avcodec_get_name(stream->codecpar->codec_id));
+
+		// ISO 8601, written by most cameras and muxers
+		const AVDictionaryEntry* creation = av_dict_get(stream->metadata, "creation_time", nullptr, 0);
+		if (!creation)
+			creation = av_dict_get(formatContext->metadata, "creation_time", nullptr, 0);
+		int64_t microseconds = 0;
+		if (creation && av_parse_time(&microseconds, creation->value, 0) == 0)
+			metadata.mCreationTime = microseconds / 1000000;
+
+		// An index sidecar knows the exact numbers, otherwise trust the container
+		VideoIndex::Summary summary;
+		if (VideoIndex::LoadSummary(path, summary))
+		{
+			metadata.mFrameCount = summary.mFrameCount;
+			metadata.mFPS = summary.mFPS;
+			metadata.mDuration = summary.mDuration;
+			return;
+		}
+		if (stream->avg_frame_rate.den != 0)
+			metadata.mFPS = av_q2d(stream->avg_frame_rate);
+		if (stream->duration != AV_NOPTS_VALUE)
+			metadata.mDuration = stream->duration * av_q2d(stream->time_base);
+		else if (formatContext->duration != AV_NOPTS_VALUE)
+			metadata.mDuration = static_cast<double>(formatContext->duration) / AV_TIME_BASE;
+		if (stream->nb_frames > 0)
+			metadata.mFrameCount = static_cast<uint32_t>(stream->nb_frames);
+		else
+			metadata.mFrameCount = static_cast<uint32_t>(metadata.mDuration * metadata.mFPS + 0.5);
+	}
+}
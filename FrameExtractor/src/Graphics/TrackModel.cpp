@@ -0,0 +1,213 @@
+/******************************************************************************
+/*!
+\file       TrackModel.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Track Model class, the labelled objects of one video
+			as keyframed boxes that are interpolated between keyframes.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Graphics/TrackModel.hpp>
+
+namespace FrameExtractor
+{
+	static bool FrameLess(const TrackKeyframe& keyframe, int32_t frame)
+	{
+		return keyframe.mFrame < frame;
+	}
+
+	bool Track::GetBox(int32_t frame, BoundingBox& box) const
+	{
+		if (mKeyframes.empty() || frame < GetFirstFrame() || frame > GetLastFrame())
+			return false;
+
+		auto next = std::lower_bound(mKeyframes.begin(), mKeyframes.end(), frame, FrameLess);
+		if (next->mFrame == frame)
+		{
+			box = next->mBox;
+			return true;
+		}
+		auto previous = next - 1;
+		float t = static_cast<float>(frame - previous->mFrame) / (next->mFrame - previous->mFrame);
+		const BoundingBox& a = previous->mBox;
+		const BoundingBox& b = next->mBox;
+		box.minX = a.minX + (b.minX - a.minX) * t;
+		box.minY = a.minY + (b.minY - a.minY) * t;
+		box.maxX = a.maxX + (b.maxX - a.maxX) * t;
+		box.maxY = a.maxY + (b.maxY - a.maxY) * t;
+		return true;
+	}
+
+	const TrackKeyframe* Track::FindKeyframe(int32_t frame) const
+	{
+		auto it = std::lower_bound(mKeyframes.begin(), mKeyframes.end(), frame, FrameLess);
+		return it != mKeyframes.end() && it->mFrame == frame ? &*it : nullptr;
+	}
+
+	uint32_t TrackModel::AddTrack(uint32_t classID, int32_t frame, const BoundingBox& box)
+	{
+		Track& track = mTracks[mNextID];
+		track.mID = mNextID;
+		track.mClass = classID;
+		track.mKeyframes.push_back({ frame, box });
+		mTreeDirty = true;
+		return mNextID++;
+	}
+
+	void TrackModel::PutTrack(const Track& track)
+	{
+		if (track.mID == 0 || track.mKeyframes.empty())
+			return;
+		Track& added = mTracks[track.mID];
+		added = track;
+		std::sort(added.mKeyframes.begin(), added.mKeyframes.end(), [](const TrackKeyframe& a, const TrackKeyframe& b) { return a.mFrame < b.mFrame; });
+		mNextID = std::max(mNextID, track.mID + 1);
+		mTreeDirty = true;
+	}
+
+	bool TrackModel::RemoveTrack(uint32_t id)
+	{
+		if (!mTracks.erase(id))
+			return false;
+		mTreeDirty = true;
+		return true;
+	}
+
+	bool TrackModel::SetKeyframe(uint32_t id, int32_t frame, const BoundingBox& box)
+	{
+		auto found = mTracks.find(id);
+		if (found == mTracks.end())
+			return false;
+
+		auto& keyframes = found->second.mKeyframes;
+		auto it = std::lower_bound(keyframes.begin(), keyframes.end(), frame, FrameLess);
+		if (it != keyframes.end() && it->mFrame == frame)
+		{
+			it->mBox = box;
+			return true;
+		}
+		// Only a keyframe past either end changes the span
+		mTreeDirty |= it == keyframes.begin() || it == keyframes.end();
+		keyframes.insert(it, { frame, box });
+		return true;
+	}
+
+	bool TrackModel::RemoveKeyframe(uint32_t id, int32_t frame)
+	{
+		auto found = mTracks.find(id);
+		if (found == mTracks.end())
+			return false;
+
+		auto& keyframes = found->second.mKeyframes;
+		auto it = std::lower_bound(keyframes.begin(), keyframes.end(), frame, FrameLess);
+		if (it == keyframes.end() || it->mFrame != frame)
+			return false;
+		if (keyframes.size() == 1)
+			return RemoveTrack(id);
+		mTreeDirty |= it == keyframes.begin() || it + 1 == keyframes.end();
+		keyframes.erase(it);
+		return true;
+	}
+
+	bool TrackModel::SetClass(uint32_t id, uint32_t classID)
+	{
+		auto found = mTracks.find(id);
+		if (found == mTracks.end())
+			return false;
+		found->second.mClass = classID;
+		return true;
+	}
+
+	const Track* TrackModel::GetTrack(uint32_t id) const
+	{
+		auto found = mTracks.find(id);
+		return found != mTracks.end() ? &found->second : nullptr;
+	}
+
+	void TrackModel::Rebuild() const
+	{
+		mTree.clear();
+		mTree.reserve(mTracks.size());
+		for (const auto& [id, track] : mTracks)
+			mTree.push_back({ track.GetFirstFrame(), track.GetLastFrame(), track.GetLastFrame(), id });
+		std::sort(mTree.begin(), mTree.end(), [](const Node& a, const Node& b) { return a.mFirst < b.mFirst; });
+		BuildRange(0, mTree.size());
+		mTreeDirty = false;
+	}
+
+	int32_t TrackModel::BuildRange(size_t begin, size_t end) const
+	{
+		if (begin >= end)
+			return INT32_MIN;
+		size_t middle = begin + (end - begin) / 2;
+		Node& node = mTree[middle];
+		node.mMaxLast = std::max({ node.mLast, BuildRange(begin, middle), BuildRange(middle + 1, end) });
+		return node.mMaxLast;
+	}
+
+	void TrackModel::QueryRange(size_t begin, size_t end, int32_t frame, std::vector<Annotation>& boxes) const
+	{
+		if (begin >= end)
+			return;
+		size_t middle = begin + (end - begin) / 2;
+		const Node& node = mTree[middle];
+		// Nothing in this range lasts until frame
+		if (node.mMaxLast < frame)
+			return;
+		QueryRange(begin, middle, frame, boxes);
+		// Everything to the right starts later than this node
+		if (node.mFirst > frame)
+			return;
+		if (node.mLast >= frame)
+		{
+			const Track& track = mTracks.at(node.mID);
+			Annotation annotation;
+			annotation.mClass = track.mClass;
+			annotation.mTrack = track.mID;
+			if (track.GetBox(frame, annotation.mBox))
+				boxes.push_back(annotation);
+		}
+		QueryRange(middle + 1, end, frame, boxes);
+	}
+
+	void TrackModel::GetActive(int32_t frame, std::vector<Annotation>& boxes) const
+	{
+		if (mTreeDirty)
+			Rebuild();
+		QueryRange(0, mTree.size(), frame, boxes);
+	}
+
+	size_t TrackModel::Materialize(AnnotationStore& store, const std::filesystem::path& video) const
+	{
+		// Frames that hold tracked boxes now, so shortened or removed tracks are cleared
+		std::vector<int32_t> frames;
+		store.Query(video, INT32_MIN, INT32_MAX, [&](int32_t frame, const AnnotationSpan& span) {
+			if (std::any_of(span.mTrack, span.mTrack + span.mCount, [](uint32_t track) { return track != 0; }))
+				frames.push_back(frame);
+		});
+		for (const auto& [id, track] : mTracks)
+		{
+			for (int64_t frame = track.GetFirstFrame(); frame <= track.GetLastFrame(); frame++)
+				frames.push_back(static_cast<int32_t>(frame));
+		}
+		std::sort(frames.begin(), frames.end());
+		frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+
+		std::vector<Annotation> boxes;
+		for (int32_t frame : frames)
+		{
+			boxes.clear();
+			AnnotationSpan existing = store.GetFrame(video, frame);
+			for (size_t i = 0; i < existing.mCount; i++)
+			{
+				if (existing.mTrack[i] == 0)
+					boxes.push_back(existing[i]);
+			}
+			GetActive(frame, boxes);
+			store.SetFrame(video, frame, boxes);
+		}
+		return frames.size();
+	}
+}
@@ -10,6 +10,7 @@
 #include <FrameExtractorPCH.hpp>
 #include <Core/LoggerManager.hpp>
 #include <Graphics/Video.hpp>
+#include <Graphics/FramePool.hpp>
 #include <GLFW/glfw3.h>
 extern "C"
 {
@@ -18,7 +19,7 @@ extern "C"
 
 namespace FrameExtractor
 {
-	Video::Video(const std::filesystem::path& path)
+	Video::Video(const std::filesystem::path& path, DecodeUseCase useCase, size_t queueCapacity) : mUseCase(useCase), mQueue(queueCapacity), mQueueCapacity(queueCapacity), mReverseQueueCapacity(queueCapacity)
 	{
 
 		formatContext = avformat_alloc_context();
@@ -41,29 +42,19 @@ namespace FrameExtractor
 			FRAMEEX_CORE_ERROR("Failed to find video stream");
 		}
 
-		auto codec = avcodec_find_decoder(videoStream->codecpar->codec_id);
+		codec = avcodec_find_decoder(videoStream->codecpar->codec_id);
 		if (!codec) {
 			FRAMEEX_CORE_ERROR("Failed to find codec");
 		}
 
-		codecContext = avcodec_alloc_context3(codec);
-		if (!codecContext) {
-			FRAMEEX_CORE_ERROR("Failed to allocate codec context");
-		}
-
-		if (avcodec_parameters_to_context(codecContext, videoStream->codecpar) < 0) {
-			FRAMEEX_CORE_ERROR("Failed to copy codec parameters");
-		}
-
-		if (avcodec_open2(codecContext, codec, nullptr) < 0) {
-			FRAMEEX_CORE_ERROR("Failed to open codec");
-		}
+		// Interactive videos scrub with the low latency policy until played
+		OpenDecoder(DecodePolicy::For(useCase == DecodeUseCase::Playback ? DecodeUseCase::Scrubbing : useCase));
 
 		// Get video dimensions
 		mWidth = codecContext->width;
 		mHeight = codecContext->height;
-
-		swsContext = sws_getContext(mWidth, mHeight, codecContext->pix_fmt, mWidth, mHeight, AV_PIX_FMT_RGB24, SWS_BILINEAR, nullptr, nullptr, nullptr);
+		mOutputWidth = mWidth;
+		mOutputHeight = mHeight;
 
 		// Allocate frame structures
 		frame = av_frame_alloc();
@@ -79,25 +70,35 @@ namespace FrameExtractor
 
 	
 		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mWidth, mHeight, 1);
-		uint8_t* buffer = (uint8_t*)av_malloc(numBytes * sizeof(uint8_t));
-		av_image_fill_arrays(RGBframe->data, RGBframe->linesize, buffer, AV_PIX_FMT_RGB24, mWidth, mHeight, 1);
+		// Drawn from the shared pool, so reopening a video of the same size
+		// reuses the buffer the last one gave back
+		mRGBBuffer = FramePool::GetInstance().AcquireBuffer(AV_PIX_FMT_RGB24, mWidth, mHeight, 0, numBytes);
+		if (mRGBBuffer)
+		{
+			av_image_fill_arrays(RGBframe->data, RGBframe->linesize, mRGBBuffer->data, AV_PIX_FMT_RGB24, mWidth, mHeight, 1);
+		}
 
 		packet = av_packet_alloc();
 
-		AVRational fps = videoStream->avg_frame_rate;
-		mFPS = static_cast<float>(fps.num) / fps.den;
-		int64_t duration = videoStream->duration;
-		// Convert stream duration to seconds
-		double duration_seconds = duration * av_q2d(videoStream->time_base);
-		// Calculate the maximum number of frames based on the FPS and duration
-		double max_frames = duration_seconds * mFPS;
-		mMaxFrames = (uint32_t)max_frames;
-		mTexture = MakeRef<Texture>(mWidth, mHeight);
+		// Frame count and rate come from the packet index. It is built with one
+		// demux pass on a thread of its own on first open, the container's
+		// estimates stand in until then, and reused from the sidecar afterwards.
 		mPath = path;
+		if (videoStream && !mIndex.Load(path))
+		{
+			mIndex.Estimate(formatContext, videoStream->index);
+			mIndexThread = std::thread(&Video::IndexLoop, this);
+		}
+		ApplyIndex();
+		mTexture = MakeRef<Texture>(mWidth, mHeight);
 
 	}
 	Video::~Video()
 	{
+		StopPlayback();
+		mStopIndexing = true;
+		if (mIndexThread.joinable())
+			mIndexThread.join();
 		if (formatContext) {
 			avformat_close_input(&formatContext);
 		}
@@ -110,92 +111,823 @@ namespace FrameExtractor
 		if (RGBframe) {
 			av_frame_free(&RGBframe);
 		}
+		av_buffer_unref(&mRGBBuffer);
 		if (swsContext)
 		{
-			sws_freeContext(swsContext);
+			FramePool::GetInstance().ReleaseScaler(swsContext);
 		}
 		if (packet)
 		av_packet_free(&packet);
 
 	}
+	void Video::ApplyIndex()
+	{
+		mMaxFrames = mIndex.GetFrameCount();
+		mFPS = mIndex.GetAverageFPS();
+		if (mFPS <= 0.0 && videoStream && videoStream->avg_frame_rate.den != 0)
+		{
+			mFPS = av_q2d(videoStream->avg_frame_rate);
+		}
+		if (mFPS <= 0.0)
+		{
+			mFPS = 25.0;
+		}
+
+		// Reverse playback queues a whole GOP at a time, up to the byte budget
+		const auto& keyframes = mIndex.GetKeyframes();
+		size_t longestGOP = 0;
+		for (size_t i = 0; i < keyframes.size(); i++)
+		{
+			uint32_t next = i + 1 < keyframes.size() ? keyframes[i + 1] : mMaxFrames;
+			longestGOP = std::max<size_t>(longestGOP, next - keyframes[i]);
+		}
+		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mWidth, mHeight, 1);
+		if (numBytes > 0)
+		{
+			longestGOP = std::min(longestGOP, MAX_REVERSE_QUEUE_BYTES / numBytes);
+		}
+		mReverseQueueCapacity = std::max(mQueueCapacity, longestGOP);
+	}
+
+	// Runs on the index thread with a demuxer of its own, the decode thread
+	// keeps using formatContext meanwhile
+	void Video::IndexLoop()
+	{
+		AVFormatContext* indexContext = nullptr;
+		if (avformat_open_input(&indexContext, mPath.string().c_str(), nullptr, nullptr) != 0)
+		{
+			FRAMEEX_CORE_WARN("Unable to index {}, frame numbers stay estimated", mPath.string());
+			return;
+		}
+
+		VideoIndex index;
+		if (avformat_find_stream_info(indexContext, nullptr) >= 0 && videoStream->index < static_cast<int>(indexContext->nb_streams))
+		{
+			index.Build(indexContext, videoStream->index, &mStopIndexing);
+		}
+		avformat_close_input(&indexContext);
+		if (mStopIndexing || index.IsEmpty())
+			return;
+
+		index.Save(mPath);
+		mBuiltIndex = std::move(index);
+		mIndexReady = true;
+	}
+
+	bool Video::UpdateIndex()
+	{
+		if (!mIndexReady)
+			return false;
+
+		mIndexReady = false;
+		mIndexThread.join();
+		StopPlayback();
+
+		// Estimated and real frame numbers differ, the position carries over by time
+		double time = GetFrameTime(mCurrentFrame) + 0.5 / mFPS;
+		mIndex = std::move(mBuiltIndex);
+		mBuiltIndex = VideoIndex();
+		mCurrentFrame = mIndex.FindFrameAtTime(time);
+		mNextDecodeFrame = mIndex.GetFrameCount();
+		mFrameCache.Clear();
+		ApplyIndex();
+		return true;
+	}
+
+	bool Video::OpenDecoder(const DecodePolicy& policy)
+	{
+		if (codecContext) {
+			avcodec_free_context(&codecContext);
+		}
+
+		codecContext = avcodec_alloc_context3(codec);
+		if (!codecContext) {
+			FRAMEEX_CORE_ERROR("Failed to allocate codec context");
+			return false;
+		}
+
+		if (avcodec_parameters_to_context(codecContext, videoStream->codecpar) < 0) {
+			FRAMEEX_CORE_ERROR("Failed to copy codec parameters");
+			return false;
+		}
+
+		policy.Apply(codecContext);
+		FramePool::Install(codecContext);
+		if (avcodec_open2(codecContext, codec, nullptr) < 0) {
+			FRAMEEX_CORE_ERROR("Failed to open codec");
+			return false;
+		}
+
+		mPolicy = policy;
+		// A fresh decoder knows nothing about the current position
+		mNextDecodeFrame = mIndex.GetFrameCount();
+		return true;
+	}
+
+	void Video::UsePolicyFor(DecodeUseCase useCase)
+	{
+		// Only interactive videos switch, the others keep what they were opened with
+		if (mUseCase != DecodeUseCase::Playback || !codec)
+			return;
+
+		DecodePolicy policy = DecodePolicy::For(useCase);
+		if (!(policy == mPolicy))
+		{
+			OpenDecoder(policy);
+		}
+	}
+
 	Ref<Texture> Video::GetFrame()
 	{
 		return mTexture;
 	}
 	void Video::DecodeTime(float dt, float speedFactor)
 	{
-		time_per_frame = 1.0f / mFPS;  // Standard time per frame based on FPS
+		PlaybackMode mode = PreparePlayback(speedFactor);
+		mEffectiveSpeed = mode == PlaybackMode::Forward && mMeasureEnergy ? ComputeAdaptiveSpeed(speedFactor, dt) : speedFactor;
+		Present(mPlaybackTime + dt * mEffectiveSpeed);
+	}
 
-		// Adjust the time per frame based on the speed factor (this reduces the time interval between frames)
-		time_per_frame /= speedFactor; // If speedFactor = 2, then time_per_frame is halved, i.e., 2x speed
+	void Video::DecodeAt(double seconds, float speedFactor)
+	{
+		PreparePlayback(speedFactor);
+		mEffectiveSpeed = speedFactor;
+		Present(seconds);
+	}
 
-		// Increment last frame time by dt (with speed factor applied)
-		last_frame_time += dt;
+	Video::PlaybackMode Video::PreparePlayback(float speedFactor)
+	{
+		bool reverse = speedFactor < 0.f;
+		PlaybackMode mode = std::abs(speedFactor) >= TRICK_PLAY_SPEED ? PlaybackMode::Keyframes : reverse ? PlaybackMode::Reverse : PlaybackMode::Forward;
+		mSpeedFactor = speedFactor;
+		if (!mDecodeThread.joinable() || mode != mMode || (mode == PlaybackMode::Keyframes && reverse != mKeyframesReverse))
+		{
+			StartPlayback(mode);
+		}
+		return mode;
+	}
 
-		// Skip frames and only process frames when enough time has passed
-		while (last_frame_time >= time_per_frame)
+	void Video::Present(double seconds)
+	{
+		bool reverse = mSpeedFactor < 0.f;
+		mPlaybackTime = seconds;
+		mClock = mPlaybackTime;
+		auto isDue = [this, reverse](const DecodedFrame* queued) {
+			return reverse ? queued->mTime >= mPlaybackTime : queued->mTime <= mPlaybackTime;
+		};
+
+		// Frames that the clock has already passed are dropped, only the latest
+		// one due is uploaded.
+		DecodedFrame* due = nullptr;
+		while (DecodedFrame* front = mQueue.Peek())
 		{
-			// Read frames from the stream
-			while (av_read_frame(formatContext, packet) >= 0)
+			if (!isDue(front))
+				break;
+
+			DecodedFrame* next = mQueue.Peek(1);
+			if (next && isDue(next))
+			{
+				mQueue.Pop();
+				mDroppedFrames++;
+				continue;
+			}
+			due = front;
+			break;
+		}
+
+		if (due)
+		{
+			mTexture->Update(due->mData.data());
+			mCurrentFrame = due->mFrameIndex;
+			if (mMeasureEnergy && due->mEnergy >= mAdaptive.mThreshold)
+				mLastMotionTime = due->mTime;
+			mPresentedFrames++;
+			mQueue.Pop();
+		}
+		else if (mEndOfStream && mQueue.Size() == 0)
+		{
+			// Hold the clock on the last frame instead of running past the end
+			if (reverse)
+				mPlaybackTime = std::max(mPlaybackTime, GetFrameTime(mCurrentFrame));
+			else
+				mPlaybackTime = std::min(mPlaybackTime, GetFrameTime(mCurrentFrame));
+		}
+		else
+		{
+			mUnderruns++;
+		}
+	}
+
+	// Runs on the UI thread. Playback slows down in proportion to how close the
+	// next active frame in the queue is, so it reaches the requested speed as
+	// the motion arrives instead of overshooting it. Speeding up is limited to
+	// ADAPTIVE_ACCELERATION to keep short lulls watchable.
+	float Video::ComputeAdaptiveSpeed(float speedFactor, float dt)
+	{
+		float highSpeed = std::max(speedFactor, mAdaptive.mHighSpeed);
+		double lookAhead = std::max(mAdaptive.mLookAhead, 0.01f);
+
+		// Motion on screen a moment ago keeps the requested speed for one
+		// more look-ahead window, someone may have only paused
+		if (mLastMotionTime >= 0.0 && mPlaybackTime >= mLastMotionTime && mPlaybackTime - mLastMotionTime < lookAhead)
+			return speedFactor;
+
+		// Frames not decoded yet could hold motion, so the queue's end counts as
+		// motion until the end of the stream has been queued
+		double motionTime = mEndOfStream ? std::numeric_limits<double>::max() : mPlaybackTime;
+		for (size_t offset = 0; DecodedFrame* queued = mQueue.Peek(offset); offset++)
+		{
+			if (queued->mEnergy >= mAdaptive.mThreshold && queued->mTime >= mPlaybackTime)
 			{
-				if (packet->stream_index == videoStream->index)
+				motionTime = queued->mTime;
+				break;
+			}
+			if (!mEndOfStream)
+				motionTime = queued->mTime;
+		}
+
+		double distance = std::max(0.0, motionTime - mPlaybackTime);
+		float target = static_cast<float>(std::clamp(speedFactor + (highSpeed - speedFactor) * distance / lookAhead, static_cast<double>(speedFactor), static_cast<double>(highSpeed)));
+		float previous = std::max(mEffectiveSpeed, speedFactor);
+		return std::min(target, previous + ADAPTIVE_ACCELERATION * dt);
+	}
+
+	size_t Video::GetAdaptiveQueueCapacity() const
+	{
+		size_t capacity = mQueueCapacity + static_cast<size_t>(std::ceil(mAdaptive.mLookAhead * mFPS));
+		size_t numBytes = static_cast<size_t>(std::max(0, av_image_get_buffer_size(AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1)));
+		if (numBytes > 0)
+			capacity = std::min(capacity, MAX_ADAPTIVE_QUEUE_BYTES / numBytes);
+		return std::max(capacity, mQueueCapacity);
+	}
+
+	void Video::SetAdaptiveSpeed(const AdaptiveSpeed& adaptive)
+	{
+		// The decode thread only measures energy and sizes the queue on start
+		bool restart = adaptive.mEnabled != mAdaptive.mEnabled || (adaptive.mEnabled && adaptive.mLookAhead != mAdaptive.mLookAhead);
+		mAdaptive = adaptive;
+		mLastMotionTime = -1.0;
+		if (restart && mMode == PlaybackMode::Forward)
+			StopPlayback();
+	}
+
+	void Video::StartPlayback(PlaybackMode mode)
+	{
+		StopPlayback();
+		// Forward play carrying on from the frame on screen keeps the decoder
+		// it has, reopening would mean decoding the GOP up to here again. The
+		// switch happens at the next start that has to seek.
+		bool resumes = mode == PlaybackMode::Forward && mNextDecodeFrame == mCurrentFrame + 1;
+		if (!resumes)
+			UsePolicyFor(DecodeUseCase::Playback);
+		mMeasureEnergy = mode == PlaybackMode::Forward && mAdaptive.mEnabled;
+		mEffectiveSpeed = mSpeedFactor;
+		size_t capacity = mode == PlaybackMode::Reverse ? mReverseQueueCapacity : mMeasureEnergy ? GetAdaptiveQueueCapacity() : mQueueCapacity;
+		if (mQueue.Capacity() != capacity)
+		{
+			mQueue.Resize(capacity);
+		}
+		mQueue.Reset();
+		mMode = mode;
+		mKeyframesReverse = mSpeedFactor < 0.f;
+		mClock = mPlaybackTime;
+		mStopDecoding = false;
+		mEndOfStream = false;
+		switch (mode)
+		{
+		case PlaybackMode::Forward:
+			mDecodeThread = std::thread(&Video::DecodeLoop, this);
+			break;
+		case PlaybackMode::Reverse:
+			mDecodeThread = std::thread(&Video::ReverseDecodeLoop, this);
+			break;
+		case PlaybackMode::Keyframes:
+			mDecodeThread = std::thread(&Video::KeyframeDecodeLoop, this);
+			break;
+		}
+	}
+
+	void Video::StopPlayback()
+	{
+		if (!mDecodeThread.joinable())
+			return;
+
+		mStopDecoding = true;
+		mQueue.Abort();
+		mDecodeThread.join();
+		mQueue.Clear();
+	}
+
+	PlaybackStats Video::GetPlaybackStats() const
+	{
+		PlaybackStats stats;
+		stats.mQueueDepth = mQueue.Size();
+		stats.mQueueCapacity = mQueue.Capacity();
+		stats.mDecodedFrames = mDecodedFrames;
+		stats.mPresentedFrames = mPresentedFrames;
+		stats.mDroppedFrames = mDroppedFrames;
+		stats.mUnderruns = mUnderruns;
+		stats.mKeyframesOnly = mMode == PlaybackMode::Keyframes && mDecodeThread.joinable();
+		stats.mEffectiveSpeed = mEffectiveSpeed;
+		return stats;
+	}
+
+	int64_t Video::GetPTS(const AVFrame* decoded) const
+	{
+		return decoded->best_effort_timestamp != AV_NOPTS_VALUE ? decoded->best_effort_timestamp : decoded->pts;
+	}
+
+	uint32_t Video::GetFrameIndex(const AVFrame* decoded) const
+	{
+		return mIndex.FindFrame(GetPTS(decoded));
+	}
+
+	double Video::GetFrameTime(uint32_t frameIndex) const
+	{
+		return mIndex.GetTime(frameIndex);
+	}
+
+	uint32_t Video::GetFrameAtTime(double seconds) const
+	{
+		return mIndex.FindFrameAtTime(seconds);
+	}
+
+	std::string Video::GetTimecode(uint32_t frameIndex) const
+	{
+		double time = GetFrameTime(frameIndex);
+		int totalSeconds = static_cast<int>(time);
+
+		// Frames are counted from the first frame presented within this second
+		uint32_t firstFrame = GetFrameAtTime(static_cast<double>(totalSeconds));
+		if (GetFrameTime(firstFrame) < totalSeconds && firstFrame < frameIndex)
+			firstFrame++;
+		int frames = static_cast<int>(frameIndex - std::min(firstFrame, frameIndex));
+		int seconds = totalSeconds % 60;
+		int minutes = (totalSeconds / 60) % 60;
+		int hours = totalSeconds / 3600;
+
+		std::ostringstream oss;
+		oss << std::setfill('0')
+			<< std::setw(2) << hours << ":"
+			<< std::setw(2) << minutes << ":"
+			<< std::setw(2) << seconds << ":"
+			<< std::setw(2) << frames;
+		return oss.str();
+	}
+
+	// Runs on the decode thread. It owns formatContext, codecContext, frame and
+	// swsContext until StopPlayback joins it.
+	void Video::DecodeLoop()
+	{
+		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1);
+
+		// Seeks served from the cache leave the decoder elsewhere, frames up to
+		// the one on screen are decoded again but not converted
+		uint32_t resumeAfter = mCurrentFrame;
+		if (mNextDecodeFrame != resumeAfter + 1 && resumeAfter + 1 < mIndex.GetFrameCount())
+		{
+			SeekToKeyframe(mIndex.GetKeyframe(resumeAfter + 1));
+		}
+
+		// Adaptive speed compares each frame with the one before it on a small
+		// luma grid, the same measure the ActivityIndex keeps per video
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* gridScaler = nullptr;
+		std::vector<uint8_t> grid, previousGrid;
+		bool hasPreviousGrid = false;
+		if (mMeasureEnergy)
+		{
+			grid.resize(ActivityIndex::GRID_WIDTH * ActivityIndex::GRID_HEIGHT);
+			previousGrid.resize(grid.size());
+		}
+
+		while (!mStopDecoding)
+		{
+			if (av_read_frame(formatContext, packet) < 0)
+			{
+				// Drain whatever the decoder still holds before signalling the end
+				avcodec_send_packet(codecContext, nullptr);
+				mEndOfStream = true;
+			}
+			else if (packet->stream_index != videoStream->index)
+			{
+				av_packet_unref(packet);
+				continue;
+			}
+			else
+			{
+				avcodec_send_packet(codecContext, packet);
+				av_packet_unref(packet);
+			}
+
+			while (!mStopDecoding && avcodec_receive_frame(codecContext, frame) == 0)
+			{
+				uint32_t decodedIndex = GetFrameIndex(frame);
+				mNextDecodeFrame = decodedIndex + 1;
+
+				uint8_t energy = 0;
+				if (mMeasureEnergy)
+				{
+					if (!gridScaler)
+						gridScaler = pool.AcquireScaler(frame->width, frame->height, frame->format, ActivityIndex::GRID_WIDTH, ActivityIndex::GRID_HEIGHT, AV_PIX_FMT_GRAY8, SWS_AREA);
+					if (gridScaler)
+					{
+						uint8_t* dstData[4] = { grid.data() };
+						int dstLinesize[4] = { static_cast<int>(ActivityIndex::GRID_WIDTH) };
+						sws_scale(gridScaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+						if (hasPreviousGrid)
+							energy = static_cast<uint8_t>(std::min<uint32_t>(255, ActivityIndex::SumAbsDiff(grid.data(), previousGrid.data(), grid.size()) * ActivityIndex::ENERGY_SCALE / static_cast<uint32_t>(grid.size())));
+						grid.swap(previousGrid);
+						hasPreviousGrid = true;
+					}
+				}
+				if (decodedIndex <= resumeAfter)
+					continue;
+
+				DecodedFrame* slot = mQueue.BeginWrite();
+				if (!slot)
+					break;
+
+				slot->mData.resize(numBytes);
+				ConvertFrame(frame, slot->mData.data());
+
+				slot->mWidth = mOutputWidth;
+				slot->mHeight = mOutputHeight;
+				slot->mFrameIndex = decodedIndex;
+				slot->mTime = GetFrameTime(slot->mFrameIndex);
+				slot->mEnergy = energy;
+				mQueue.EndWrite();
+				mDecodedFrames++;
+			}
+
+			if (mEndOfStream)
+			{
+				mNextDecodeFrame = mIndex.GetFrameCount();
+				break;
+			}
+		}
+		pool.ReleaseScaler(gridScaler);
+	}
+
+	// Runs on the decode thread. Each GOP before the frame on screen is decoded
+	// forward into gop and queued last frame first. Queuing only swaps buffers,
+	// so the previous GOP is decoded while this one is still being presented.
+	void Video::ReverseDecodeLoop()
+	{
+		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1);
+		std::vector<DecodedFrame> gop;
+		// GOPs longer than the reverse budget are shown a chunk at a time from
+		// their end, decoding from the keyframe again for each chunk
+		uint32_t maxChunk = numBytes > 0 ? static_cast<uint32_t>(std::max<size_t>(1, MAX_REVERSE_QUEUE_BYTES / numBytes)) : 1;
+
+		// The decoder jumps around, Decode and DecodeLoop have to seek afterwards
+		mNextDecodeFrame = mIndex.GetFrameCount();
+
+		uint32_t end = mCurrentFrame;
+		while (!mStopDecoding && end > 0)
+		{
+			uint32_t keyframe = mIndex.GetKeyframe(end - 1);
+			uint32_t chunkStart = end - keyframe > maxChunk ? end - maxChunk : keyframe;
+			SeekToKeyframe(keyframe);
+
+			size_t count = 0;
+			bool draining = false;
+			bool reachedEnd = false;
+			while (!mStopDecoding && !reachedEnd)
+			{
+				if (av_read_frame(formatContext, packet) < 0)
+				{
+					if (draining)
+						break;
+					avcodec_send_packet(codecContext, nullptr);
+					draining = true;
+				}
+				else if (packet->stream_index != videoStream->index)
+				{
+					av_packet_unref(packet);
+					continue;
+				}
+				else
 				{
 					avcodec_send_packet(codecContext, packet);
+					av_packet_unref(packet);
+				}
 
-					// Process only the first frame (skip subsequent frames within the same time slot)
-					if (avcodec_receive_frame(codecContext, frame) == 0)
+				while (!mStopDecoding && avcodec_receive_frame(codecContext, frame) == 0)
+				{
+					uint32_t decodedIndex = GetFrameIndex(frame);
+					if (decodedIndex < chunkStart)
+						continue;
+					if (decodedIndex >= end)
 					{
-						// Convert frame to the desired format
-						sws_scale(swsContext, frame->data, frame->linesize, 0, mHeight, RGBframe->data, RGBframe->linesize);
-
-						// Update the texture with the new frame data
-						mTexture->Update(RGBframe->data[0]);
+						reachedEnd = true;
+						break;
+					}
 
-						// Break to stop after processing just one frame (to skip others)
+					if (count == gop.size())
+						gop.emplace_back();
+					DecodedFrame& decoded = gop[count++];
+					decoded.mData.resize(numBytes);
+					ConvertFrame(frame, decoded.mData.data());
+					decoded.mWidth = mOutputWidth;
+					decoded.mHeight = mOutputHeight;
+					decoded.mFrameIndex = decodedIndex;
+					decoded.mTime = GetFrameTime(decodedIndex);
+
+					if (decodedIndex + 1 == end)
+					{
+						reachedEnd = true;
 						break;
 					}
 				}
+			}
+
+			for (size_t i = count; i-- > 0 && !mStopDecoding;)
+			{
+				DecodedFrame* slot = mQueue.BeginWrite();
+				if (!slot)
+					break;
+
+				// The slot's old buffer is reused for the next GOP
+				slot->mData.swap(gop[i].mData);
+				slot->mWidth = gop[i].mWidth;
+				slot->mHeight = gop[i].mHeight;
+				slot->mFrameIndex = gop[i].mFrameIndex;
+				slot->mTime = gop[i].mTime;
+				slot->mEnergy = 0;
+				mQueue.EndWrite();
+				mDecodedFrames++;
+			}
+
+			end = chunkStart;
+		}
+
+		mEndOfStream = true;
+	}
+
+	// Runs on the decode thread. Only keyframes are decoded, each one on its own
+	// straight after a seek, so the cost per shown frame does not depend on the
+	// GOP length. Keyframes closer together than one displayed frame at the
+	// current speed, or already behind the playback clock, are skipped without
+	// being read.
+	void Video::KeyframeDecodeLoop()
+	{
+		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1);
+		const std::vector<uint32_t>& keyframes = mIndex.GetKeyframes();
+		bool reverse = mKeyframesReverse;
+
+		mNextDecodeFrame = mIndex.GetFrameCount();
+		codecContext->skip_frame = AVDISCARD_NONKEY;
+
+		// Next keyframe after the frame on screen in the direction of play
+		int64_t next = reverse
+			? static_cast<int64_t>(std::lower_bound(keyframes.begin(), keyframes.end(), mCurrentFrame) - keyframes.begin()) - 1
+			: static_cast<int64_t>(std::upper_bound(keyframes.begin(), keyframes.end(), mCurrentFrame) - keyframes.begin());
+		int64_t step = reverse ? -1 : 1;
+		double lastTime = GetFrameTime(mCurrentFrame);
+
+		for (; !mStopDecoding && next >= 0 && next < static_cast<int64_t>(keyframes.size()); next += step)
+		{
+			uint32_t keyframe = keyframes[next];
+			double time = GetFrameTime(keyframe);
+			double stride = std::abs(mSpeedFactor.load()) / mFPS;
+			double clock = mClock;
+			bool late = reverse ? time > clock : time < clock;
+			bool tooClose = reverse ? time > lastTime - stride : time < lastTime + stride;
+			bool last = next + step < 0 || next + step >= static_cast<int64_t>(keyframes.size());
+			if ((late || tooClose) && !last)
+				continue;
+
+			SeekToKeyframe(keyframe);
+			while (av_read_frame(formatContext, packet) >= 0)
+			{
+				bool isVideo = packet->stream_index == videoStream->index;
+				if (isVideo)
+					avcodec_send_packet(codecContext, packet);
 				av_packet_unref(packet);
+				if (isVideo)
+					break;
 			}
+			avcodec_send_packet(codecContext, nullptr);
 
-			// Reduce last_frame_time by time_per_frame for the next frame's calculation
-			last_frame_time -= time_per_frame;
+			bool queued = false;
+			while (avcodec_receive_frame(codecContext, frame) == 0)
+			{
+				if (queued || mStopDecoding)
+					continue;
+
+				DecodedFrame* slot = mQueue.BeginWrite();
+				if (!slot)
+					break;
+
+				slot->mData.resize(numBytes);
+				ConvertFrame(frame, slot->mData.data());
+
+				slot->mWidth = mOutputWidth;
+				slot->mHeight = mOutputHeight;
+				slot->mFrameIndex = keyframe;
+				slot->mTime = time;
+				slot->mEnergy = 0;
+				mQueue.EndWrite();
+				mDecodedFrames++;
+				lastTime = time;
+				queued = true;
+			}
 		}
+
+		codecContext->skip_frame = AVDISCARD_DEFAULT;
+		avcodec_flush_buffers(codecContext);
+		mEndOfStream = true;
 	}
 
-	bool Video::Decode(uint32_t frameIndex)
+	void Video::ConvertFrame(const AVFrame* decoded, uint8_t* dst)
+	{
+		// Same size 4:2:0 frames take the SIMD path, anything else goes through swscale
+		bool native = decoded->width == static_cast<int>(mOutputWidth) && decoded->height == static_cast<int>(mOutputHeight);
+		if (native && mConverter.Convert(decoded, dst, mOutputWidth * 3))
+			return;
+
+		std::array<int, 6> geometry = { decoded->width, decoded->height, decoded->format,
+			static_cast<int>(mOutputWidth), static_cast<int>(mOutputHeight), native ? SWS_BILINEAR : SWS_FAST_BILINEAR };
+		if (!swsContext || geometry != mScalerGeometry)
+		{
+			FramePool& pool = FramePool::GetInstance();
+			if (swsContext)
+				pool.ReleaseScaler(swsContext);
+			swsContext = pool.AcquireScaler(geometry[0], geometry[1], geometry[2], geometry[3], geometry[4], AV_PIX_FMT_RGB24, geometry[5]);
+			mScalerGeometry = geometry;
+			if (!swsContext)
+			{
+				FRAMEEX_CORE_ERROR("Failed to create scaler for {}x{}", decoded->width, decoded->height);
+				return;
+			}
+		}
+		uint8_t* dstData[4] = {};
+		int dstLinesize[4] = {};
+		av_image_fill_arrays(dstData, dstLinesize, dst, AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1);
+		sws_scale(swsContext, decoded->data, decoded->linesize, 0, decoded->height, dstData, dstLinesize);
+		mConverter.ApplyAdjust(dst, mOutputWidth, mOutputHeight, mOutputWidth * 3);
+	}
+
+	bool Video::SetOutputSize(uint32_t width, uint32_t height)
+	{
+		// Never upscale, the texture sampler does that for free
+		width = width == 0 ? mWidth : std::clamp(width, std::min(MIN_OUTPUT_SIZE, mWidth), mWidth);
+		height = height == 0 ? mHeight : std::clamp(height, std::min(MIN_OUTPUT_SIZE, mHeight), mHeight);
+
+		// Small resizes keep the current size, so dragging a splitter does not
+		// rebuild the texture every frame. Growing past the band or reaching
+		// native size always applies.
+		auto outsideBand = [](uint32_t target, uint32_t current) {
+			return target > current * OUTPUT_GROW_THRESHOLD || target < current * OUTPUT_SHRINK_THRESHOLD;
+		};
+		bool toNative = width == mWidth && height == mHeight;
+		bool isNative = mOutputWidth == mWidth && mOutputHeight == mHeight;
+		if (toNative ? isNative : !outsideBand(width, mOutputWidth) && !outsideBand(height, mOutputHeight))
+			return false;
+
+		StopPlayback();
+		mOutputWidth = width;
+		mOutputHeight = height;
+		mTexture = MakeRef<Texture>(mOutputWidth, mOutputHeight);
+		mFrameCache.Clear();
+
+		// Grid tiles decode no larger than they are shown, where the codec can
+		if (mUseCase == DecodeUseCase::Grid && codec)
+		{
+			DecodePolicy policy = mPolicy;
+			policy.mLowres = 0;
+			while (policy.mLowres < codec->max_lowres && (mWidth >> (policy.mLowres + 1)) >= mOutputWidth && (mHeight >> (policy.mLowres + 1)) >= mOutputHeight)
+				policy.mLowres++;
+			if (!(policy == mPolicy))
+				OpenDecoder(policy);
+		}
+		return true;
+	}
+
+	void Video::SetColorAdjust(const ColorAdjust& adjust)
+	{
+		if (adjust == mConverter.GetAdjust())
+			return;
+
+		mConverter.SetAdjust(adjust);
+		// Cached frames were converted with the old settings
+		mFrameCache.Clear();
+	}
+
+	void Video::SeekToKeyframe(uint32_t keyframe)
 	{
-		int fps = av_q2d(formatContext->streams[videoStream->index]->r_frame_rate);
-		int64_t timestamp = av_rescale_q(frameIndex,  { 1, fps }, formatContext->streams[videoStream->index]->time_base);
+		const IndexEntry& entry = mIndex.GetEntry(keyframe);
 
-		av_seek_frame(formatContext, videoStream->index, timestamp, AVSEEK_FLAG_BACKWARD);
+		// Byte offsets are exact for containers that allow it (e.g. MPEG-TS),
+		// MP4 and friends seek through their own sample tables instead
+		bool byteSeek = entry.mPos >= 0 && !(formatContext->iformat->flags & AVFMT_NO_BYTE_SEEK);
+		if (!byteSeek || av_seek_frame(formatContext, videoStream->index, entry.mPos, AVSEEK_FLAG_BYTE) < 0)
+		{
+			av_seek_frame(formatContext, videoStream->index, entry.mPTS, AVSEEK_FLAG_BACKWARD);
+		}
 		avcodec_flush_buffers(codecContext);
+	}
 
-		AVPacket pkt;
-		bool frameLoaded = false;
+	bool Video::Decode(uint32_t frameIndex)
+	{
+		StopPlayback();
+		if (!DecodeFrame(frameIndex))
+			return false;
+		ShowDecodedFrame();
+		return true;
+	}
+
+	void Video::ShowDecodedFrame()
+	{
+		if (!mDecodedData)
+			return;
+		mTexture->Update(mDecodedData);
+		mCurrentFrame = mDecodedFrame;
+		mPlaybackTime = GetFrameTime(mDecodedFrame);
+		mDecodedData = nullptr;
+	}
 
-		while (av_read_frame(formatContext, &pkt) >= 0) {
-			if (pkt.stream_index == videoStream->index) {
-				if (avcodec_send_packet(codecContext, &pkt) == 0) {
-					while (avcodec_receive_frame(codecContext, frame) == 0) {
-						// Recalculate frame PTS (if needed)
-						int64_t current_frame = av_rescale_q(frame->pts, formatContext->streams[videoStream->index]->time_base, { 1, mFPS });
-						if (current_frame >= frameIndex) {
-							sws_scale(swsContext, frame->data, frame->linesize, 0, mHeight, RGBframe->data, RGBframe->linesize);
+	bool Video::DecodeFrame(uint32_t frameIndex)
+	{
+		mDecodedData = nullptr;
+		if (mIndex.IsEmpty())
+			return false;
 
-							mTexture->Update(RGBframe->data[0]);
+		frameIndex = std::min(frameIndex, mIndex.GetFrameCount() - 1);
+		if (const CachedFrame* cached = mFrameCache.Get(frameIndex))
+		{
+			mDecodedData = cached->mData.data();
+			mDecodedFrame = frameIndex;
+			return true;
+		}
 
-							frameLoaded = true;
-							break;
-						}
-					}
+		// Stepping forward within the GOP carries on from where the decoder is,
+		// anything else restarts from the keyframe
+		uint32_t keyframe = mIndex.GetKeyframe(frameIndex);
+		if (mNextDecodeFrame < keyframe || mNextDecodeFrame > frameIndex)
+		{
+			// Switching policy reopens the decoder, which only costs nothing
+			// when it is about to be flushed by the seek anyway
+			UsePolicyFor(DecodeUseCase::Scrubbing);
+			SeekToKeyframe(keyframe);
+			mNextDecodeFrame = keyframe;
+		}
+
+		// Frames leading up to the target are converted into the cache so that
+		// stepping back through them never touches the decoder. At most half of
+		// the budget is spent on one GOP.
+		int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, mOutputWidth, mOutputHeight, 1);
+		uint32_t window = numBytes > 0 ? static_cast<uint32_t>(std::max<size_t>(1, mFrameCache.GetBudget() / numBytes / 2)) : 1;
+		uint32_t firstCached = frameIndex > keyframe + window ? frameIndex - window : keyframe;
+
+		bool frameLoaded = false;
+		bool draining = false;
+		while (!frameLoaded) {
+			if (av_read_frame(formatContext, packet) < 0) {
+				// The target may still be buffered inside the decoder
+				if (draining)
+					break;
+				avcodec_send_packet(codecContext, nullptr);
+				draining = true;
+			}
+			else if (packet->stream_index != videoStream->index) {
+				av_packet_unref(packet);
+				continue;
+			}
+			else {
+				avcodec_send_packet(codecContext, packet);
+				av_packet_unref(packet);
+			}
+
+			while (avcodec_receive_frame(codecContext, frame) == 0) {
+				uint32_t decodedIndex = GetFrameIndex(frame);
+				mNextDecodeFrame = decodedIndex + 1;
+				if (decodedIndex < firstCached || (decodedIndex < frameIndex && mFrameCache.Contains(decodedIndex)))
+					continue;
+
+				CachedFrame* cached = mFrameCache.Insert(decodedIndex, numBytes);
+				if (cached) {
+					cached->mWidth = mOutputWidth;
+					cached->mHeight = mOutputHeight;
+					ConvertFrame(frame, cached->mData.data());
+				}
+
+				if (decodedIndex >= frameIndex) {
+					if (!cached)
+						ConvertFrame(frame, RGBframe->data[0]);
+					mDecodedData = cached ? cached->mData.data() : RGBframe->data[0];
+					mDecodedFrame = frameIndex;
+					frameLoaded = true;
+					break;
 				}
 			}
-			av_packet_unref(&pkt);
-			if (frameLoaded) break;
 		}
 
+		// A drained decoder has to be flushed before it accepts packets again
+		if (draining)
+			mNextDecodeFrame = mIndex.GetFrameCount();
+
 		return frameLoaded;
 	}
 }
-
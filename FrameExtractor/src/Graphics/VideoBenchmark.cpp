@@ -0,0 +1,332 @@
+/******************************************************************************
+/*!
+\file       VideoBenchmark.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Video Benchmark class, which times decoding under each
+			decode policy and frame conversion on synthetic data in the background.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/VideoBenchmark.hpp>
+#include <Graphics/ColorConverter.hpp>
+#include <Graphics/DecodeSession.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace FrameExtractor
+{
+	struct BenchmarkClip
+	{
+		const char* mName;
+		int mWidth;
+		int mHeight;
+		int mFrames;
+	};
+
+	static constexpr int BENCHMARK_FPS = 25;
+	static constexpr BenchmarkClip BENCHMARK_CLIPS[] = {
+		{ "1080p", 1920, 1080, 250 },
+		{ "4K", 3840, 2160, 125 }
+	};
+
+	static constexpr DecodeUseCase BENCHMARK_USE_CASES[] = {
+		DecodeUseCase::Playback,
+		DecodeUseCase::Scrubbing,
+		DecodeUseCase::Analysis,
+		DecodeUseCase::Thumbnail,
+		DecodeUseCase::Grid,
+		DecodeUseCase::Background
+	};
+
+	VideoBenchmark::~VideoBenchmark()
+	{
+		if (mThread.joinable())
+			mThread.join();
+	}
+
+	void VideoBenchmark::StartDecodeBenchmark()
+	{
+		Start(&VideoBenchmark::RunDecodeBenchmark);
+	}
+
+	void VideoBenchmark::StartConvertBenchmark()
+	{
+		Start(&VideoBenchmark::RunConvertBenchmark);
+	}
+
+	void VideoBenchmark::Start(void (VideoBenchmark::* run)())
+	{
+		if (mRunning)
+			return;
+		if (mThread.joinable())
+			mThread.join();
+
+		mRunning = true;
+		mThread = std::thread(run, this);
+	}
+
+	std::vector<std::string> VideoBenchmark::TakeMessages()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return std::move(mMessages);
+	}
+
+	void VideoBenchmark::Report(std::string message)
+	{
+		FRAMEEX_CORE_INFO("{}", message);
+		std::lock_guard<std::mutex> lock(mMutex);
+		mMessages.push_back(std::move(message));
+	}
+
+	void VideoBenchmark::RunDecodeBenchmark()
+	{
+		for (const BenchmarkClip& clip : BENCHMARK_CLIPS)
+		{
+			std::filesystem::path path = std::filesystem::temp_directory_path() / ("frameex_benchmark_" + std::string(clip.mName) + ".mp4");
+			if (!std::filesystem::exists(path) || !IsClipUsable(path, clip.mWidth, clip.mHeight, clip.mFrames))
+			{
+				Report("Generating " + std::string(clip.mName) + " H.264 clip...");
+				if (!GenerateClip(path, clip.mWidth, clip.mHeight, clip.mFrames))
+				{
+					Report("Unable to generate the " + std::string(clip.mName) + " clip, no usable H.264 encoder");
+					std::error_code ec;
+					std::filesystem::remove(path, ec);
+					continue;
+				}
+			}
+
+			for (DecodeUseCase useCase : BENCHMARK_USE_CASES)
+			{
+				DecodePolicy policy = DecodePolicy::For(useCase);
+				uint32_t frameCount = 0;
+				double fps = MeasureDecode(path, policy, frameCount);
+
+				std::ostringstream oss;
+				oss << clip.mName << " " << DecodePolicy::GetName(useCase) << " (" << policy.mThreadCount << " threads): "
+					<< std::fixed << std::setprecision(1) << fps << " fps over " << frameCount << " frames";
+				Report(oss.str());
+			}
+		}
+		Report("Decode benchmark finished");
+		mRunning = false;
+	}
+
+	void VideoBenchmark::RunConvertBenchmark()
+	{
+		static constexpr int ITERATIONS = 30;
+		static constexpr AVPixelFormat FORMATS[] = { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12 };
+
+		auto timeIt = [](const std::function<void()>& convert) {
+			convert(); // Warm up caches and page in the destination
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++)
+				convert();
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / ITERATIONS;
+		};
+
+		std::mt19937 random(1234);
+		for (const BenchmarkClip& clip : BENCHMARK_CLIPS)
+		{
+			for (AVPixelFormat format : FORMATS)
+			{
+				AVFrame* frame = av_frame_alloc();
+				frame->format = format;
+				frame->width = clip.mWidth;
+				frame->height = clip.mHeight;
+				if (av_frame_get_buffer(frame, 0) < 0)
+				{
+					av_frame_free(&frame);
+					continue;
+				}
+				for (int plane = 0; plane < AV_NUM_DATA_POINTERS && frame->buf[plane]; plane++)
+				{
+					for (size_t i = 0; i < frame->buf[plane]->size; i++)
+						frame->buf[plane]->data[i] = static_cast<uint8_t>(random());
+				}
+
+				int stride = clip.mWidth * 3;
+				std::vector<uint8_t> rgb(static_cast<size_t>(stride) * clip.mHeight);
+				uint8_t* dstData[4] = { rgb.data() };
+				int dstLinesize[4] = { stride };
+				SwsContext* swsContext = sws_getContext(clip.mWidth, clip.mHeight, format, clip.mWidth, clip.mHeight, AV_PIX_FMT_RGB24, SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+				std::string name = std::string(clip.mName) + " " + av_get_pix_fmt_name(format);
+				auto report = [&](const std::string& label, double ms) {
+					std::ostringstream oss;
+					oss << name << " " << label << ": " << std::fixed << std::setprecision(2) << ms << " ms/frame";
+					Report(oss.str());
+				};
+
+				if (swsContext)
+				{
+					report("sws_scale", timeIt([&]() { sws_scale(swsContext, frame->data, frame->linesize, 0, clip.mHeight, dstData, dstLinesize); }));
+					sws_freeContext(swsContext);
+				}
+
+				ColorConverter converter;
+				for (int path = static_cast<int>(ColorConverter::GetBestPath()); path >= 0; path--)
+				{
+					converter.SetPath(static_cast<ColorConverter::Path>(path));
+					const char* pathName = ColorConverter::GetPathName(converter.GetPath());
+
+					converter.SetAdjust(ColorAdjust());
+					report(pathName, timeIt([&]() { converter.Convert(frame, rgb.data(), stride); }));
+
+					ColorAdjust adjust;
+					adjust.mBrightness = 0.1f;
+					adjust.mContrast = 1.2f;
+					adjust.mGamma = 1.8f;
+					converter.SetAdjust(adjust);
+					report(std::string(pathName) + " + adjust", timeIt([&]() { converter.Convert(frame, rgb.data(), stride); }));
+				}
+				av_frame_free(&frame);
+			}
+		}
+		Report("Conversion benchmark finished");
+		mRunning = false;
+	}
+
+	bool VideoBenchmark::GenerateClip(const std::filesystem::path& path, int width, int height, int frameCount)
+	{
+		const AVCodec* encoder = avcodec_find_encoder_by_name("libx264");
+		if (!encoder)
+			encoder = avcodec_find_encoder(AV_CODEC_ID_H264);
+		if (!encoder)
+			return false;
+
+		AVFormatContext* formatContext = nullptr;
+		if (avformat_alloc_output_context2(&formatContext, nullptr, nullptr, path.string().c_str()) < 0)
+			return false;
+
+		AVCodecContext* encoderContext = avcodec_alloc_context3(encoder);
+		encoderContext->width = width;
+		encoderContext->height = height;
+		encoderContext->pix_fmt = AV_PIX_FMT_YUV420P;
+		encoderContext->time_base = { 1, BENCHMARK_FPS };
+		encoderContext->framerate = { BENCHMARK_FPS, 1 };
+		// Typical of CCTV exports: two second GOPs with B-frames
+		encoderContext->gop_size = 50;
+		encoderContext->max_b_frames = 2;
+		encoderContext->bit_rate = static_cast<int64_t>(width) * height * 2;
+		if (formatContext->oformat->flags & AVFMT_GLOBALHEADER)
+			encoderContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+		av_opt_set(encoderContext->priv_data, "preset", "veryfast", 0);
+
+		AVStream* stream = avformat_new_stream(formatContext, nullptr);
+		bool ok = stream && avcodec_open2(encoderContext, encoder, nullptr) >= 0
+			&& avcodec_parameters_from_context(stream->codecpar, encoderContext) >= 0
+			&& avio_open(&formatContext->pb, path.string().c_str(), AVIO_FLAG_WRITE) >= 0;
+		if (ok)
+		{
+			stream->time_base = encoderContext->time_base;
+			ok = avformat_write_header(formatContext, nullptr) >= 0;
+		}
+
+		AVFrame* frame = av_frame_alloc();
+		AVPacket* packet = av_packet_alloc();
+		frame->format = AV_PIX_FMT_YUV420P;
+		frame->width = width;
+		frame->height = height;
+		ok = ok && av_frame_get_buffer(frame, 0) >= 0;
+
+		// A moving gradient with a noisy band, so that motion search and
+		// residual coding both have something to do
+		std::mt19937 random(1234);
+		auto drain = [&]() {
+			while (avcodec_receive_packet(encoderContext, packet) == 0)
+			{
+				av_packet_rescale_ts(packet, encoderContext->time_base, stream->time_base);
+				packet->stream_index = stream->index;
+				av_interleaved_write_frame(formatContext, packet);
+			}
+		};
+		for (int i = 0; ok && i < frameCount; i++)
+		{
+			ok = av_frame_make_writable(frame) >= 0;
+			for (int y = 0; y < height; y++)
+			{
+				uint8_t* row = frame->data[0] + static_cast<size_t>(y) * frame->linesize[0];
+				bool noisy = ((y + i * 4) / 64) % 8 == 0;
+				for (int x = 0; x < width; x++)
+					row[x] = static_cast<uint8_t>(noisy ? random() : x + y + i * 3);
+			}
+			for (int plane = 1; plane < 3; plane++)
+			{
+				for (int y = 0; y < height / 2; y++)
+				{
+					uint8_t* row = frame->data[plane] + static_cast<size_t>(y) * frame->linesize[plane];
+					for (int x = 0; x < width / 2; x++)
+						row[x] = static_cast<uint8_t>(128 + (plane == 1 ? x - i : y + i) / 4);
+				}
+			}
+			frame->pts = i;
+			ok = ok && avcodec_send_frame(encoderContext, frame) >= 0;
+			drain();
+		}
+		if (ok)
+		{
+			avcodec_send_frame(encoderContext, nullptr);
+			drain();
+			av_write_trailer(formatContext);
+		}
+
+		av_packet_free(&packet);
+		av_frame_free(&frame);
+		avcodec_free_context(&encoderContext);
+		if (formatContext->pb)
+			avio_closep(&formatContext->pb);
+		avformat_free_context(formatContext);
+		return ok;
+	}
+
+	bool VideoBenchmark::IsClipUsable(const std::filesystem::path& path, int width, int height, int frameCount)
+	{
+		DecodeSession session;
+		if (!session.OpenInput(path))
+			return false;
+		const AVStream* stream = session.GetStream();
+		if (stream->codecpar->codec_id != AV_CODEC_ID_H264 || stream->codecpar->width != width || stream->codecpar->height != height)
+			return false;
+
+		// Demuxing is cheap next to the decode passes, and the count does not
+		// depend on the container filling in nb_frames
+		int64_t packets = 0;
+		while (session.ReadPacket() >= 0)
+		{
+			packets++;
+			av_packet_unref(session.GetPacket());
+		}
+		double duration = stream->duration != AV_NOPTS_VALUE ? stream->duration * av_q2d(stream->time_base) : 0.0;
+		return packets == frameCount && std::abs(duration - static_cast<double>(frameCount) / BENCHMARK_FPS) < 1.0 / BENCHMARK_FPS;
+	}
+
+	double VideoBenchmark::MeasureDecode(const std::filesystem::path& path, const DecodePolicy& policy, uint32_t& frameCount)
+	{
+		frameCount = 0;
+		// Frames come from the pool, as they do everywhere else in the app
+		DecodeSession session;
+		if (!session.Open(path, policy))
+			return 0.0;
+
+		AVFrame* frame = av_frame_alloc();
+		auto start = std::chrono::high_resolution_clock::now();
+		while (session.ReceiveFrame(frame) == 0)
+		{
+			frameCount++;
+			av_frame_unref(frame);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		av_frame_free(&frame);
+		return seconds > 0.0 ? frameCount / seconds : 0.0;
+	}
+}
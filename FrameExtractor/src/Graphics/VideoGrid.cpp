@@ -0,0 +1,233 @@
+/******************************************************************************
+/*!
+\file       VideoGrid.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Video Grid class, several videos played side by side
+			under one playback clock.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/VideoGrid.hpp>
+
+namespace FrameExtractor
+{
+	bool VideoGrid::AddVideo(const std::filesystem::path& path, double offset, double start, double end)
+	{
+		if (!PushTile(path, offset, start, end))
+			return false;
+		ShareCacheBudget();
+		Seek(mClock);
+		return true;
+	}
+
+	bool VideoGrid::AddSegments(const std::filesystem::path& path, size_t count)
+	{
+		Clear();
+		if (!PushTile(path, 0.0, 0.0, 0.0))
+			return false;
+
+		count = std::clamp<size_t>(count, 1, MAX_TILES);
+		double length = mTiles.front().mEnd / count;
+		mTiles.front().mRequestedEnd = length;
+		UpdateBounds(mTiles.front());
+		for (size_t i = 1; i < count; i++)
+		{
+			double start = length * i;
+			if (!PushTile(path, start, start, i + 1 == count ? 0.0 : start + length))
+				break;
+		}
+		// Every segment has its own decoder, one seek decodes them all at once
+		ShareCacheBudget();
+		Seek(0.0);
+		return true;
+	}
+
+	bool VideoGrid::PushTile(const std::filesystem::path& path, double offset, double start, double end)
+	{
+		if (mTiles.size() >= MAX_TILES)
+			return false;
+
+		GridTile tile;
+		tile.mVideo = MakeScope<Video>(path, DecodeUseCase::Grid);
+		if (tile.mVideo->GetIndex().IsEmpty())
+		{
+			FRAMEEX_CORE_WARN("VideoGrid: unable to index {}", path.string());
+			return false;
+		}
+		tile.mVideo->UpdateIndex();
+		tile.mOffset = offset;
+		tile.mRequestedStart = start;
+		tile.mRequestedEnd = end;
+		UpdateBounds(tile);
+		// The caller's Seek stops the other tiles and lines them all up again
+		mPlaying = false;
+		mTiles.push_back(std::move(tile));
+		return true;
+	}
+
+	void VideoGrid::RemoveTile(size_t tile)
+	{
+		if (tile < mTiles.size())
+			mTiles.erase(mTiles.begin() + tile);
+		if (mTiles.empty())
+			Clear();
+		else
+			ShareCacheBudget();
+	}
+
+	void VideoGrid::Clear()
+	{
+		mTiles.clear();
+		mClock = 0.0;
+		mPlaying = false;
+	}
+
+	void VideoGrid::SetOffset(size_t tile, double offset)
+	{
+		if (tile >= mTiles.size())
+			return;
+		mTiles[tile].mOffset = offset;
+		mPlaying = false;
+		Seek(mClock);
+	}
+
+	void VideoGrid::GetLayout(size_t count, uint32_t& columns, uint32_t& rows)
+	{
+		columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(std::max<size_t>(count, 1)))));
+		rows = static_cast<uint32_t>((std::max<size_t>(count, 1) + columns - 1) / columns);
+	}
+
+	void VideoGrid::SetTileSize(uint32_t width, uint32_t height)
+	{
+		for (GridTile& tile : mTiles)
+		{
+			Video& video = *tile.mVideo;
+			float scale = std::min(static_cast<float>(width) / video.GetWidth(), static_cast<float>(height) / video.GetHeight());
+			uint32_t outputWidth = static_cast<uint32_t>(std::max(1.f, video.GetWidth() * scale));
+			uint32_t outputHeight = static_cast<uint32_t>(std::max(1.f, video.GetHeight() * scale));
+			// Playing tiles pick the new size up when their thread restarts
+			if (video.SetOutputSize(outputWidth, outputHeight) && !mPlaying)
+				video.Decode(video.GetCurrentFrame());
+		}
+	}
+
+	void VideoGrid::SetCacheBudget(size_t bytes)
+	{
+		mCacheBudget = bytes;
+		ShareCacheBudget();
+	}
+
+	void VideoGrid::ShareCacheBudget()
+	{
+		for (GridTile& tile : mTiles)
+			tile.mVideo->SetCacheBudget(mCacheBudget / mTiles.size());
+	}
+
+	double VideoGrid::GetDuration() const
+	{
+		double duration = 0.0;
+		for (const GridTile& tile : mTiles)
+			duration = std::max(duration, tile.mEnd - tile.mOffset);
+		return duration;
+	}
+
+	double VideoGrid::GetTileTime(size_t tile) const
+	{
+		const GridTile& gridTile = mTiles[tile];
+		return std::clamp(mClock + gridTile.mOffset, gridTile.mStart, gridTile.mEnd);
+	}
+
+	void VideoGrid::UpdateBounds(GridTile& tile)
+	{
+		double duration = tile.mVideo->GetIndex().GetDuration();
+		tile.mStart = std::clamp(tile.mRequestedStart, 0.0, duration);
+		tile.mEnd = tile.mRequestedEnd > 0.0 ? std::clamp(tile.mRequestedEnd, tile.mStart, duration) : duration;
+	}
+
+	// Tiles are driven by time, so the built index can swap in mid play, but
+	// the estimated duration it replaces may have cut a tile short or run past
+	// the end
+	void VideoGrid::UpdateIndexes()
+	{
+		for (GridTile& tile : mTiles)
+			if (tile.mVideo->UpdateIndex())
+				UpdateBounds(tile);
+	}
+
+	void VideoGrid::ShowHeld(GridTile& tile, double time)
+	{
+		Video& video = *tile.mVideo;
+		uint32_t frame = video.GetFrameAtTime(time);
+		if (!tile.mHeld || video.GetCurrentFrame() != frame)
+			video.Decode(frame);
+		tile.mHeld = true;
+	}
+
+	bool VideoGrid::Play(float dt, float speedFactor)
+	{
+		if (mTiles.empty())
+			return false;
+
+		UpdateIndexes();
+		double duration = GetDuration();
+		mClock = std::clamp(mClock + dt * speedFactor, 0.0, duration);
+		mPlaying = true;
+		for (GridTile& tile : mTiles)
+		{
+			double time = mClock + tile.mOffset;
+			// The last frame of a tile lasts until its end, the end itself is outside
+			if (time < tile.mStart || time >= tile.mEnd)
+			{
+				ShowHeld(tile, std::clamp(time, tile.mStart, tile.mEnd));
+				continue;
+			}
+			tile.mHeld = false;
+			tile.mVideo->DecodeAt(time, speedFactor);
+		}
+
+		bool finished = speedFactor > 0.f ? mClock >= duration : speedFactor < 0.f && mClock <= 0.0;
+		if (finished)
+			Pause();
+		return !finished;
+	}
+
+	void VideoGrid::Pause()
+	{
+		mPlaying = false;
+		// Tiles that were behind when stopped catch up to the clock
+		Seek(mClock);
+	}
+
+	void VideoGrid::Seek(double seconds)
+	{
+		for (GridTile& tile : mTiles)
+			tile.mVideo->StopPlayback();
+		UpdateIndexes();
+		mClock = std::clamp(seconds, 0.0, GetDuration());
+
+		// Each tile seeks its own decoder on a thread of its own, only the
+		// texture uploads wait for the UI thread
+		std::vector<std::thread> decoders;
+		std::vector<uint8_t> decoded(mTiles.size(), 0);
+		for (size_t i = 1; i < mTiles.size(); i++)
+		{
+			Video& video = *mTiles[i].mVideo;
+			uint32_t frame = video.GetFrameAtTime(GetTileTime(i));
+			decoders.emplace_back([&video, frame, &result = decoded[i]]() { result = video.DecodeFrame(frame); });
+		}
+		if (!mTiles.empty())
+			decoded[0] = mTiles[0].mVideo->DecodeFrame(mTiles[0].mVideo->GetFrameAtTime(GetTileTime(0)));
+		for (std::thread& decoder : decoders)
+			decoder.join();
+
+		for (size_t i = 0; i < mTiles.size(); i++)
+		{
+			if (decoded[i])
+				mTiles[i].mVideo->ShowDecodedFrame();
+			mTiles[i].mHeld = false;
+		}
+	}
+}
@@ -0,0 +1,321 @@
+/******************************************************************************
+/*!
+\file       VideoIndex.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Video Index class, a per video table of packet
+			timestamps, keyframe flags and byte offsets in presentation order.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/VideoIndex.hpp>
+#include <thread>
+extern "C"
+{
+#include <libavformat/avformat.h>
+}
+
+namespace FrameExtractor
+{
+	static constexpr uint32_t INDEX_MAGIC = 0x49585246; // "FRXI"
+	static constexpr uint32_t INDEX_VERSION = 1;
+
+	struct IndexHeader
+	{
+		uint32_t mMagic;
+		uint32_t mVersion;
+		uint64_t mFileSize;
+		int64_t mWriteTime;
+		int64_t mStartPTS;
+		int32_t mTimeBaseNum;
+		int32_t mTimeBaseDen;
+		uint64_t mCount;
+	};
+
+	// PTS, byte offset and keyframe flag, written field by field
+	static constexpr size_t ENTRY_BYTES = sizeof(int64_t) * 2 + sizeof(uint8_t);
+
+	static int64_t GetWriteTime(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		auto time = std::filesystem::last_write_time(path, ec);
+		return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+	}
+
+	void VideoIndex::Build(AVFormatContext* formatContext, int streamIndex, const std::atomic<bool>* cancel)
+	{
+		AVStream* stream = formatContext->streams[streamIndex];
+		mEntries.clear();
+		mEstimated = false;
+		mTimeBaseNum = stream->time_base.num;
+		mTimeBaseDen = stream->time_base.den;
+
+		// Only demux the video stream, nothing is decoded here
+		std::vector<AVDiscard> previousDiscard(formatContext->nb_streams);
+		for (unsigned int i = 0; i < formatContext->nb_streams; i++)
+		{
+			previousDiscard[i] = formatContext->streams[i]->discard;
+			if ((int)i != streamIndex)
+				formatContext->streams[i]->discard = AVDISCARD_ALL;
+		}
+
+		AVPacket* packet = av_packet_alloc();
+		while ((!cancel || !*cancel) && av_read_frame(formatContext, packet) >= 0)
+		{
+			if (packet->stream_index == streamIndex && !(packet->flags & AV_PKT_FLAG_DISCARD))
+			{
+				IndexEntry entry;
+				entry.mPTS = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+				entry.mPos = packet->pos;
+				entry.mKeyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+				if (entry.mPTS != AV_NOPTS_VALUE)
+					mEntries.push_back(entry);
+			}
+			av_packet_unref(packet);
+		}
+		av_packet_free(&packet);
+
+		for (unsigned int i = 0; i < formatContext->nb_streams; i++)
+			formatContext->streams[i]->discard = previousDiscard[i];
+		if (cancel && *cancel)
+			mEntries.clear();
+
+		// Packets arrive in decode order, frames are numbered in presentation order
+		std::stable_sort(mEntries.begin(), mEntries.end(), [](const IndexEntry& a, const IndexEntry& b) { return a.mPTS < b.mPTS; });
+
+		if (stream->start_time != AV_NOPTS_VALUE)
+			mStartPTS = stream->start_time;
+		else
+			mStartPTS = mEntries.empty() ? 0 : mEntries.front().mPTS;
+
+		BuildKeyframeTable();
+
+		av_seek_frame(formatContext, streamIndex, mEntries.empty() ? 0 : mEntries.front().mPTS, AVSEEK_FLAG_BACKWARD);
+	}
+
+	void VideoIndex::Estimate(AVFormatContext* formatContext, int streamIndex)
+	{
+		AVStream* stream = formatContext->streams[streamIndex];
+		mEntries.clear();
+		mTimeBaseNum = stream->time_base.num;
+		mTimeBaseDen = stream->time_base.den;
+		mStartPTS = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+		mEstimated = true;
+
+		double fps = stream->avg_frame_rate.den != 0 ? av_q2d(stream->avg_frame_rate) : 0.0;
+		if (fps <= 0.0 && stream->r_frame_rate.den != 0)
+			fps = av_q2d(stream->r_frame_rate);
+		if (fps <= 0.0)
+			fps = 25.0;
+		double duration = stream->duration != AV_NOPTS_VALUE ? stream->duration * av_q2d(stream->time_base)
+			: formatContext->duration != AV_NOPTS_VALUE ? static_cast<double>(formatContext->duration) / AV_TIME_BASE : 0.0;
+		int64_t count = stream->nb_frames > 0 ? stream->nb_frames : std::llround(duration * fps);
+		if (count <= 0 || mTimeBaseNum <= 0 || mTimeBaseDen <= 0)
+		{
+			BuildKeyframeTable();
+			return;
+		}
+
+		double step = static_cast<double>(mTimeBaseDen) / (mTimeBaseNum * fps);
+		mEntries.resize(static_cast<size_t>(std::min<int64_t>(count, UINT32_MAX)));
+		for (size_t i = 0; i < mEntries.size(); i++)
+		{
+			mEntries[i].mPTS = mStartPTS + std::llround(i * step);
+			mEntries[i].mKeyframe = true;
+		}
+		BuildKeyframeTable();
+	}
+
+	void VideoIndex::BuildKeyframeTable()
+	{
+		mKeyframes.clear();
+		mKeyframeOf.resize(mEntries.size());
+		uint32_t lastKeyframe = 0;
+		for (uint32_t i = 0; i < mEntries.size(); i++)
+		{
+			if (mEntries[i].mKeyframe)
+			{
+				lastKeyframe = i;
+				mKeyframes.push_back(i);
+			}
+			mKeyframeOf[i] = lastKeyframe;
+		}
+	}
+
+	std::filesystem::path VideoIndex::GetSidecarPath(const std::filesystem::path& videoPath)
+	{
+		std::filesystem::path sidecar = videoPath;
+		sidecar += ".frexidx";
+		return sidecar;
+	}
+
+	// Leaves file at the first entry when the sidecar is current for the video
+	static bool ReadHeader(std::ifstream& file, const std::filesystem::path& videoPath, IndexHeader& header)
+	{
+		std::filesystem::path sidecar = VideoIndex::GetSidecarPath(videoPath);
+		file.open(sidecar, std::ios::binary);
+		if (!file)
+			return false;
+
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		std::error_code ec;
+		if (!file || header.mMagic != INDEX_MAGIC || header.mVersion != INDEX_VERSION)
+			return false;
+
+		// The index is stale once the recording has been replaced or appended to
+		if (header.mFileSize != std::filesystem::file_size(videoPath, ec) || header.mWriteTime != GetWriteTime(videoPath))
+			return false;
+
+		// A damaged count must not size the allocation, the caller rebuilds instead
+		uint64_t sidecarSize = std::filesystem::file_size(sidecar, ec);
+		if (ec || sidecarSize < sizeof(header) || header.mCount > (sidecarSize - sizeof(header)) / ENTRY_BYTES)
+		{
+			FRAMEEX_CORE_WARN("Ignoring damaged video index {}", sidecar.string());
+			return false;
+		}
+		return true;
+	}
+
+	bool VideoIndex::LoadSummary(const std::filesystem::path& videoPath, Summary& summary)
+	{
+		std::ifstream file;
+		IndexHeader header{};
+		if (!ReadHeader(file, videoPath, header))
+			return false;
+
+		// Only the PTS of the first and last entries is needed, the rest is never read
+		int64_t firstPTS = 0;
+		int64_t lastPTS = 0;
+		if (header.mCount > 0)
+		{
+			file.read(reinterpret_cast<char*>(&firstPTS), sizeof(firstPTS));
+			file.seekg(sizeof(header) + (header.mCount - 1) * ENTRY_BYTES);
+			file.read(reinterpret_cast<char*>(&lastPTS), sizeof(lastPTS));
+			if (!file)
+				return false;
+		}
+
+		summary = {};
+		summary.mFrameCount = static_cast<uint32_t>(header.mCount);
+		if (header.mCount < 2 || header.mTimeBaseDen == 0)
+			return true;
+		double span = static_cast<double>(lastPTS - firstPTS) * header.mTimeBaseNum / header.mTimeBaseDen;
+		summary.mDuration = span + span / (header.mCount - 1);
+		summary.mFPS = span > 0.0 ? (header.mCount - 1) / span : 0.0;
+		return true;
+	}
+
+	bool VideoIndex::Load(const std::filesystem::path& videoPath)
+	{
+		std::ifstream file;
+		IndexHeader header{};
+		if (!ReadHeader(file, videoPath, header))
+			return false;
+
+		std::vector<IndexEntry> entries(header.mCount);
+		for (auto& entry : entries)
+		{
+			uint8_t keyframe = 0;
+			file.read(reinterpret_cast<char*>(&entry.mPTS), sizeof(entry.mPTS));
+			file.read(reinterpret_cast<char*>(&entry.mPos), sizeof(entry.mPos));
+			file.read(reinterpret_cast<char*>(&keyframe), sizeof(keyframe));
+			entry.mKeyframe = keyframe != 0;
+		}
+		if (!file)
+			return false;
+
+		mEntries = std::move(entries);
+		mEstimated = false;
+		mStartPTS = header.mStartPTS;
+		mTimeBaseNum = header.mTimeBaseNum;
+		mTimeBaseDen = header.mTimeBaseDen;
+		BuildKeyframeTable();
+		return true;
+	}
+
+	bool VideoIndex::Save(const std::filesystem::path& videoPath) const
+	{
+		// Players, exporters and their workers may index the same video at
+		// once, each writes its own file and the last rename wins whole
+		std::filesystem::path sidecar = GetSidecarPath(videoPath);
+		std::filesystem::path temporary = sidecar;
+		temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			FRAMEEX_CORE_WARN("Unable to write video index for {}", videoPath.string());
+			return false;
+		}
+
+		std::error_code ec;
+		IndexHeader header{};
+		header.mMagic = INDEX_MAGIC;
+		header.mVersion = INDEX_VERSION;
+		header.mFileSize = std::filesystem::file_size(videoPath, ec);
+		header.mWriteTime = GetWriteTime(videoPath);
+		header.mStartPTS = mStartPTS;
+		header.mTimeBaseNum = mTimeBaseNum;
+		header.mTimeBaseDen = mTimeBaseDen;
+		header.mCount = mEntries.size();
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& entry : mEntries)
+		{
+			uint8_t keyframe = entry.mKeyframe ? 1 : 0;
+			file.write(reinterpret_cast<const char*>(&entry.mPTS), sizeof(entry.mPTS));
+			file.write(reinterpret_cast<const char*>(&entry.mPos), sizeof(entry.mPos));
+			file.write(reinterpret_cast<const char*>(&keyframe), sizeof(keyframe));
+		}
+		file.close();
+		if (file)
+			std::filesystem::rename(temporary, sidecar, ec);
+		if (!file || ec)
+		{
+			FRAMEEX_CORE_WARN("Unable to write video index for {}", videoPath.string());
+			std::filesystem::remove(temporary, ec);
+			return false;
+		}
+		return true;
+	}
+
+	double VideoIndex::GetTime(uint32_t frameIndex) const
+	{
+		if (mEntries.empty())
+			return 0.0;
+		frameIndex = std::min(frameIndex, GetFrameCount() - 1);
+		return static_cast<double>(mEntries[frameIndex].mPTS - mStartPTS) * mTimeBaseNum / mTimeBaseDen;
+	}
+
+	double VideoIndex::GetDuration() const
+	{
+		if (mEntries.size() < 2)
+			return 0.0;
+		// Count the last frame as lasting one average frame interval
+		double span = GetTime(GetFrameCount() - 1) - GetTime(0);
+		return span + span / (mEntries.size() - 1);
+	}
+
+	double VideoIndex::GetAverageFPS() const
+	{
+		if (mEntries.size() < 2)
+			return 0.0;
+		double span = GetTime(GetFrameCount() - 1) - GetTime(0);
+		return span > 0.0 ? (mEntries.size() - 1) / span : 0.0;
+	}
+
+	uint32_t VideoIndex::FindFrameAtTime(double seconds) const
+	{
+		int64_t pts = mStartPTS + static_cast<int64_t>(std::floor(seconds * mTimeBaseDen / mTimeBaseNum + 1e-6));
+		return FindFrame(pts);
+	}
+
+	uint32_t VideoIndex::FindFrame(int64_t pts) const
+	{
+		auto it = std::upper_bound(mEntries.begin(), mEntries.end(), pts, [](int64_t value, const IndexEntry& entry) { return value < entry.mPTS; });
+		if (it == mEntries.begin())
+			return 0;
+		return static_cast<uint32_t>(std::distance(mEntries.begin(), it) - 1);
+	}
+}
@@ -0,0 +1,377 @@
+/******************************************************************************
+/*!
+\file       VideoScanner.cpp
+\author     Chua Zheng Yang
+\par    	email: zhengyang.chua\@hendrickscorp.com
+\date       October 17, 2026
+\brief      Defines the Video Scanner class, which demuxes or decodes whole
+			videos on worker threads and reports timestamp faults and black,
+			frozen and undecodable time ranges.
+
+ /******************************************************************************/
+#include <FrameExtractorPCH.hpp>
+#include <Core/LoggerManager.hpp>
+#include <Graphics/VideoScanner.hpp>
+#include <Graphics/ActivityIndex.hpp>
+#include <Graphics/DecodeSession.hpp>
+#include <Graphics/FramePool.hpp>
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+namespace FrameExtractor
+{
+	// Decoding at a quarter of the size is plenty for a 64x36 grid
+	static constexpr int MAX_LOWRES = 2;
+
+	namespace
+	{
+		// A run of frames sharing one condition, closed into a ScanRange
+		struct IssueRun
+		{
+			bool mOpen = false;
+			double mStart = 0.0;
+			double mLast = 0.0;
+
+			void Extend(double start, double time)
+			{
+				if (!mOpen)
+				{
+					mOpen = true;
+					mStart = start;
+				}
+				mLast = time;
+			}
+
+			void Close(ScanIssue issue, double minimum, double frameDuration, std::vector<ScanRange>& ranges)
+			{
+				if (mOpen && mLast + frameDuration - mStart >= minimum)
+					ranges.push_back({ issue, mStart, mLast + frameDuration });
+				mOpen = false;
+			}
+		};
+	}
+
+	VideoScanner::VideoScanner(unsigned workerCount)
+	{
+		if (workerCount == 0)
+		{
+			// One decoder per core, leaving one for the UI
+			workerCount = std::clamp(std::thread::hardware_concurrency() - 1, 1u, 8u);
+		}
+		for (unsigned i = 0; i < workerCount; i++)
+			mWorkers.emplace_back(&VideoScanner::WorkerLoop, this);
+	}
+
+	VideoScanner::~VideoScanner()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+			mQueue.clear();
+		}
+		mCondition.notify_all();
+		for (auto& worker : mWorkers)
+			worker.join();
+	}
+
+	void VideoScanner::Scan(const std::vector<std::filesystem::path>& paths, const ScanOptions& options)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mGeneration++;
+			mOptions = options;
+			mQueue.assign(paths.begin(), paths.end());
+			mReports.clear();
+			mDone = 0;
+			mTotal = paths.size();
+			mScannedMilliseconds = 0;
+			mScannedBytes = 0;
+			mStarted = std::chrono::steady_clock::now();
+			mFinished = mStarted;
+		}
+		mCondition.notify_all();
+	}
+
+	void VideoScanner::Cancel()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mDone == mTotal)
+			return;
+		mGeneration++;
+		mQueue.clear();
+		mTotal = mDone;
+		mFinished = std::chrono::steady_clock::now();
+	}
+
+	ScanProgress VideoScanner::GetProgress() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		ScanProgress progress;
+		progress.mDone = mDone;
+		progress.mTotal = mTotal;
+		progress.mScannedSeconds = mScannedMilliseconds / 1000.0;
+		progress.mScannedBytes = mScannedBytes;
+		progress.mDepth = mOptions.mDepth;
+		auto end = progress.IsRunning() ? std::chrono::steady_clock::now() : mFinished;
+		progress.mElapsedSeconds = std::chrono::duration<double>(end - mStarted).count();
+		progress.mWorkers = static_cast<unsigned>(mWorkers.size());
+		return progress;
+	}
+
+	std::vector<ScanReport> VideoScanner::GetReports() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mReports;
+	}
+
+	const char* VideoScanner::GetIssueName(ScanIssue issue)
+	{
+		switch (issue)
+		{
+		case ScanIssue::Black:
+			return "Black";
+		case ScanIssue::Frozen:
+			return "Frozen";
+		case ScanIssue::DecodeError:
+			return "Decode Error";
+		case ScanIssue::TimestampGap:
+			return "Timestamp Gap";
+		case ScanIssue::NonMonotonic:
+			return "Non-monotonic Timestamps";
+		case ScanIssue::Truncated:
+			return "Truncated";
+		}
+		return "Unknown";
+	}
+
+	void VideoScanner::WorkerLoop()
+	{
+		while (true)
+		{
+			std::filesystem::path path;
+			uint64_t generation = 0;
+			ScanOptions options;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this] { return mStop || !mQueue.empty(); });
+				if (mStop)
+					return;
+				path = std::move(mQueue.front());
+				mQueue.pop_front();
+				generation = mGeneration;
+				options = mOptions;
+			}
+
+			ScanReport report = ScanVideo(path, generation, options);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			// Reports of a cancelled or replaced scan are dropped
+			if (generation != mGeneration)
+				continue;
+			mReports.push_back(std::move(report));
+			if (++mDone == mTotal)
+				mFinished = std::chrono::steady_clock::now();
+		}
+	}
+
+
+	ScanReport VideoScanner::ScanVideo(const std::filesystem::path& path, uint64_t generation, const ScanOptions& options)
+	{
+		ScanReport report;
+		report.mPath = path;
+		bool decode = options.mDepth == ScanDepth::Full;
+
+		// Probing decodes a few frames, packet scans rely on the container header
+		DecodeSession session;
+		if (!session.OpenInput(path, decode))
+		{
+			// A truncated moov atom ends up here
+			FRAMEEX_CORE_WARN("VideoScanner: unable to open {}: {}", path.string(), session.GetError());
+			report.mOpenFailed = true;
+			report.mError = session.GetError();
+			return report;
+		}
+		// Parallelism comes from scanning several files at once, like thumbnails
+		if (decode && !session.OpenDecoder(DecodePolicy::For(DecodeUseCase::Thumbnail), [](AVCodecContext* codecContext) {
+				codecContext->lowres = std::min<int>(codecContext->codec->max_lowres, MAX_LOWRES);
+				codecContext->flags2 |= AV_CODEC_FLAG2_FAST;
+				// Frames nothing else refers to add little, skipping them halves the work
+				codecContext->skip_frame = AVDISCARD_NONREF;
+			}))
+		{
+			FRAMEEX_CORE_WARN("VideoScanner: unable to open decoder for {}", path.string());
+			report.mOpenFailed = true;
+			report.mError = session.GetError();
+			return report;
+		}
+		AVFormatContext* formatContext = session.GetFormatContext();
+		AVCodecContext* codecContext = session.GetCodecContext();
+		AVStream* stream = session.GetStream();
+		AVPacket* packet = session.GetPacket();
+
+		double timeBase = av_q2d(stream->time_base);
+		if (stream->duration != AV_NOPTS_VALUE)
+			report.mDuration = stream->duration * timeBase;
+		else if (formatContext->duration != AV_NOPTS_VALUE)
+			report.mDuration = formatContext->duration / static_cast<double>(AV_TIME_BASE);
+		double frameDuration = session.GetFrameRate() > 0.0 ? 1.0 / session.GetFrameRate() : 0.04;
+
+		AVFrame* frame = decode ? av_frame_alloc() : nullptr;
+		FramePool& pool = FramePool::GetInstance();
+		SwsContext* scaler = nullptr;
+		int scalerWidth = 0, scalerHeight = 0, scalerFormat = -1;
+		std::vector<uint8_t> grid(ActivityIndex::GRID_WIDTH * ActivityIndex::GRID_HEIGHT);
+		size_t previousHash = 0;
+		bool hasPrevious = false;
+		double previousTime = 0.0;
+		double lastTime = 0.0; // Latest presentation time seen, errors without a timestamp land here
+		int64_t lastDTS = AV_NOPTS_VALUE; // Highest decode timestamp so far
+		double packetsEnd = 0.0; // End of the last packet, compared with the duration
+		IssueRun black, frozen, errors, disorder;
+
+		auto toSeconds = [&session](int64_t pts) {
+			return session.GetTime(pts);
+		};
+		auto advance = [&](double time) {
+			if (time > lastTime)
+			{
+				mScannedMilliseconds += static_cast<uint64_t>((time - lastTime) * 1000.0);
+				lastTime = time;
+			}
+		};
+		auto record = [&](IssueRun& run, ScanIssue issue, double time) {
+			if (run.mOpen && time - run.mLast > ERROR_MERGE_SECONDS)
+				run.Close(issue, 0.0, frameDuration, report.mRanges);
+			run.Extend(time, std::max(time, run.mOpen ? run.mLast : time));
+		};
+		// Decode timestamps have to rise in steps of about one frame. Only the
+		// demuxer is involved, so these checks cost no decoding.
+		auto checkPacket = [&]() {
+			mScannedBytes += packet->size;
+			if (packet->flags & AV_PKT_FLAG_CORRUPT)
+				record(errors, ScanIssue::DecodeError, packet->pts != AV_NOPTS_VALUE ? toSeconds(packet->pts) : lastTime);
+			int64_t dts = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+			if (dts == AV_NOPTS_VALUE)
+				return;
+			double time = toSeconds(dts);
+			if (lastDTS != AV_NOPTS_VALUE)
+			{
+				if (dts <= lastDTS)
+					record(disorder, ScanIssue::NonMonotonic, time);
+				else if ((dts - lastDTS) * timeBase > options.mGapSeconds)
+					report.mRanges.push_back({ ScanIssue::TimestampGap, toSeconds(lastDTS), time });
+			}
+			// A jump backwards is reported once, not again as a gap on the way back up
+			lastDTS = lastDTS == AV_NOPTS_VALUE ? dts : std::max(lastDTS, dts);
+			double duration = packet->duration > 0 ? packet->duration * timeBase : frameDuration;
+			packetsEnd = std::max(packetsEnd, time + duration);
+			if (!decode)
+				advance(time);
+		};
+
+		bool draining = false;
+		while (!IsCancelled(generation))
+		{
+			if (!draining)
+			{
+				int ret = session.ReadPacket();
+				if (ret < 0)
+				{
+					// Anything but a clean end of file means the rest could not be read
+					if (ret != AVERROR_EOF && report.mDuration > packetsEnd)
+						report.mRanges.push_back({ ScanIssue::Truncated, packetsEnd, report.mDuration });
+					else if (report.mDuration - packetsEnd >= std::max(MIN_TRUNCATED_SECONDS, options.mGapSeconds))
+						report.mRanges.push_back({ ScanIssue::Truncated, packetsEnd, report.mDuration });
+					if (!decode)
+						break;
+					avcodec_send_packet(codecContext, nullptr);
+					draining = true;
+				}
+				else
+				{
+					checkPacket();
+					if (decode)
+					{
+						ret = avcodec_send_packet(codecContext, packet);
+						if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+							record(errors, ScanIssue::DecodeError, packet->pts != AV_NOPTS_VALUE ? toSeconds(packet->pts) : lastTime);
+					}
+					av_packet_unref(packet);
+				}
+			}
+			if (!decode)
+				continue;
+
+			int ret = 0;
+			while (!IsCancelled(generation) && (ret = avcodec_receive_frame(codecContext, frame)) == 0)
+			{
+				int64_t pts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+				double time = pts != AV_NOPTS_VALUE ? toSeconds(pts) : lastTime + frameDuration;
+				advance(time);
+				if (frame->decode_error_flags || (frame->flags & AV_FRAME_FLAG_CORRUPT))
+					record(errors, ScanIssue::DecodeError, time);
+
+				if (!scaler || frame->width != scalerWidth || frame->height != scalerHeight || frame->format != scalerFormat)
+				{
+					pool.ReleaseScaler(scaler);
+					scaler = pool.AcquireScaler(frame->width, frame->height, frame->format, ActivityIndex::GRID_WIDTH, ActivityIndex::GRID_HEIGHT, AV_PIX_FMT_GRAY8, SWS_AREA);
+					scalerWidth = frame->width;
+					scalerHeight = frame->height;
+					scalerFormat = frame->format;
+				}
+				if (!scaler)
+				{
+					av_frame_unref(frame);
+					continue;
+				}
+				uint8_t* dstData[4] = { grid.data() };
+				int dstLinesize[4] = { static_cast<int>(ActivityIndex::GRID_WIDTH) };
+				sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, dstData, dstLinesize);
+				av_frame_unref(frame);
+
+				uint32_t sum = 0;
+				uint8_t peak = 0;
+				for (uint8_t value : grid)
+				{
+					sum += value;
+					peak = std::max(peak, value);
+				}
+				bool isBlack = sum <= static_cast<uint32_t>(BLACK_MEAN) * grid.size() && peak <= BLACK_PEAK;
+				if (isBlack)
+					black.Extend(time, time);
+				else
+					black.Close(ScanIssue::Black, MIN_BLACK_SECONDS, frameDuration, report.mRanges);
+
+				// Black stretches repeat exactly too, they are only reported as black
+				size_t hash = std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(grid.data()), grid.size()));
+				if (hasPrevious && hash == previousHash && !isBlack)
+					frozen.Extend(previousTime, time);
+				else
+					frozen.Close(ScanIssue::Frozen, MIN_FROZEN_SECONDS, frameDuration, report.mRanges);
+				previousHash = hash;
+				previousTime = time;
+				hasPrevious = true;
+			}
+			if (ret != 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+				record(errors, ScanIssue::DecodeError, lastTime);
+			if (ret == AVERROR_EOF || (draining && ret != 0))
+				break;
+		}
+
+		black.Close(ScanIssue::Black, MIN_BLACK_SECONDS, frameDuration, report.mRanges);
+		frozen.Close(ScanIssue::Frozen, MIN_FROZEN_SECONDS, frameDuration, report.mRanges);
+		errors.Close(ScanIssue::DecodeError, 0.0, frameDuration, report.mRanges);
+		disorder.Close(ScanIssue::NonMonotonic, 0.0, frameDuration, report.mRanges);
+		std::sort(report.mRanges.begin(), report.mRanges.end(), [](const ScanRange& a, const ScanRange& b) { return a.mStart < b.mStart; });
+		if (report.mDuration <= 0.0)
+			report.mDuration = std::max(lastTime + frameDuration, packetsEnd);
+
+		pool.ReleaseScaler(scaler);
+		av_frame_free(&frame);
+		return report;
+	}
+}